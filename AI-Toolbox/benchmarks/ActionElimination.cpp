@@ -0,0 +1,46 @@
+#include <AIToolbox/MDP/Algorithms/ValueIteration.hpp>
+
+#include "RandomModel.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+// This benchmark compares ValueIteration with and without action
+// elimination, on random sparse models with many actions, where each
+// action leads to a few nearby states with a random cost.
+//
+// Usage: ActionElimination [S] [epsilon]
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char * argv[]) {
+    using namespace AIToolbox;
+
+    const size_t S = argc > 1 ? std::stoul(argv[1]) : 20000;
+    const double epsilon = argc > 2 ? std::stod(argv[2]) : 0.0001;
+
+    for ( size_t A : { 4, 10, 40 } ) {
+        RandomModel model(S, A, 0.99);
+        std::cout << "S = " << S << ", A = " << A << "\n";
+
+        for ( bool elimination : { false, true } ) {
+            MDP::ValueIteration<RandomModel> vi(1000000, epsilon);
+            vi.setActionElimination(elimination);
+
+            auto start = Clock::now();
+            auto solution = vi(model);
+            const double time = seconds(start);
+
+            const auto & values = std::get<MDP::VALUES>(std::get<1>(solution));
+            std::cout << "    " << std::left << std::setw(14) << (elimination ? "elimination" : "plain") << std::right
+                      << std::fixed << std::setprecision(3) << std::setw(8) << time << " s   "
+                      << std::setw(7) << vi.getEliminatedActions() << " of " << S * A << " pairs eliminated"
+                      << "   [" << values.sum() << "]\n";
+        }
+    }
+}
@@ -0,0 +1,113 @@
+#include <AIToolbox/MDP/Model.hpp>
+#include <AIToolbox/MDP/SparseModel.hpp>
+#include <AIToolbox/POMDP/Model.hpp>
+#include <AIToolbox/POMDP/SparseModel.hpp>
+
+#include "CassandraPOMDP.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+// This benchmark compares the throughput of sampleSR and sampleSOR when
+// using linear scans of the model tables against alias tables, together
+// with the throughput of batched sampleSR calls.
+//
+// Usage: AliasSampling file.POMDP [samples]
+//
+// The dense models are only benchmarked when they fit comfortably in
+// memory; the sparse ones are always benchmarked.
+
+using Clock = std::chrono::steady_clock;
+using Pairs = std::vector<std::pair<size_t, size_t>>;
+
+double seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+template <typename M>
+void benchmark(const std::string & name, M & model, const Pairs & pairs, size_t samples) {
+    for ( bool alias : { false, true } ) {
+        auto start = Clock::now();
+        model.setAliasSampling(alias);
+        const double setup = seconds(start);
+
+        // Accumulating the results prevents the compiler from removing the loops.
+        size_t check = 0;
+
+        start = Clock::now();
+        for ( size_t i = 0; i < samples; ++i ) {
+            const auto & p = pairs[i % pairs.size()];
+            check += std::get<0>(model.sampleSR(p.first, p.second));
+        }
+        const double sr = seconds(start);
+
+        start = Clock::now();
+        for ( size_t i = 0; i < samples; ++i ) {
+            const auto & p = pairs[i % pairs.size()];
+            check += std::get<1>(model.sampleSOR(p.first, p.second));
+        }
+        const double sor = seconds(start);
+
+        // Batches advance the same pairs, a block at a time.
+        std::vector<size_t> states, actions, next;
+        std::vector<double> rewards;
+        for ( const auto & p : pairs ) {
+            states.push_back(p.first);
+            actions.push_back(p.second);
+        }
+        AIToolbox::RandomEngine engine(0);
+        start = Clock::now();
+        for ( size_t i = 0; i < samples; i += pairs.size() ) {
+            model.sampleSRBatch(states, actions, next, rewards, engine);
+            check += next[i % next.size()];
+        }
+        const double batch = seconds(start);
+        const size_t batchSamples = (samples + pairs.size() - 1) / pairs.size() * pairs.size();
+
+        std::cout << std::left << std::setw(14) << name << std::setw(7) << (alias ? "alias" : "scan")
+                  << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << samples / sr  / 1e6 << " Msamples/s (SR)"
+                  << std::setw(12) << samples / sor / 1e6 << " Msamples/s (SOR)"
+                  << std::setw(12) << batchSamples / batch / 1e6 << " Msamples/s (SR batch)"
+                  << std::setw(10) << setup * 1e3 << " ms setup"
+                  << "   [" << check << "]\n";
+    }
+}
+
+int main(int argc, char * argv[]) {
+    using namespace AIToolbox;
+
+    if ( argc < 2 ) {
+        std::cerr << "Usage: " << argv[0] << " file.POMDP [samples]\n";
+        return 1;
+    }
+    const size_t samples = argc > 2 ? std::stoul(argv[2]) : 10000000;
+
+    auto start = Clock::now();
+    CassandraPOMDP file(argv[1]);
+    const size_t S = file.getS(), A = file.getA(), O = file.getO();
+    std::cout << argv[1] << ": S = " << S << ", A = " << A << ", O = " << O
+              << " (parsed in " << seconds(start) << " s)\n";
+
+    // We sample from a fixed sequence of state-action pairs, so that all
+    // models do the same work.
+    std::mt19937 rand(0);
+    std::uniform_int_distribution<size_t> sDist(0, S-1), aDist(0, A-1);
+    Pairs pairs(1 << 16);
+    for ( auto & p : pairs ) p = std::make_pair(sDist(rand), aDist(rand));
+
+    {
+        start = Clock::now();
+        POMDP::SparseModel<MDP::SparseModel> model(O, file.getObservationView(), S, A, file.getTransitionView(), file.getRewardView(), file.getDiscount());
+        std::cout << "Sparse model built in " << seconds(start) << " s\n";
+        benchmark("sparse", model, pairs, samples);
+    }
+    if ( S * S * A <= 10000000 ) {
+        POMDP::Model<MDP::Model> model(O, file.getObservationView(), S, A, file.getTransitionView(), file.getRewardView(), file.getDiscount());
+        benchmark("dense", model, pairs, samples);
+    }
+
+    return 0;
+}
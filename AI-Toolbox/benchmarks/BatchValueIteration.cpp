@@ -0,0 +1,70 @@
+#include <AIToolbox/MDP/Algorithms/ValueIteration.hpp>
+#include <AIToolbox/MDP/Algorithms/BatchValueIteration.hpp>
+
+#include "GridModel.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+// This benchmark compares solving K variants of the same grid world, which
+// differ in rewards and discount, one at a time with ValueIteration and
+// all together with BatchValueIteration.
+//
+// Usage: BatchValueIteration [sweeps] [side]
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char * argv[]) {
+    using namespace AIToolbox;
+
+    const unsigned sweeps = argc > 1 ? std::stoul(argv[1]) : 100;
+    const size_t side = argc > 2 ? std::stoul(argv[2]) : 200;
+
+    GridModel model(side);
+    const auto ir = MDP::computeImmediateRewards(model);
+    std::cout << side << "x" << side << " grid (S = " << model.getS() << "), " << sweeps << " sweeps\n";
+
+    for ( size_t K : { 1, 4, 16, 64 } ) {
+        std::vector<MDP::QFunction> rewards;
+        std::vector<double> discounts;
+        for ( size_t k = 0; k < K; ++k ) {
+            rewards.push_back(ir * (k + 1.0));
+            discounts.push_back(0.9 + 0.09 * k / K);
+        }
+
+        std::vector<GridModel> variants;
+        for ( size_t k = 0; k < K; ++k )
+            variants.emplace_back(side, discounts[k]);
+
+        // An epsilon of zero forces all sweeps to be performed. Rewards
+        // are scaled after solving, since values are linear in them.
+        auto start = Clock::now();
+        double check = 0.0;
+        for ( size_t k = 0; k < K; ++k ) {
+            const auto & variant = variants[k];
+            MDP::ValueIteration<GridModel> vi(sweeps, 0.0);
+            check += std::get<MDP::VALUES>(std::get<1>(vi(variant))).sum() * (k + 1.0);
+        }
+        const double sequential = seconds(start);
+
+        start = Clock::now();
+        MDP::BatchValueIteration<GridModel> batch(sweeps, 0.0);
+        auto solutions = batch(model, rewards, discounts);
+        const double batched = seconds(start);
+
+        double batchCheck = 0.0;
+        for ( auto & s : solutions ) batchCheck += std::get<MDP::VALUES>(std::get<1>(s)).sum();
+
+        std::cout << "K = " << std::setw(3) << K << std::fixed << std::setprecision(3)
+                  << std::setw(10) << sequential << " s sequential" << std::setw(10) << batched << " s batched"
+                  << std::setw(8) << std::setprecision(2) << sequential / batched << "x"
+                  << std::setprecision(3) << "   [" << check << " " << batchCheck << "]\n";
+    }
+
+    return 0;
+}
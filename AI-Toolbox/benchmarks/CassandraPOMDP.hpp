@@ -0,0 +1,329 @@
+#ifndef AI_TOOLBOX_BENCHMARKS_CASSANDRA_POMDP_HEADER_FILE
+#define AI_TOOLBOX_BENCHMARKS_CASSANDRA_POMDP_HEADER_FILE
+
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+/**
+ * @brief This class reads a POMDP written in Cassandra's .POMDP format.
+ *
+ * This is a minimal reader, written only to load the standard benchmark
+ * problems. It supports numbered and named states, actions and
+ * observations, wildcards, and the single-entry, row and matrix forms of the
+ * T: and O: statements (including "uniform" and "identity"). R: statements
+ * are supported in their single-entry form; the observation part of a
+ * reward is ignored, and more specific statements take precedence over
+ * wildcarded ones regardless of their order in the file. All
+ * distributions are renormalized after parsing.
+ *
+ * The data is stored sparsely and exposed through table views which can
+ * be fed directly to the constructors of the models in the library.
+ */
+class CassandraPOMDP {
+    public:
+        /**
+         * @brief This constructor parses the specified file.
+         *
+         * Throws std::runtime_error if the file cannot be read or parsed.
+         *
+         * @param filename The path of the file to parse.
+         */
+        CassandraPOMDP(const std::string & filename);
+
+        size_t getS() const { return S; }
+        size_t getA() const { return A; }
+        size_t getO() const { return O; }
+        double getDiscount() const { return discount_; }
+
+        double getTransitionProbability(size_t s, size_t a, size_t s1) const {
+            return lookup(transitions_[a][s], s1);
+        }
+
+        double getObservationProbability(size_t s1, size_t a, size_t o) const {
+            return lookup(observations_[a][s1], o);
+        }
+
+        double getExpectedReward(size_t s, size_t a, size_t s1) const {
+            // Rewards are only meaningful for possible transitions, and
+            // skipping the rest keeps the sparse models sparse.
+            if ( getTransitionProbability(s, a, s1) == 0.0 ) return 0.0;
+
+            const auto & r = rewards_[a];
+            auto it = r.find(rewardKey(s, s1));
+            if ( it == r.end() ) it = r.find(rewardKey(ANY, s1));
+            if ( it == r.end() ) it = r.find(rewardKey(s, ANY));
+            if ( it == r.end() ) it = r.find(rewardKey(ANY, ANY));
+            return it == r.end() ? 0.0 : it->second;
+        }
+
+        /**
+         * @brief This class exposes a member function as a three dimensional table.
+         *
+         * The view supports t[i][j][k] access, which is what the
+         * constructors of the models in the library expect.
+         */
+        template <double (CassandraPOMDP::*F)(size_t, size_t, size_t) const>
+        class View {
+            public:
+                struct Row {
+                    double operator[](size_t k) const { return (m->*F)(i, j, k); }
+                    const CassandraPOMDP * m; size_t i, j;
+                };
+                struct Matrix {
+                    Row operator[](size_t j) const { return Row{m, i, j}; }
+                    const CassandraPOMDP * m; size_t i;
+                };
+                View(const CassandraPOMDP & m) : m_(&m) {}
+                Matrix operator[](size_t i) const { return Matrix{m_, i}; }
+
+            private:
+                const CassandraPOMDP * m_;
+        };
+
+        // Transitions are read as t[s][a][s1].
+        using TransitionView  = View<&CassandraPOMDP::getTransitionProbability>;
+        // Rewards are read as r[s][a][s1].
+        using RewardView      = View<&CassandraPOMDP::getExpectedReward>;
+        // Observations are read as o[s1][a][o].
+        using ObservationView = View<&CassandraPOMDP::getObservationProbability>;
+
+        TransitionView  getTransitionView()  const { return TransitionView(*this); }
+        RewardView      getRewardView()      const { return RewardView(*this); }
+        ObservationView getObservationView() const { return ObservationView(*this); }
+
+    private:
+        using Row = std::map<size_t, double>;
+        enum : size_t { ANY = static_cast<size_t>(-1) };
+
+        static double lookup(const Row & row, size_t i) {
+            auto it = row.find(i);
+            return it == row.end() ? 0.0 : it->second;
+        }
+        static std::pair<size_t, size_t> rewardKey(size_t s, size_t s1) { return std::make_pair(s, s1); }
+
+        struct PairHash {
+            size_t operator()(const std::pair<size_t, size_t> & p) const { return p.first * 31 + p.second; }
+        };
+
+        // Tokenizer
+        bool isKeyword(size_t i) const;
+        const std::string & next();
+        const std::string & peek() const;
+        bool atColon() const;
+        void expectColon();
+        double number();
+
+        // Names
+        size_t readCount(std::vector<std::string> & names);
+        std::vector<size_t> indeces(const std::string & token, const std::vector<std::string> & names, size_t size) const;
+
+        // Statements
+        void readStochastic(std::vector<std::vector<Row>> & table, size_t rows, size_t cols,
+                            const std::vector<std::string> & rowNames, const std::vector<std::string> & colNames);
+        void readReward();
+
+        size_t S, A, O;
+        double discount_;
+        std::vector<std::string> stateNames_, actionNames_, observationNames_;
+
+        std::vector<std::vector<Row>> transitions_, observations_;
+        std::vector<std::unordered_map<std::pair<size_t, size_t>, double, PairHash>> rewards_;
+
+        std::vector<std::string> tokens_;
+        size_t pos_;
+};
+
+inline CassandraPOMDP::CassandraPOMDP(const std::string & filename) : S(0), A(0), O(0), discount_(1.0), pos_(0) {
+    std::ifstream file(filename);
+    if ( !file ) throw std::runtime_error("Could not open file " + filename);
+
+    // Tokenize the file, stripping comments and separating colons.
+    std::string line;
+    while ( std::getline(file, line) ) {
+        line = line.substr(0, line.find('#'));
+        std::string spaced;
+        for ( auto c : line ) {
+            if ( c == ':' ) spaced += " : ";
+            else spaced += c;
+        }
+        std::istringstream ss(spaced);
+        std::string token;
+        while ( ss >> token ) tokens_.push_back(token);
+    }
+
+    while ( pos_ < tokens_.size() ) {
+        if ( !isKeyword(pos_) ) throw std::runtime_error("Unexpected token " + tokens_[pos_] + " in " + filename);
+        const std::string keyword = next();
+        expectColon();
+
+        if ( keyword == "discount" ) discount_ = number();
+        else if ( keyword == "values" ) next();
+        else if ( keyword == "states" ) S = readCount(stateNames_);
+        else if ( keyword == "actions" ) A = readCount(actionNames_);
+        else if ( keyword == "observations" ) O = readCount(observationNames_);
+        else if ( keyword == "start" ) {
+            while ( pos_ < tokens_.size() && !isKeyword(pos_) ) next();
+        }
+        else {
+            if ( transitions_.empty() ) {
+                if ( !S || !A || !O ) throw std::runtime_error("Model sizes must precede the model data in " + filename);
+                transitions_.resize(A, std::vector<Row>(S));
+                observations_.resize(A, std::vector<Row>(S));
+                rewards_.resize(A);
+            }
+            if ( keyword == "T" ) readStochastic(transitions_, S, S, stateNames_, stateNames_);
+            else if ( keyword == "O" ) readStochastic(observations_, S, O, stateNames_, observationNames_);
+            else readReward();
+        }
+    }
+
+    // Files are written with few decimals, so we renormalize all
+    // distributions to pass the checks of the models.
+    for ( auto table : { &transitions_, &observations_ } )
+        for ( auto & rows : *table )
+            for ( auto & row : rows ) {
+                double sum = 0.0;
+                for ( auto & e : row ) sum += e.second;
+                for ( auto & e : row ) e.second /= sum;
+            }
+}
+
+inline bool CassandraPOMDP::isKeyword(size_t i) const {
+    static const char * keywords[] = { "discount", "values", "states", "actions", "observations", "start", "T", "O", "R" };
+    if ( i + 1 >= tokens_.size() || tokens_[i+1] != ":" ) return false;
+    for ( auto k : keywords )
+        if ( tokens_[i] == k ) return true;
+    return false;
+}
+
+inline const std::string & CassandraPOMDP::next() {
+    if ( pos_ >= tokens_.size() ) throw std::runtime_error("Unexpected end of file");
+    return tokens_[pos_++];
+}
+
+inline const std::string & CassandraPOMDP::peek() const {
+    static const std::string empty;
+    return pos_ < tokens_.size() ? tokens_[pos_] : empty;
+}
+
+inline bool CassandraPOMDP::atColon() const { return peek() == ":"; }
+
+inline void CassandraPOMDP::expectColon() {
+    if ( next() != ":" ) throw std::runtime_error("Expected ':' before " + peek());
+}
+
+inline double CassandraPOMDP::number() {
+    const std::string & token = next();
+    char * end;
+    double value = std::strtod(token.c_str(), &end);
+    if ( *end != '\0' ) throw std::runtime_error("Expected a number, got " + token);
+    return value;
+}
+
+inline size_t CassandraPOMDP::readCount(std::vector<std::string> & names) {
+    names.clear();
+    while ( pos_ < tokens_.size() && !isKeyword(pos_) ) names.push_back(next());
+    if ( names.size() == 1 && names[0].find_first_not_of("0123456789") == std::string::npos ) {
+        size_t n = std::stoul(names[0]);
+        names.clear();
+        return n;
+    }
+    return names.size();
+}
+
+inline std::vector<size_t> CassandraPOMDP::indeces(const std::string & token, const std::vector<std::string> & names, size_t size) const {
+    std::vector<size_t> retval;
+    if ( token == "*" ) {
+        for ( size_t i = 0; i < size; ++i ) retval.push_back(i);
+        return retval;
+    }
+    for ( size_t i = 0; i < names.size(); ++i )
+        if ( names[i] == token ) return { i };
+
+    size_t i = std::stoul(token);
+    if ( i >= size ) throw std::runtime_error("Index out of range: " + token);
+    return { i };
+}
+
+inline void CassandraPOMDP::readStochastic(std::vector<std::vector<Row>> & table, size_t rows, size_t cols,
+                                           const std::vector<std::string> & rowNames, const std::vector<std::string> & colNames)
+{
+    const auto actions = indeces(next(), actionNames_, A);
+
+    auto setRow = [&](size_t r, const std::vector<double> & values) {
+        for ( auto a : actions ) {
+            auto & row = table[a][r];
+            row.clear();
+            for ( size_t c = 0; c < cols; ++c )
+                if ( values[c] != 0.0 ) row[c] = values[c];
+        }
+    };
+    auto readRow = [&]() {
+        std::vector<double> values(cols, 1.0 / cols);
+        if ( peek() == "uniform" ) next();
+        else for ( auto & v : values ) v = number();
+        return values;
+    };
+
+    if ( !atColon() ) {
+        // Full matrix for the action(s).
+        if ( peek() == "identity" ) {
+            next();
+            for ( size_t r = 0; r < rows; ++r ) {
+                std::vector<double> values(cols, 0.0);
+                values[r] = 1.0;
+                setRow(r, values);
+            }
+        } else if ( peek() == "uniform" ) {
+            next();
+            for ( size_t r = 0; r < rows; ++r ) setRow(r, std::vector<double>(cols, 1.0 / cols));
+        } else {
+            for ( size_t r = 0; r < rows; ++r ) setRow(r, readRow());
+        }
+        return;
+    }
+    expectColon();
+    const auto starts = indeces(next(), rowNames, rows);
+
+    if ( !atColon() ) {
+        // Single row for the action(s) and start(s).
+        const auto values = readRow();
+        for ( auto r : starts ) setRow(r, values);
+        return;
+    }
+    expectColon();
+    const auto ends = indeces(next(), colNames, cols);
+    const double p = number();
+    for ( auto a : actions )
+        for ( auto r : starts )
+            for ( auto c : ends ) {
+                if ( p != 0.0 ) table[a][r][c] = p;
+                else table[a][r].erase(c);
+            }
+}
+
+inline void CassandraPOMDP::readReward() {
+    const auto actions = indeces(next(), actionNames_, A);
+    expectColon();
+    const std::string start = next();
+    expectColon();
+    const std::string end = next();
+    expectColon();
+    next(); // Observation, ignored.
+    const double r = number();
+
+    for ( auto a : actions ) {
+        for ( auto s : start == "*" ? std::vector<size_t>{ANY} : indeces(start, stateNames_, S) )
+            for ( auto s1 : end == "*" ? std::vector<size_t>{ANY} : indeces(end, stateNames_, S) )
+                rewards_[a][rewardKey(s, s1)] = r;
+    }
+}
+
+#endif
@@ -0,0 +1,59 @@
+#include <AIToolbox/MDP/Algorithms/ValueIteration.hpp>
+#include <AIToolbox/MDP/Algorithms/GaussSeidelValueIteration.hpp>
+
+#include "GridModel.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+// This benchmark compares the time needed by ValueIteration and by
+// GaussSeidelValueIteration, with all its state orderings, to converge on
+// grid worlds of increasing size.
+//
+// Usage: GaussSeidel [epsilon]
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+template <typename Solver>
+void benchmark(const std::string & name, Solver & solver, const GridModel & model) {
+    auto start = Clock::now();
+    auto solution = solver(model);
+    const double time = seconds(start);
+
+    const auto & values = std::get<AIToolbox::MDP::VALUES>(std::get<1>(solution));
+    std::cout << "    " << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(10) << time << " s" << (std::get<0>(solution) ? "" : " (not converged)")
+              << "   [" << values.sum() << "]\n";
+}
+
+int main(int argc, char * argv[]) {
+    using namespace AIToolbox;
+
+    const double epsilon = argc > 1 ? std::stod(argv[1]) : 0.001;
+    const unsigned horizon = 100000;
+
+    for ( size_t side : { 25, 50, 100 } ) {
+        GridModel model(side);
+        std::cout << side << "x" << side << " grid (S = " << model.getS() << ")\n";
+
+        MDP::ValueIteration<GridModel> vi(horizon, epsilon);
+        benchmark("ValueIteration", vi, model);
+
+        const std::pair<MDP::StateOrdering, const char *> orderings[] = {
+            { MDP::NATURAL, "GS natural" }, { MDP::REVERSE, "GS reverse" },
+            { MDP::REVERSE_TOPOLOGICAL, "GS reverse topological" }, { MDP::RESIDUAL, "GS residual" }
+        };
+        for ( const auto & o : orderings ) {
+            MDP::GaussSeidelValueIteration<GridModel> gs(horizon, epsilon, o.first);
+            benchmark(o.second, gs, model);
+            std::cout << "        " << gs.getSweeps() << " sweeps\n";
+        }
+    }
+
+    return 0;
+}
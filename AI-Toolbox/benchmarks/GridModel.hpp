@@ -0,0 +1,94 @@
+#ifndef AI_TOOLBOX_BENCHMARKS_GRID_MODEL_HEADER_FILE
+#define AI_TOOLBOX_BENCHMARKS_GRID_MODEL_HEADER_FILE
+
+#include <AIToolbox/MDP/Types.hpp>
+
+#include <random>
+#include <tuple>
+#include <vector>
+
+// The grids used in the benchmarks are too big to be built through the
+// dense tables taken by the models of the library, so they are described
+// by a minimal sparse model which only stores the Eigen matrices used by
+// the planning algorithms.
+
+/**
+ * @brief This class represents a side x side grid where the agent moves in the four directions.
+ *
+ * Each move succeeds with probability 0.8, and otherwise the agent slips
+ * to one of the two orthogonal directions. Moving into a wall leaves the
+ * agent where it is. Reaching the top left corner, which is absorbing,
+ * gives a reward of 1, and all other moves give nothing.
+ */
+class GridModel {
+    public:
+        GridModel(size_t side, double discount = 0.99) : side_(side), S(side * side), discount_(discount), transitions_(4), rewards_(4) {
+            for ( size_t a = 0; a < 4; ++a ) {
+                std::vector<Eigen::Triplet<AIToolbox::Scalar>> t, r;
+                t.reserve(3 * S); r.reserve(3 * S);
+
+                for ( size_t s = 0; s < S; ++s ) {
+                    if ( s == 0 ) {
+                        t.emplace_back(s, s, 1.0);
+                        continue;
+                    }
+                    // Up, right, down, left: slips are to the orthogonal directions.
+                    const double p[3] = { 0.8, 0.1, 0.1 };
+                    const size_t d[3] = { a, (a + 1) % 4, (a + 3) % 4 };
+                    for ( size_t i = 0; i < 3; ++i ) {
+                        t.emplace_back(s, move(s, d[i]), p[i]);
+                        if ( move(s, d[i]) == 0 ) r.emplace_back(s, 0, 1.0);
+                    }
+                }
+                // Duplicate entries (from bumping into walls) are summed.
+                transitions_[a].resize(S, S);
+                transitions_[a].setFromTriplets(t.begin(), t.end());
+                rewards_[a].resize(S, S);
+                rewards_[a].setFromTriplets(r.begin(), r.end(), [](double, double b){ return b; });
+            }
+        }
+
+        size_t getS() const { return S; }
+        size_t getA() const { return 4; }
+        double getDiscount() const { return discount_; }
+        bool isTerminal(size_t s) const { return s == 0; }
+
+        double getTransitionProbability(size_t s, size_t a, size_t s1) const { return transitions_[a].coeff(s, s1); }
+        double getExpectedReward(size_t s, size_t a, size_t s1) const { return rewards_[a].coeff(s, s1); }
+
+        std::tuple<size_t, double> sampleSR(size_t s, size_t a) const { return sampleSR(s, a, rand_); }
+
+        template <typename G>
+        std::tuple<size_t, double> sampleSR(size_t s, size_t a, G & generator) const {
+            std::uniform_real_distribution<double> dist(0.0, 1.0);
+            double p = dist(generator);
+            size_t s1 = s;
+            for ( AIToolbox::SparseMatrix2D::InnerIterator it(transitions_[a], s); it; ++it ) {
+                s1 = it.col();
+                if ( p < it.value() ) break;
+                p -= it.value();
+            }
+            return std::make_tuple(s1, getExpectedReward(s, a, s1));
+        }
+
+        const AIToolbox::SparseMatrix2D & getTransitionFunction(size_t a) const { return transitions_[a]; }
+        const AIToolbox::SparseMatrix2D & getRewardFunction(size_t a) const { return rewards_[a]; }
+
+    private:
+        size_t move(size_t s, size_t d) const {
+            const size_t x = s % side_, y = s / side_;
+            switch ( d ) {
+                case 0:  return y > 0         ? s - side_ : s;
+                case 1:  return x + 1 < side_ ? s + 1     : s;
+                case 2:  return y + 1 < side_ ? s + side_ : s;
+                default: return x > 0         ? s - 1     : s;
+            }
+        }
+
+        size_t side_, S;
+        double discount_;
+        AIToolbox::SparseMatrix3D transitions_, rewards_;
+        mutable std::mt19937 rand_;
+};
+
+#endif
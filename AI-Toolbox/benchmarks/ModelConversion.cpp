@@ -0,0 +1,72 @@
+#include <AIToolbox/MDP/Model.hpp>
+#include <AIToolbox/MDP/SparseModel.hpp>
+
+#include "RandomModel.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+// This benchmark measures the converting constructors of Model and
+// SparseModel, when copying whole Eigen matrices and when copying one
+// element at a time, which is what happens for models which do not
+// expose their matrices.
+//
+// Usage: ModelConversion [S] [A]
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Hides the matrices of a model, so that it can only be copied element by element.
+template <typename M>
+class ElementModel {
+    public:
+        ElementModel(const M & m) : m_(m) {}
+
+        size_t getS() const { return m_.getS(); }
+        size_t getA() const { return m_.getA(); }
+        double getDiscount() const { return m_.getDiscount(); }
+        bool isTerminal(size_t s) const { return m_.isTerminal(s); }
+        std::tuple<size_t, double> sampleSR(size_t s, size_t a) const { return m_.sampleSR(s, a); }
+        double getTransitionProbability(size_t s, size_t a, size_t s1) const { return m_.getTransitionProbability(s, a, s1); }
+        double getExpectedReward(size_t s, size_t a, size_t s1) const { return m_.getExpectedReward(s, a, s1); }
+
+    private:
+        const M & m_;
+};
+
+template <typename To, typename From>
+void run(const char * name, const From & from) {
+    auto start = Clock::now();
+    To bulk(from);
+    const double bulkTime = seconds(start);
+
+    start = Clock::now();
+    To element{ElementModel<From>(from)};
+    const double elementTime = seconds(start);
+
+    std::cout << "    " << std::left << std::setw(18) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(9) << bulkTime << " s bulk " << std::setw(9) << elementTime << " s element"
+              << "   [" << bulk.getTransitionProbability(0, 0, 0) - element.getTransitionProbability(0, 0, 0) << "]\n";
+}
+
+int main(int argc, char * argv[]) {
+    using namespace AIToolbox;
+
+    const size_t S = argc > 1 ? std::stoul(argv[1]) : 2000;
+    const size_t A = argc > 2 ? std::stoul(argv[2]) : 4;
+
+    std::cout << "S = " << S << ", A = " << A << "\n";
+
+    RandomModel random(S, A, 0.99);
+    const MDP::SparseModel sparse(random);
+    const MDP::Model dense(sparse);
+
+    run<MDP::SparseModel>("sparse -> sparse", sparse);
+    run<MDP::Model>      ("sparse -> dense",  sparse);
+    run<MDP::SparseModel>("dense -> sparse",  dense);
+    run<MDP::Model>      ("dense -> dense",   dense);
+}
@@ -0,0 +1,127 @@
+#include <AIToolbox/MDP/Algorithms/MCTS.hpp>
+#include <AIToolbox/POMDP/Algorithms/POMCP.hpp>
+#include <AIToolbox/POMDP/Algorithms/RootParallelPOMCP.hpp>
+
+#include "GridModel.hpp"
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+
+// This benchmark measures the simulations per second of MCTS and POMCP
+// while they act in a grid world, reusing their tree between steps, and
+// the peak memory used by the process.
+//
+// Since the peak memory is per process, a single planner is run each time.
+// The ensemble planner runs the given number of POMCP trees, each with the
+// given iterations, so its simulations per step are trees * iterations.
+//
+// Usage: OnlinePlanners mcts|pomcp|ensemble [side] [iterations] [steps] [trees]
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/**
+ * @brief This class represents a GridModel where the agent only sees its position approximately.
+ *
+ * The observation is the state the agent is in, shifted by up to two
+ * cells to the right, so that each state has several observations.
+ */
+class NoisyGridModel : public GridModel {
+    public:
+        NoisyGridModel(size_t side) : GridModel(side) {}
+
+        std::tuple<size_t, size_t, double> sampleSOR(size_t s, size_t a) const { return sampleSOR(s, a, rand_); }
+
+        template <typename G>
+        std::tuple<size_t, size_t, double> sampleSOR(size_t s, size_t a, G & generator) const {
+            std::uniform_int_distribution<size_t> noise(0, 2);
+            size_t s1; double r;
+            std::tie(s1, r) = sampleSR(s, a, generator);
+            return std::make_tuple(s1, (s1 + noise(generator)) % getS(), r);
+        }
+
+    private:
+        mutable std::mt19937 rand_;
+};
+
+template <typename Planner, typename Step>
+void run(const std::string & name, Planner & planner, unsigned iterations, unsigned steps, Step step) {
+    const auto start = Clock::now();
+    const size_t visited = step(planner, steps);
+    const double time = seconds(start);
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    std::cout << name << ": " << steps << " steps of " << iterations << " simulations, "
+              << std::fixed << std::setprecision(0) << iterations * steps / time << " simulations/s, "
+              << "peak RSS " << usage.ru_maxrss / 1024 << " MB   [" << visited << "]\n";
+}
+
+int main(int argc, char * argv[]) {
+    using namespace AIToolbox;
+
+    const std::string planner = argc > 1 ? argv[1] : "mcts";
+    const size_t side = argc > 2 ? std::stoul(argv[2]) : 30;
+    const unsigned iterations = argc > 3 ? std::stoul(argv[3]) : 100000;
+    const unsigned steps = argc > 4 ? std::stoul(argv[4]) : 10;
+    const unsigned trees = argc > 5 ? std::stoul(argv[5]) : std::max(1u, std::thread::hardware_concurrency());
+    const unsigned horizon = 4 * side;
+
+    // We start in the corner opposite to the goal.
+    const size_t start = side * side - 1;
+
+    if ( planner == "mcts" ) {
+        GridModel model(side);
+        MDP::MCTS<GridModel> solver(model, iterations, 1.0);
+        run("MCTS", solver, iterations, steps, [&](MDP::MCTS<GridModel> & solver, unsigned steps) {
+            size_t s = start, a = solver.sampleAction(s, horizon);
+            for ( unsigned i = 1; i < steps && !model.isTerminal(s); ++i ) {
+                s = std::get<0>(model.sampleSR(s, a));
+                a = solver.sampleAction(a, s, horizon - i);
+            }
+            return s;
+        });
+    } else if ( planner == "pomcp" ) {
+        NoisyGridModel model(side);
+        POMDP::POMCP<NoisyGridModel> solver(model, 1000, iterations, 1.0);
+        POMDP::Belief b = POMDP::Belief::Zero(model.getS());
+        b[start] = 1.0;
+        run("POMCP", solver, iterations, steps, [&](POMDP::POMCP<NoisyGridModel> & solver, unsigned steps) {
+            size_t s = start, a = solver.sampleAction(b, horizon);
+            for ( unsigned i = 1; i < steps && !model.isTerminal(s); ++i ) {
+                size_t o;
+                std::tie(s, o, std::ignore) = model.sampleSOR(s, a);
+                a = solver.sampleAction(a, o, horizon - i);
+            }
+            return s;
+        });
+    } else if ( planner == "ensemble" ) {
+        NoisyGridModel model(side);
+        POMDP::RootParallelPOMCP<NoisyGridModel> solver(model, 1000, iterations, 1.0, trees);
+        POMDP::Belief b = POMDP::Belief::Zero(model.getS());
+        b[start] = 1.0;
+        run("Ensemble of " + std::to_string(trees), solver, trees * iterations, steps,
+            [&](POMDP::RootParallelPOMCP<NoisyGridModel> & solver, unsigned steps) {
+                size_t s = start, a = solver.sampleAction(b, horizon);
+                for ( unsigned i = 1; i < steps && !model.isTerminal(s); ++i ) {
+                    size_t o;
+                    std::tie(s, o, std::ignore) = model.sampleSOR(s, a);
+                    a = solver.sampleAction(a, o, horizon - i);
+                }
+                return s;
+            });
+    } else {
+        std::cerr << "Usage: " << argv[0] << " mcts|pomcp|ensemble [side] [iterations] [steps] [trees]\n";
+        return 1;
+    }
+}
@@ -0,0 +1,64 @@
+#include <AIToolbox/MDP/Algorithms/MCTS.hpp>
+
+#include "../test/MDP/CliffProblem.hpp"
+#include "../test/MDP/CornerProblem.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// This benchmark measures how the simulations per second of MCTS scale
+// with the number of threads sharing its tree, on the grid worlds used in
+// the tests. Each decision plans from scratch for the same state.
+//
+// Usage: ParallelMCTS [iterations] [decisions] [max threads]
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+template <typename M>
+void run(const std::string & name, const M & model, size_t s, unsigned horizon, double exploration,
+         unsigned iterations, unsigned decisions, unsigned maxThreads)
+{
+    std::cout << name << ", " << decisions << " decisions of " << iterations << " simulations\n";
+
+    double base = 0.0;
+    for ( unsigned threads = 1; threads <= maxThreads; threads *= 2 ) {
+        AIToolbox::MDP::MCTS<M> solver(model, iterations, exploration);
+        solver.setThreads(threads);
+
+        std::vector<unsigned> actions(model.getA(), 0);
+        const auto start = Clock::now();
+        for ( unsigned i = 0; i < decisions; ++i )
+            ++actions[solver.sampleAction(s, horizon)];
+        const double time = seconds(start);
+
+        const double rate = iterations * decisions / time;
+        if ( threads == 1 ) base = rate;
+
+        std::cout << "    " << std::setw(2) << threads << " threads " << std::fixed << std::setprecision(0)
+                  << std::setw(10) << rate << " simulations/s   " << std::setprecision(2) << std::setw(5) << rate / base
+                  << "x   " << std::setprecision(1) << std::setw(6) << 1000.0 * time / decisions << " ms/decision   [";
+        for ( auto count : actions ) std::cout << ' ' << count;
+        std::cout << " ]\n";
+    }
+}
+
+int main(int argc, char * argv[]) {
+    const unsigned iterations = argc > 1 ? std::stoul(argv[1]) : 20000;
+    const unsigned decisions = argc > 2 ? std::stoul(argv[2]) : 20;
+    const unsigned maxThreads = argc > 3 ? std::stoul(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+
+    GridWorld cliffGrid(12, 3);
+    auto cliff = makeCliffProblem(cliffGrid);
+    run("Cliff 12x3", cliff, cliff.getS() - 2, 30, 50.0, iterations, decisions, maxThreads);
+
+    GridWorld cornerGrid(4, 4);
+    auto corner = makeCornerProblem(cornerGrid);
+    run("Corner 4x4", corner, 6, 10, 5.0, iterations, decisions, maxThreads);
+}
@@ -0,0 +1,57 @@
+#include <AIToolbox/MDP/Algorithms/PrioritizedSweeping.hpp>
+#include <AIToolbox/MDP/Algorithms/ParallelPrioritizedSweeping.hpp>
+
+#include "GridModel.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// This benchmark compares PrioritizedSweeping with ParallelPrioritizedSweeping
+// using an increasing number of threads. Every pair of a grid world is
+// updated once, which fills the queue, and then the queue is processed for
+// the same number of pops by all solvers.
+//
+// Usage: ParallelPrioritizedSweeping [side] [pops]
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+template <typename Solver>
+void run(const std::string & name, Solver & solver, const GridModel & model) {
+    const size_t S = model.getS(), A = model.getA();
+    for ( size_t s = 0; s < S; ++s )
+        for ( size_t a = 0; a < A; ++a )
+            solver.stepUpdateQ(s, a);
+
+    const auto start = Clock::now();
+    solver.batchUpdateQ();
+    const double time = seconds(start);
+
+    std::cout << "    " << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(8) << time << " s   queue " << std::setw(8) << solver.getQueueLength()
+              << "   [" << std::get<AIToolbox::MDP::VALUES>(solver.getValueFunction()).sum() << "]\n";
+}
+
+int main(int argc, char * argv[]) {
+    using namespace AIToolbox;
+
+    const size_t side = argc > 1 ? std::stoul(argv[1]) : 316;
+    const unsigned pops = argc > 2 ? std::stoul(argv[2]) : 1000000;
+
+    GridModel model(side);
+    std::cout << side << "x" << side << " grid (S = " << model.getS() << "), " << pops << " pops\n";
+
+    {
+        MDP::PrioritizedSweeping<GridModel> solver(model, 0.0, pops);
+        run("sequential", solver, model);
+    }
+    for ( unsigned threads : { 1, 2, 4, 8 } ) {
+        MDP::ParallelPrioritizedSweeping<GridModel> solver(model, 0.0, pops, threads);
+        run(std::to_string(threads) + " threads", solver, model);
+    }
+}
@@ -0,0 +1,56 @@
+#include <AIToolbox/MDP/Algorithms/ValueIteration.hpp>
+#include <AIToolbox/MDP/Algorithms/PolicyIteration.hpp>
+
+#include "GridModel.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+// This benchmark compares the time needed by ValueIteration and by
+// PolicyIteration, both with exact evaluation and with a few numbers of
+// evaluation sweeps, to converge on grid worlds of increasing size.
+//
+// Usage: PolicyIteration [discount] [epsilon]
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+template <typename Solver>
+void benchmark(const std::string & name, Solver & solver, const GridModel & model) {
+    auto start = Clock::now();
+    auto solution = solver(model);
+    const double time = seconds(start);
+
+    const auto & values = std::get<AIToolbox::MDP::VALUES>(std::get<1>(solution));
+    std::cout << "    " << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(10) << time << " s" << (std::get<0>(solution) ? "" : " (not converged)")
+              << "   [" << values.sum() << "]\n";
+}
+
+int main(int argc, char * argv[]) {
+    using namespace AIToolbox;
+
+    const double discount = argc > 1 ? std::stod(argv[1]) : 0.995;
+    const double epsilon = argc > 2 ? std::stod(argv[2]) : 0.001;
+    const unsigned horizon = 100000;
+
+    for ( size_t side : { 25, 50, 100 } ) {
+        GridModel model(side, discount);
+        std::cout << side << "x" << side << " grid (S = " << model.getS() << ", discount = " << discount << ")\n";
+
+        MDP::ValueIteration<GridModel> vi(horizon, epsilon);
+        benchmark("ValueIteration", vi, model);
+
+        for ( unsigned k : { 0, 5, 20, 50 } ) {
+            MDP::PolicyIteration<GridModel> pi(horizon, epsilon, k);
+            benchmark(k ? "PI, " + std::to_string(k) + " sweeps" : "PI, exact", pi, model);
+            std::cout << "        " << pi.getIterations() << " improvement steps\n";
+        }
+    }
+
+    return 0;
+}
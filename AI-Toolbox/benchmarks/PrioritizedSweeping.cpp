@@ -0,0 +1,54 @@
+#include <AIToolbox/MDP/Algorithms/PrioritizedSweeping.hpp>
+
+#include "GridModel.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+// This benchmark measures the time PrioritizedSweeping needs to build its
+// transition index and to process its queue on grid worlds of increasing
+// size. Since each queue pop only visits the predecessors of the popped
+// state, the time per pop should not grow with the size of the grid.
+//
+// Usage: PrioritizedSweeping [steps]
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char * argv[]) {
+    using namespace AIToolbox;
+
+    const unsigned steps = argc > 1 ? std::stoul(argv[1]) : 20000;
+    const unsigned n = 50;
+
+    for ( size_t side : { 50, 100, 316 } ) {
+        GridModel model(side);
+        const size_t S = model.getS();
+
+        auto start = Clock::now();
+        MDP::PrioritizedSweeping<GridModel> solver(model, 0.0, n);
+        const double setup = seconds(start);
+
+        // States near the goal are updated first, so that changes
+        // propagate backwards through the queue.
+        std::mt19937 rand(0);
+        std::uniform_int_distribution<size_t> state(0, std::min<size_t>(S, 1000) - 1), action(0, 3);
+
+        start = Clock::now();
+        for ( unsigned i = 0; i < steps; ++i ) {
+            solver.stepUpdateQ(state(rand), action(rand));
+            solver.batchUpdateQ();
+        }
+        const double time = seconds(start);
+
+        std::cout << side << "x" << side << " grid (S = " << S << ")\n"
+                  << "    index " << std::fixed << std::setprecision(3) << std::setw(8) << setup << " s"
+                  << "   updates " << std::setw(8) << time << " s"
+                  << "   [" << std::get<MDP::VALUES>(solver.getValueFunction()).sum() << "]\n";
+    }
+}
@@ -0,0 +1,127 @@
+#include <AIToolbox/IndexedHeap.hpp>
+
+#include <boost/heap/fibonacci_heap.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+// This benchmark compares the priority queue used by PrioritizedSweeping,
+// an IndexedHeap, with the boost::heap::fibonacci_heap and
+// std::unordered_map of handles it replaced, on the same sequence of
+// operations.
+//
+// Each round pushes a few random states, or increases their priority if
+// they are already queued, and then pops one state, as happens while
+// PrioritizedSweeping processes its queue.
+//
+// Usage: PriorityQueue [S] [rounds]
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct Operation {
+    size_t s;
+    double p;
+};
+
+// The queue PrioritizedSweeping used before IndexedHeap.
+class FibonacciQueue {
+    public:
+        FibonacciQueue(size_t) {}
+
+        void push(size_t s, double p) {
+            auto it = handles_.find(s);
+            if ( it == std::end(handles_) )
+                handles_[s] = queue_.push(std::make_tuple(p, s));
+            else if ( std::get<0>(*it->second) < p )
+                queue_.increase(it->second, std::make_tuple(p, s));
+        }
+
+        size_t pop() {
+            const size_t s = std::get<1>(queue_.top());
+            queue_.pop();
+            handles_.erase(s);
+            return s;
+        }
+
+        bool empty() const { return queue_.empty(); }
+
+    private:
+        using Element = std::tuple<double, size_t>;
+        struct Less {
+            bool operator()(const Element & lhs, const Element & rhs) const { return std::get<0>(lhs) < std::get<0>(rhs); }
+        };
+        using Queue = boost::heap::fibonacci_heap<Element, boost::heap::compare<Less>>;
+
+        Queue queue_;
+        std::unordered_map<size_t, Queue::handle_type> handles_;
+};
+
+template <unsigned D>
+class HeapQueue {
+    public:
+        HeapQueue(size_t S) : queue_(S) {}
+
+        void push(size_t s, double p) {
+            if ( !queue_.contains(s) || queue_.getPriority(s) < p )
+                queue_.push(s, p);
+        }
+
+        size_t pop() {
+            const size_t s = queue_.top();
+            queue_.pop();
+            return s;
+        }
+
+        bool empty() const { return queue_.empty(); }
+
+    private:
+        AIToolbox::IndexedHeap<D> queue_;
+};
+
+template <typename Q>
+void run(const char * name, size_t S, const std::vector<Operation> & ops, unsigned pushes) {
+    const auto start = Clock::now();
+    Q queue(S);
+
+    size_t check = 0;
+    for ( size_t i = 0; i < ops.size(); ) {
+        for ( unsigned j = 0; j < pushes && i < ops.size(); ++j, ++i )
+            queue.push(ops[i].s, ops[i].p);
+        check += queue.pop();
+    }
+    while ( !queue.empty() )
+        check += queue.pop();
+
+    const double time = seconds(start);
+    std::cout << "    " << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(8) << time << " s   [" << check << "]\n";
+}
+
+int main(int argc, char * argv[]) {
+    const size_t S = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const size_t rounds = argc > 2 ? std::stoul(argv[2]) : 2000000;
+    const unsigned pushes = 4;
+
+    std::mt19937 rand(0);
+    std::uniform_int_distribution<size_t> state(0, S - 1);
+    std::uniform_real_distribution<double> priority(0.0, 1.0);
+
+    std::vector<Operation> ops(rounds * pushes);
+    for ( auto & op : ops ) op = { state(rand), priority(rand) };
+
+    std::cout << "S = " << S << ", " << rounds << " rounds of " << pushes << " pushes and 1 pop\n";
+
+    run<FibonacciQueue>("fibonacci + map", S, ops, pushes);
+    run<HeapQueue<2>>  ("IndexedHeap<2>", S, ops, pushes);
+    run<HeapQueue<4>>  ("IndexedHeap<4>", S, ops, pushes);
+    run<HeapQueue<8>>  ("IndexedHeap<8>", S, ops, pushes);
+}
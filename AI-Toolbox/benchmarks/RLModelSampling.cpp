@@ -0,0 +1,63 @@
+#include <AIToolbox/MDP/Experience.hpp>
+#include <AIToolbox/MDP/RLModel.hpp>
+#include <AIToolbox/ProbabilityUtils.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+// This benchmark measures a Dyna-like loop on an RLModel learned online:
+// each step records a transition, syncs it, and then samples the model a
+// few times. It compares RLModel::sampleSR against a linear scan of the
+// same transition rows, for growing state spaces.
+//
+// Usage: RLModelSampling [steps]
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char * argv[]) {
+    using namespace AIToolbox;
+
+    const size_t steps = argc > 1 ? std::stoul(argv[1]) : 200000;
+    const size_t A = 4, samplesPerStep = 10;
+
+    for ( size_t S : { 100, 500, 1000, 2000, 4000 } ) {
+        MDP::Experience exp(S, A);
+        MDP::RLModel model(exp, 0.9, false);
+
+        std::mt19937 rand(0);
+        std::uniform_int_distribution<size_t> sDist(0, S-1), aDist(0, A-1);
+        // Each state only reaches a few neighbours, like in a grid.
+        std::uniform_int_distribution<size_t> stepDist(0, 8);
+
+        size_t check = 0;
+        double scanTime = 0.0, treeTime = 0.0;
+        for ( size_t i = 0; i < steps; ++i ) {
+            const size_t s = sDist(rand), a = aDist(rand);
+            const size_t s1 = (s + stepDist(rand)) % S;
+            exp.record(s, a, s1, 1.0);
+            model.sync(s, a, s1);
+
+            auto start = Clock::now();
+            for ( size_t j = 0; j < samplesPerStep; ++j )
+                check += sampleProbability(S, model.getTransitionFunction(a).row(s), rand);
+            scanTime += seconds(start);
+
+            start = Clock::now();
+            for ( size_t j = 0; j < samplesPerStep; ++j )
+                check += std::get<0>(model.sampleSR(s, a));
+            treeTime += seconds(start);
+        }
+        const double samples = steps * samplesPerStep;
+        std::cout << "S = " << std::setw(5) << S << std::fixed << std::setprecision(2)
+                  << "   scan " << std::setw(8) << samples / scanTime / 1e6 << " Msamples/s"
+                  << "   sampleSR " << std::setw(8) << samples / treeTime / 1e6 << " Msamples/s"
+                  << "   [" << check << "]\n";
+    }
+    return 0;
+}
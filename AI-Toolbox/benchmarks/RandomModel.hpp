@@ -0,0 +1,60 @@
+#ifndef AI_TOOLBOX_BENCHMARKS_RANDOM_MODEL_HEADER_FILE
+#define AI_TOOLBOX_BENCHMARKS_RANDOM_MODEL_HEADER_FILE
+
+#include <AIToolbox/MDP/Types.hpp>
+
+#include <random>
+#include <tuple>
+#include <vector>
+
+/**
+ * @brief This class represents a random sparse model where each action leads to a few nearby states.
+ *
+ * Each action of each state has a random cost in [-1, 0], and leads to
+ * three random states at most spread states away, with probabilities 0.6,
+ * 0.3 and 0.1. The model is built as the minimal sparse model used by the
+ * planning algorithms, like GridModel.
+ */
+class RandomModel {
+    public:
+        RandomModel(size_t S, size_t A, double discount, long spread = 20, unsigned seed = 42) : S(S), A(A), discount_(discount), transitions_(A), rewards_(A) {
+            std::mt19937 rand(seed);
+            std::uniform_int_distribution<long> offset(-spread, spread);
+            std::uniform_real_distribution<double> cost(-1.0, 0.0);
+
+            for ( size_t a = 0; a < A; ++a ) {
+                std::vector<Eigen::Triplet<AIToolbox::Scalar>> t, r;
+                for ( size_t s = 0; s < S; ++s ) {
+                    const double c = cost(rand);
+                    for ( double p : { 0.6, 0.3, 0.1 } ) {
+                        const size_t s1 = (s + S + offset(rand)) % S;
+                        t.emplace_back(s, s1, p);
+                        r.emplace_back(s, s1, c);
+                    }
+                }
+                transitions_[a].resize(S, S);
+                transitions_[a].setFromTriplets(t.begin(), t.end());
+                rewards_[a].resize(S, S);
+                rewards_[a].setFromTriplets(r.begin(), r.end(), [](double, double b){ return b; });
+            }
+        }
+
+        size_t getS() const { return S; }
+        size_t getA() const { return A; }
+        double getDiscount() const { return discount_; }
+        bool isTerminal(size_t) const { return false; }
+
+        double getTransitionProbability(size_t s, size_t a, size_t s1) const { return transitions_[a].coeff(s, s1); }
+        double getExpectedReward(size_t s, size_t a, size_t s1) const { return rewards_[a].coeff(s, s1); }
+        std::tuple<size_t, double> sampleSR(size_t s, size_t) const { return std::make_tuple(s, 0.0); }
+
+        const AIToolbox::SparseMatrix2D & getTransitionFunction(size_t a) const { return transitions_[a]; }
+        const AIToolbox::SparseMatrix2D & getRewardFunction(size_t a) const { return rewards_[a]; }
+
+    private:
+        size_t S, A;
+        double discount_;
+        AIToolbox::SparseMatrix3D transitions_, rewards_;
+};
+
+#endif
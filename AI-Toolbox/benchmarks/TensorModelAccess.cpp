@@ -0,0 +1,97 @@
+#include <AIToolbox/MDP/Model.hpp>
+#include <AIToolbox/MDP/TensorModel.hpp>
+
+#include "RandomModel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+// This benchmark compares the per-state and per-action access patterns of
+// Model, where each action matrix is a separate allocation, and
+// TensorModel in both its layouts.
+//
+// The per-state pattern visits the states in random order, and for each
+// computes the backup of all its actions, like PrioritizedSweeping and
+// GaussSeidelValueIteration do. The per-action pattern multiplies each
+// whole action matrix with the values, like ValueIteration does.
+//
+// Usage: TensorModelAccess [S] [A] [filter]
+//
+// Only the runs whose name contains the filter are executed, so that
+// cache misses of a single run can be measured, for example with
+//
+//     perf stat -e cache-references,cache-misses ./TensorModelAccess 3000 8 "state tensor/s"
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+template <typename M>
+double perState(const M & model, const std::vector<size_t> & order, const AIToolbox::Vector & v) {
+    const size_t A = model.getA();
+    double check = 0.0;
+    for ( auto s : order )
+        for ( size_t a = 0; a < A; ++a )
+            check += model.getTransitionFunction(a).row(s).dot(v);
+    return check;
+}
+
+template <typename M>
+double perAction(const M & model, const AIToolbox::Vector & v) {
+    const size_t A = model.getA();
+    AIToolbox::Vector tmp(model.getS());
+    double check = 0.0;
+    for ( size_t a = 0; a < A; ++a ) {
+        tmp.noalias() = model.getTransitionFunction(a) * v;
+        check += tmp.sum();
+    }
+    return check;
+}
+
+template <typename M>
+void run(const std::string & name, const std::string & filter, const M & model, const std::vector<size_t> & order, const AIToolbox::Vector & v, unsigned reps) {
+    for ( bool state : { true, false } ) {
+        const std::string label = (state ? "state " : "action ") + name;
+        if ( label.find(filter) == std::string::npos ) continue;
+
+        double check = 0.0;
+        const auto start = Clock::now();
+        for ( unsigned i = 0; i < reps; ++i )
+            check += state ? perState(model, order, v) : perAction(model, v);
+        const double time = seconds(start);
+
+        std::cout << "    " << std::left << std::setw(24) << label << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(9) << time << " s   [" << check << "]\n";
+    }
+}
+
+int main(int argc, char * argv[]) {
+    using namespace AIToolbox;
+
+    const size_t S = argc > 1 ? std::stoul(argv[1]) : 3000;
+    const size_t A = argc > 2 ? std::stoul(argv[2]) : 8;
+    const std::string filter = argc > 3 ? argv[3] : "";
+    const unsigned reps = 5;
+
+    std::cout << "S = " << S << ", A = " << A << "\n";
+
+    const MDP::Model model(RandomModel(S, A, 0.99));
+    const MDP::TensorModel stateMajor(model, MDP::STATE_MAJOR);
+    const MDP::TensorModel actionMajor(model, MDP::ACTION_MAJOR);
+
+    std::vector<size_t> order(S);
+    for ( size_t s = 0; s < S; ++s ) order[s] = s;
+    std::shuffle(std::begin(order), std::end(order), std::mt19937(0));
+
+    const Vector v = Vector::LinSpaced(S, 0.0, 1.0);
+
+    run("model",    filter, model,       order, v, reps);
+    run("tensor/s", filter, stateMajor,  order, v, reps);
+    run("tensor/a", filter, actionMajor, order, v, reps);
+}
@@ -0,0 +1,61 @@
+#include <AIToolbox/MDP/Model.hpp>
+#include <AIToolbox/MDP/SparseModel.hpp>
+#include <AIToolbox/MDP/Algorithms/ValueIteration.hpp>
+
+#include "CassandraPOMDP.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+// This benchmark measures the time taken by ValueIteration to perform a
+// fixed number of sweeps over the MDP underlying a POMDP file, both with
+// the sparse and (if it fits comfortably in memory) the dense model.
+//
+// Usage: ValueIteration file.POMDP [sweeps]
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+template <typename M>
+void benchmark(const std::string & name, const M & model, unsigned sweeps) {
+    // An epsilon of zero forces all sweeps to be performed.
+    AIToolbox::MDP::ValueIteration<M> solver(sweeps, 0.0);
+
+    auto start = Clock::now();
+    auto solution = solver(model);
+    const double time = seconds(start);
+
+    const auto & values = std::get<AIToolbox::MDP::VALUES>(std::get<1>(solution));
+    std::cout << std::left << std::setw(8) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(10) << time << " s" << std::setw(10) << time / sweeps * 1e3 << " ms/sweep"
+              << "   [" << values.sum() << "]\n";
+}
+
+int main(int argc, char * argv[]) {
+    using namespace AIToolbox;
+
+    if ( argc < 2 ) {
+        std::cerr << "Usage: " << argv[0] << " file.POMDP [sweeps]\n";
+        return 1;
+    }
+    const unsigned sweeps = argc > 2 ? std::stoul(argv[2]) : 100;
+
+    CassandraPOMDP file(argv[1]);
+    const size_t S = file.getS(), A = file.getA();
+    std::cout << argv[1] << ": S = " << S << ", A = " << A << ", " << sizeof(Scalar) * 8 << " bit scalars\n";
+
+    {
+        MDP::SparseModel model(S, A, file.getTransitionView(), file.getRewardView(), file.getDiscount());
+        benchmark("sparse", model, sweeps);
+    }
+    if ( S * S * A <= 100000000 ) {
+        MDP::Model model(S, A, file.getTransitionView(), file.getRewardView(), file.getDiscount());
+        benchmark("dense", model, sweeps);
+    }
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include <AIToolbox/MDP/Algorithms/ValueIteration.hpp>
+
+#include "GridModel.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// This benchmark measures how ValueIteration scales with the number of
+// threads, over square grid worlds of increasing size.
+//
+// Usage: ValueIterationScaling [sweeps] [maxThreads]
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char * argv[]) {
+    using namespace AIToolbox;
+
+    static_assert(MDP::is_model_eigen<GridModel>::value, "GridModel must be usable by the Eigen ValueIteration");
+
+    const unsigned sweeps = argc > 1 ? std::stoul(argv[1]) : 100;
+    const unsigned maxThreads = argc > 2 ? std::stoul(argv[2]) : 8;
+    std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << ", " << sweeps << " sweeps\n";
+
+    for ( size_t side : { 50, 100, 200, 400 } ) {
+        auto start = Clock::now();
+        GridModel model(side);
+        std::cout << side << "x" << side << " grid (S = " << model.getS() << ", built in "
+                  << std::fixed << std::setprecision(3) << seconds(start) << " s)\n";
+
+        double base = 0.0;
+        for ( unsigned threads = 1; threads <= maxThreads; threads *= 2 ) {
+            // An epsilon of zero forces all sweeps to be performed.
+            MDP::ValueIteration<GridModel> solver(sweeps, 0.0);
+            solver.setThreads(threads);
+
+            start = Clock::now();
+            auto solution = solver(model);
+            const double time = seconds(start);
+            if ( threads == 1 ) base = time;
+
+            const auto & values = std::get<MDP::VALUES>(std::get<1>(solution));
+            std::cout << std::setw(4) << threads << " threads" << std::setw(10) << time << " s"
+                      << std::setw(10) << time / sweeps * 1e3 << " ms/sweep"
+                      << std::setw(8) << std::setprecision(2) << base / time << "x"
+                      << std::setprecision(3) << "   [" << values.sum() << "]\n";
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,140 @@
+#ifndef AI_TOOLBOX_ALIAS_TABLE_HEADER_FILE
+#define AI_TOOLBOX_ALIAS_TABLE_HEADER_FILE
+
+#include <cstddef>
+#include <vector>
+#include <random>
+
+#include <AIToolbox/Types.hpp>
+
+namespace AIToolbox {
+    /**
+     * @brief This class stores a Walker alias table for each row of a stochastic matrix.
+     *
+     * Sampling an index from a probability vector with a linear scan costs
+     * O(d), which becomes the bottleneck when the same distributions are
+     * sampled over and over again (for example in MCTS or POMCP rollouts).
+     *
+     * An alias table pays O(d) once at construction, and afterwards allows
+     * to sample from the distribution in O(1), using a single uniform random
+     * number. This class builds one such table for every row of the input
+     * matrix, considering only the non-zero entries of each row. All tables
+     * are stored contiguously, so that memory is proportional to the number
+     * of non-zero entries of the input matrix.
+     *
+     * Since the tables are a snapshot of the matrix, they need to be rebuilt
+     * whenever the underlying matrix changes.
+     */
+    class AliasTable {
+        public:
+            /**
+             * @brief Basic constructor.
+             *
+             * This constructor creates an empty table, with no rows.
+             */
+            AliasTable();
+
+            /**
+             * @brief This constructor builds the tables for all rows of a dense matrix.
+             *
+             * Each row of the input must be a valid probability
+             * distribution; this is not checked.
+             *
+             * @param m The matrix whose rows need to be sampled.
+             */
+            AliasTable(const Matrix2D & m);
+
+            /**
+             * @brief This constructor builds the tables for all rows of a sparse matrix.
+             *
+             * Each row of the input must be a valid probability
+             * distribution; this is not checked.
+             *
+             * @param m The matrix whose rows need to be sampled.
+             */
+            AliasTable(const SparseMatrix2D & m);
+
+            /**
+             * @brief This function samples a column index from the distribution in the specified row.
+             *
+             * The generator has to be compatible with
+             * std::uniform_real_distribution<double>, since that is what
+             * is used to obtain the random sample.
+             *
+             * @tparam G The type of the generator used.
+             * @param row The row to sample from.
+             * @param generator The generator used to sample.
+             *
+             * @return A column index with non-zero probability in the input row.
+             */
+            template <typename G>
+            size_t sampleRow(size_t row, G & generator) const;
+
+            /**
+             * @brief This function maps a uniform random number to a column index of the specified row.
+             *
+             * This function allows to separate the generation of random
+             * numbers from the table lookups, so that batches of samples
+             * can be drawn in two tight passes.
+             *
+             * @param row The row to sample from.
+             * @param u A uniformly distributed number in [0,1).
+             *
+             * @return A column index with non-zero probability in the input row.
+             */
+            size_t sampleRow(size_t row, double u) const;
+
+            /**
+             * @brief This function returns the number of rows stored in the table.
+             *
+             * @return The number of rows.
+             */
+            size_t getRows() const;
+
+        private:
+            /**
+             * @brief This function builds the alias table for the last row.
+             *
+             * The row is assumed to have already been appended to
+             * outcomes_ and prob_, with prob_ containing the original
+             * probabilities of the non-zero entries. This function
+             * transforms them into alias form and closes the row.
+             */
+            void closeRow();
+
+            // Start of each row in the following vectors (size rows+1).
+            std::vector<size_t> rowStart_;
+            // Probability of keeping each bucket, rather than its alias.
+            std::vector<double> prob_;
+            // Alias of each bucket, as an absolute index in outcomes_.
+            std::vector<size_t> alias_;
+            // Column index represented by each bucket.
+            std::vector<size_t> outcomes_;
+    };
+
+    template <typename G>
+    size_t AliasTable::sampleRow(size_t row, G & generator) const {
+        // Deterministic rows are common, and need no randomness.
+        if ( rowStart_[row+1] - rowStart_[row] == 1 ) return outcomes_[rowStart_[row]];
+
+        std::uniform_real_distribution<double> sampleDistribution(0.0, 1.0);
+        return sampleRow(row, sampleDistribution(generator));
+    }
+
+    inline size_t AliasTable::sampleRow(size_t row, double u) const {
+        const size_t start = rowStart_[row];
+        const size_t n = rowStart_[row+1] - start;
+
+        // A single uniform number gives us both the bucket and the
+        // coin flip used to decide between the bucket and its alias.
+        u *= n;
+        size_t i = static_cast<size_t>(u);
+        if ( i == n ) --i;
+
+        const size_t bucket = start + i;
+        if ( u - i < prob_[bucket] ) return outcomes_[bucket];
+        return outcomes_[alias_[bucket]];
+    }
+}
+
+#endif
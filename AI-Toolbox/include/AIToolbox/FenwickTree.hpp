@@ -0,0 +1,139 @@
+#ifndef AI_TOOLBOX_FENWICK_TREE_HEADER_FILE
+#define AI_TOOLBOX_FENWICK_TREE_HEADER_FILE
+
+#include <cstddef>
+#include <vector>
+#include <random>
+
+namespace AIToolbox {
+    /**
+     * @brief This class represents a Fenwick tree over integer weights.
+     *
+     * A Fenwick tree (or binary indexed tree) stores a vector of weights so
+     * that both point updates and prefix sums cost O(log n). This makes it
+     * possible to sample an index proportionally to its weight in O(log n),
+     * even when the weights change all the time, which is what happens to
+     * the visit counts of an Experience while an agent is learning.
+     *
+     * Weights are stored as unsigned integers, so sampling from counts is
+     * exact and does not suffer from accumulated rounding errors.
+     */
+    class FenwickTree {
+        public:
+            /**
+             * @brief Basic constructor.
+             *
+             * All weights are initialized to zero.
+             *
+             * @param n The number of weights stored in the tree.
+             */
+            FenwickTree(size_t n = 0);
+
+            /**
+             * @brief This function replaces all weights with the ones provided.
+             *
+             * The container needs to support data access through
+             * operator[], and have at least as many elements as the tree.
+             *
+             * This function runs in O(n).
+             *
+             * @tparam C The external container type.
+             * @param values The external container.
+             */
+            template <typename C>
+            void assign(const C & values);
+
+            /**
+             * @brief This function adds a delta to the weight of the specified index.
+             *
+             * The resulting weight must not be negative.
+             *
+             * @param i The index to update.
+             * @param delta The amount to add to the weight.
+             */
+            void add(size_t i, long delta);
+
+            /**
+             * @brief This function sets the weight of the specified index.
+             *
+             * @param i The index to update.
+             * @param value The new weight.
+             */
+            void set(size_t i, unsigned long value);
+
+            /**
+             * @brief This function returns the weight of the specified index.
+             *
+             * @param i The index requested.
+             *
+             * @return The weight of the index.
+             */
+            unsigned long get(size_t i) const;
+
+            /**
+             * @brief This function returns the sum of all weights in the tree.
+             *
+             * @return The total weight.
+             */
+            unsigned long getTotal() const;
+
+            /**
+             * @brief This function returns the index whose cumulative weight range contains the input.
+             *
+             * In other words, this function returns the smallest index i
+             * such that the sum of the weights up to and including i is
+             * greater than the input. The input must be lower than
+             * getTotal().
+             *
+             * @param target The cumulative weight to look for.
+             *
+             * @return The index containing the target weight.
+             */
+            size_t find(unsigned long target) const;
+
+            /**
+             * @brief This function samples an index proportionally to its weight.
+             *
+             * The total weight must be greater than zero.
+             *
+             * @tparam G The type of the generator used.
+             * @param generator The generator used to sample.
+             *
+             * @return The sampled index.
+             */
+            template <typename G>
+            size_t sample(G & generator) const;
+
+            /**
+             * @brief This function returns the number of weights stored in the tree.
+             *
+             * @return The size of the tree.
+             */
+            size_t size() const;
+
+        private:
+            size_t n_, topBit_;
+            // 1-based tree of partial sums.
+            std::vector<unsigned long> tree_;
+    };
+
+    template <typename C>
+    void FenwickTree::assign(const C & values) {
+        for ( size_t i = 0; i < n_; ++i )
+            tree_[i + 1] = values[i];
+
+        // Each node passes its partial sum to its parent.
+        for ( size_t i = 1; i <= n_; ++i ) {
+            const size_t parent = i + (i & (~i + 1));
+            if ( parent <= n_ ) tree_[parent] += tree_[i];
+        }
+    }
+
+    template <typename G>
+    size_t FenwickTree::sample(G & generator) const {
+        std::uniform_int_distribution<unsigned long> sampleDistribution(0, getTotal() - 1);
+        return find(sampleDistribution(generator));
+    }
+}
+
+#endif
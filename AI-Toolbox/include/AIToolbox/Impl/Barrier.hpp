@@ -0,0 +1,41 @@
+#ifndef AI_TOOLBOX_IMPL_BARRIER_HEADER_FILE
+#define AI_TOOLBOX_IMPL_BARRIER_HEADER_FILE
+
+#include <condition_variable>
+#include <mutex>
+
+namespace AIToolbox {
+    namespace Impl {
+        /**
+         * @brief This class synchronizes a fixed number of threads.
+         *
+         * Each call to wait() blocks until all threads have called it,
+         * after which all of them are released together. The barrier can
+         * be reused as many times as needed, which makes it suitable to
+         * separate the phases of iterative parallel algorithms.
+         */
+        class Barrier {
+            public:
+                /**
+                 * @brief Basic constructor.
+                 *
+                 * @param count The number of threads that need to wait on the barrier.
+                 */
+                explicit Barrier(unsigned count);
+
+                /**
+                 * @brief This function blocks until all threads have called it.
+                 */
+                void wait();
+
+            private:
+                std::mutex mutex_;
+                std::condition_variable cv_;
+                const unsigned count_;
+                unsigned waiting_;
+                unsigned long generation_;
+        };
+    }
+}
+
+#endif
@@ -1,24 +1,79 @@
 #ifndef AI_TOOLBOX_IMPL_SEEDER_HEADER_FILE
 #define AI_TOOLBOX_IMPL_SEEDER_HEADER_FILE
 
-#include <random>
+#include <cstdint>
+
+#include <AIToolbox/RandomEngine.hpp>
 
 namespace AIToolbox {
     namespace Impl {
         /**
-         * @brief This class is an internal class used to seed all random engines in the library.
+         * @brief This class is used to seed all random engines in the library.
+         *
+         * All seeds are derived from a single root seed. By default the root
+         * seed is taken from the current time, but it can be set manually in
+         * order to obtain reproducible runs.
+         *
+         * Seeds returned by getSeed() depend on the root seed and on the
+         * number of seeds requested before, so objects created in the same
+         * order always obtain the same seeds. This function is thread-safe.
          *
-         * To avoid seeding all generators with a single seed equal to the current time, only
-         * this class is setup with the time seed, while all others are seeded with numbers
-         * generated from this class to obtain maximum randomness.
+         * When the order of creation cannot be fixed (for example when
+         * objects are created concurrently by multiple threads), getStream()
+         * can be used instead: the stream returned for a given id only
+         * depends on the root seed and on the id itself, so that each thread
+         * can obtain its own stream and the results do not depend on how
+         * many threads are running.
+         *
+         * The multi-threaded algorithms of the library do not use
+         * getStream(), as the same id would give the same stream to every
+         * object and to every call. Instead each object splits the engines
+         * of its threads from its own engine (see RandomEngine::split()).
+         * Their results are thus reproducible when running on a single
+         * thread; with more threads they also depend on how the threads
+         * are scheduled, and so on their number.
          */
         class Seeder {
             public:
-                static unsigned getSeed();
-            private:
-                Seeder();
+                /**
+                 * @brief This function returns a new seed.
+                 *
+                 * @return A seed derived from the root seed and the number of seeds already returned.
+                 */
+                static std::uint64_t getSeed();
 
-                std::default_random_engine generator_;
+                /**
+                 * @brief This function returns an engine for the specified stream.
+                 *
+                 * The streams returned by this function are disjoint from
+                 * the seeds returned by getSeed().
+                 *
+                 * @param id The id of the stream (for example a thread index).
+                 *
+                 * @return An engine only dependent on the root seed and the id.
+                 */
+                static RandomEngine getStream(std::uint64_t id);
+
+                /**
+                 * @brief This function sets the root seed.
+                 *
+                 * This also resets the sequence of seeds returned by
+                 * getSeed(), so that all objects created after this call
+                 * are seeded deterministically.
+                 *
+                 * @param seed The new root seed.
+                 */
+                static void setRootSeed(std::uint64_t seed);
+
+                /**
+                 * @brief This function returns the current root seed.
+                 *
+                 * @return The root seed.
+                 */
+                static std::uint64_t getRootSeed();
+
+            private:
+                Seeder() = delete;
         };
     }
 }
@@ -0,0 +1,266 @@
+#ifndef AI_TOOLBOX_INDEXED_HEAP_HEADER_FILE
+#define AI_TOOLBOX_INDEXED_HEAP_HEADER_FILE
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace AIToolbox {
+    /**
+     * @brief This class represents a max priority queue over the indices 0 to n-1.
+     *
+     * Each index can be in the queue at most once, and its priority can be
+     * changed while it is in the queue. The queue is a D-ary heap stored in
+     * a flat array, together with the position of each index in the heap,
+     * so that no memory is allocated after construction and every
+     * operation only touches a few contiguous cache lines.
+     *
+     * Several heaps which never hold the same index at the same time can
+     * share a single array of positions, so that each heap only needs
+     * memory for the indices it actually holds.
+     *
+     * A higher arity makes the heap shallower, which speeds up pushes and
+     * priority increases, at the cost of more comparisons per level when
+     * popping. The default of 4 is usually a good tradeoff.
+     *
+     * @tparam D The number of children of each node of the heap.
+     */
+    template <unsigned D = 4>
+    class IndexedHeap {
+        static_assert(D >= 2, "IndexedHeap needs at least two children per node");
+
+        public:
+            /**
+             * @brief Basic constructor.
+             *
+             * @param n The number of indices that can be stored in the queue.
+             */
+            IndexedHeap(size_t n = 0);
+
+            /**
+             * @brief This constructor uses an external array for the positions of the indices.
+             *
+             * The array must have an entry for each index, all set to
+             * npos, and must outlive the heap. It can be shared with
+             * other heaps, as long as no index is in more than one of
+             * them at the same time. The heap itself grows as needed.
+             *
+             * @param positions The array of positions.
+             */
+            explicit IndexedHeap(size_t * positions);
+
+            /**
+             * @brief This function inserts an index in the queue, or changes its priority if it is already in it.
+             *
+             * This function runs in O(log n).
+             *
+             * @param i The index to insert.
+             * @param priority The priority of the index.
+             */
+            void push(size_t i, double priority);
+
+            /**
+             * @brief This function removes the index with the highest priority from the queue.
+             *
+             * The queue must not be empty. This function runs in O(D log n).
+             */
+            void pop();
+
+            /**
+             * @brief This function returns the index with the highest priority.
+             *
+             * The queue must not be empty.
+             *
+             * @return The index with the highest priority.
+             */
+            size_t top() const;
+
+            /**
+             * @brief This function returns the highest priority in the queue.
+             *
+             * The queue must not be empty.
+             *
+             * @return The priority of top().
+             */
+            double topPriority() const;
+
+            /**
+             * @brief This function returns whether an index is in the queue.
+             *
+             * @param i The index requested.
+             *
+             * @return True if the index is in the queue, false otherwise.
+             */
+            bool contains(size_t i) const;
+
+            /**
+             * @brief This function returns the priority of an index in the queue.
+             *
+             * The index must be in the queue.
+             *
+             * @param i The index requested.
+             *
+             * @return The priority of the index.
+             */
+            double getPriority(size_t i) const;
+
+            /**
+             * @brief This function removes all indices from the queue.
+             *
+             * This function runs in O(size()).
+             */
+            void clear();
+
+            /**
+             * @brief This function returns whether the queue is empty.
+             *
+             * @return True if the queue is empty, false otherwise.
+             */
+            bool empty() const;
+
+            /**
+             * @brief This function returns the number of indices in the queue.
+             *
+             * @return The number of indices in the queue.
+             */
+            size_t size() const;
+
+            // The position of an index which is not in the queue.
+            static constexpr size_t npos = static_cast<size_t>(-1);
+
+        private:
+            struct Node {
+                double priority;
+                size_t index;
+            };
+
+            /**
+             * @brief This function moves a node towards the root until the heap is valid.
+             */
+            void siftUp(size_t pos);
+
+            /**
+             * @brief This function moves a node towards the leaves until the heap is valid.
+             */
+            void siftDown(size_t pos);
+
+            /**
+             * @brief This function returns the position of an index in heap_, or npos if it is not in the queue.
+             */
+            size_t & position(size_t i);
+            size_t position(size_t i) const;
+
+            std::vector<Node> heap_;
+            // The positions of the indices, unless they are stored in
+            // an external array.
+            std::vector<size_t> positions_;
+            size_t * shared_;
+    };
+
+    template <unsigned D>
+    constexpr size_t IndexedHeap<D>::npos;
+
+    template <unsigned D>
+    IndexedHeap<D>::IndexedHeap(size_t n) : positions_(n, npos), shared_(nullptr) {
+        heap_.reserve(n);
+    }
+
+    template <unsigned D>
+    IndexedHeap<D>::IndexedHeap(size_t * positions) : shared_(positions) {}
+
+    template <unsigned D>
+    void IndexedHeap<D>::push(size_t i, double priority) {
+        size_t pos = position(i);
+        if ( pos == npos ) {
+            pos = heap_.size();
+            heap_.push_back({priority, i});
+            position(i) = pos;
+            siftUp(pos);
+            return;
+        }
+        const double old = heap_[pos].priority;
+        heap_[pos].priority = priority;
+        if ( priority > old ) siftUp(pos);
+        else siftDown(pos);
+    }
+
+    template <unsigned D>
+    void IndexedHeap<D>::pop() {
+        position(heap_[0].index) = npos;
+        if ( heap_.size() > 1 ) {
+            heap_[0] = heap_.back();
+            position(heap_[0].index) = 0;
+        }
+        heap_.pop_back();
+        if ( heap_.size() ) siftDown(0);
+    }
+
+    template <unsigned D>
+    size_t IndexedHeap<D>::top() const { return heap_[0].index; }
+
+    template <unsigned D>
+    double IndexedHeap<D>::topPriority() const { return heap_[0].priority; }
+
+    template <unsigned D>
+    bool IndexedHeap<D>::contains(size_t i) const { return position(i) != npos; }
+
+    template <unsigned D>
+    double IndexedHeap<D>::getPriority(size_t i) const { return heap_[position(i)].priority; }
+
+    template <unsigned D>
+    void IndexedHeap<D>::clear() {
+        for ( const auto & node : heap_ )
+            position(node.index) = npos;
+        heap_.clear();
+    }
+
+    template <unsigned D>
+    bool IndexedHeap<D>::empty() const { return heap_.empty(); }
+
+    template <unsigned D>
+    size_t IndexedHeap<D>::size() const { return heap_.size(); }
+
+    template <unsigned D>
+    size_t & IndexedHeap<D>::position(size_t i) { return shared_ ? shared_[i] : positions_[i]; }
+
+    template <unsigned D>
+    size_t IndexedHeap<D>::position(size_t i) const { return shared_ ? shared_[i] : positions_[i]; }
+
+    template <unsigned D>
+    void IndexedHeap<D>::siftUp(size_t pos) {
+        const Node node = heap_[pos];
+        while ( pos > 0 ) {
+            const size_t parent = (pos - 1) / D;
+            if ( !(heap_[parent].priority < node.priority) ) break;
+            heap_[pos] = heap_[parent];
+            position(heap_[pos].index) = pos;
+            pos = parent;
+        }
+        heap_[pos] = node;
+        position(node.index) = pos;
+    }
+
+    template <unsigned D>
+    void IndexedHeap<D>::siftDown(size_t pos) {
+        const size_t n = heap_.size();
+        const Node node = heap_[pos];
+        while ( true ) {
+            const size_t first = pos * D + 1;
+            if ( first >= n ) break;
+
+            const size_t last = first + D < n ? first + D : n;
+            size_t best = first;
+            for ( size_t c = first + 1; c < last; ++c )
+                if ( heap_[best].priority < heap_[c].priority ) best = c;
+
+            if ( !(node.priority < heap_[best].priority) ) break;
+            heap_[pos] = heap_[best];
+            position(heap_[pos].index) = pos;
+            pos = best;
+        }
+        heap_[pos] = node;
+        position(node.index) = pos;
+    }
+}
+
+#endif
@@ -0,0 +1,321 @@
+#ifndef AI_TOOLBOX_MDP_ACCELERATED_VALUE_ITERATION_HEADER_FILE
+#define AI_TOOLBOX_MDP_ACCELERATED_VALUE_ITERATION_HEADER_FILE
+
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <cassert>
+
+#include <Eigen/QR>
+
+#include <AIToolbox/Utils.hpp>
+#include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
+#include <AIToolbox/MDP/Algorithms/Utils/ValueIterationParameters.hpp>
+
+namespace AIToolbox {
+    namespace MDP {
+
+#ifndef DOXYGEN_SKIP
+        // This is done to avoid bringing around the enable_if everywhere.
+        template <typename M, typename = typename std::enable_if<is_model_eigen<M>::value>::type>
+        class AcceleratedValueIteration;
+#endif
+
+        /**
+         * @brief This class applies value iteration with over-relaxation and Anderson acceleration on a Model.
+         *
+         * With high discounts, ValueIteration spends most of its time in a
+         * long geometric tail, where the greedy policy does not change
+         * anymore and each iteration only shrinks the error by the
+         * discount. This class extrapolates from the previous iterations
+         * in order to shorten this tail.
+         *
+         * Given the current values V and their Bellman backup T(V), the
+         * next values are computed as
+         *
+         *     V + omega * (T(V) - V)
+         *
+         * where omega is the relaxation parameter; values of omega greater
+         * than 1 over-relax the update. Additionally, Anderson acceleration
+         * can be enabled with a memory of m iterations: the next values
+         * are then extrapolated from the combination of the last m+1
+         * iterates whose residuals T(V) - V cancel out the most, in the
+         * least squares sense. With omega equal to 1 and no memory, this
+         * algorithm is the same as ValueIteration.
+         *
+         * Extrapolated values may be worse than a plain backup. After each
+         * extrapolation, its largest residual is compared to the previous
+         * one: if it did not decrease, the extrapolated values are
+         * discarded and a plain backup is done instead. The memory is not
+         * cleared, as it only records the steps actually taken, so the
+         * plain backups keep feeding it. The following extrapolations are
+         * then paused for a number of plain backups which starts at 1,
+         * doubles with each consecutive rejection up to 1024, and resets
+         * to 1 after a successful extrapolation.
+         *
+         * The epsilon and horizon parameters have the same meaning as in
+         * ValueIteration: the algorithm stops when the largest change
+         * between some values and their backup is within epsilon, or when
+         * the number of Bellman backups performed reaches the horizon.
+         *
+         * @tparam M The type of model that is solved by the algorithm.
+         */
+        template <typename M>
+        class AcceleratedValueIteration<M> : public ValueIterationParameters {
+            public:
+                /**
+                 * @brief Basic constructor.
+                 *
+                 * The epsilon parameter must be >= 0.0, otherwise the
+                 * constructor will throw an std::invalid_argument. The
+                 * epsilon parameter sets the convergence criterion. An
+                 * epsilon of 0.0 forces the algorithm to perform a number
+                 * of iterations equal to the horizon specified.
+                 *
+                 * The relaxation parameter must be in (0,2), otherwise the
+                 * constructor will throw an std::invalid_argument.
+                 *
+                 * Note that the default value function size needs to match
+                 * the number of states of the Model. Otherwise it will
+                 * be ignored. An empty value function will be defaulted
+                 * to all zeroes.
+                 *
+                 * @param horizon The maximum number of iterations to perform.
+                 * @param epsilon The epsilon factor to stop the value iteration loop.
+                 * @param omega The relaxation parameter.
+                 * @param memory The number of past iterations used by Anderson acceleration, 0 to disable it.
+                 * @param v The initial value function from which to start the loop.
+                 */
+                AcceleratedValueIteration(unsigned horizon, double epsilon = 0.001, double omega = 1.0, unsigned memory = 5, ValueFunction v = ValueFunction(Values(), Actions(0)));
+
+                /**
+                 * @brief This function applies accelerated value iteration on an MDP to solve it.
+                 *
+                 * The algorithm is constrained by the currently set parameters.
+                 *
+                 * @param m The MDP that needs to be solved.
+                 * @return A tuple containing a boolean value specifying whether
+                 *         the specified epsilon bound was reached and the
+                 *         ValueFunction and the QFunction for the Model.
+                 */
+                std::tuple<bool, ValueFunction, QFunction> operator()(const M & m);
+
+                /**
+                 * @brief This function sets the relaxation parameter.
+                 *
+                 * The relaxation parameter must be in (0,2), otherwise the
+                 * function will throw an std::invalid_argument.
+                 *
+                 * @param omega The new relaxation parameter.
+                 */
+                void setRelaxation(double omega);
+
+                /**
+                 * @brief This function sets the memory of Anderson acceleration.
+                 *
+                 * @param m The new number of past iterations used, 0 to disable Anderson acceleration.
+                 */
+                void setMemory(unsigned m);
+
+                /**
+                 * @brief This function will return the currently set relaxation parameter.
+                 *
+                 * @return The currently set relaxation parameter.
+                 */
+                double getRelaxation() const;
+
+                /**
+                 * @brief This function will return the currently set memory of Anderson acceleration.
+                 *
+                 * @return The currently set memory.
+                 */
+                unsigned getMemory() const;
+
+                /**
+                 * @brief This function returns the number of iterations performed by the last call to operator().
+                 *
+                 * Each iteration is a Bellman backup of all states,
+                 * including the ones which were discarded.
+                 *
+                 * @return The number of iterations of the last solve.
+                 */
+                unsigned getIterations() const;
+
+                /**
+                 * @brief This function returns the number of extrapolations discarded by the last call to operator().
+                 *
+                 * @return The number of discarded extrapolations.
+                 */
+                unsigned getRejections() const;
+
+            private:
+                // Anderson acceleration solves a least squares problem,
+                // which is easier on column-major storage.
+                using History = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+
+                // Parameters
+                double discount_, omega_;
+                unsigned memory_;
+
+                // Internals
+                size_t S, A;
+                unsigned iterations_, rejections_;
+
+                // Buffer for the matrix-vector products, so that no
+                // memory is allocated while iterating.
+                Vector tmp_;
+
+                /**
+                 * @brief This function computes the backup of some values.
+                 *
+                 * @param m The MDP that needs to be solved.
+                 * @param ir The immediate rewards of the model.
+                 * @param values The values to back up.
+                 * @param q The output QFunction.
+                 * @param backup The output backed up values.
+                 * @param actions The output greedy actions.
+                 *
+                 * @return The largest change between the values and their backup.
+                 */
+                double bellmanOperator(const M & model, const QFunction & ir, const Values & values, QFunction * q, Values * backup, Actions * actions);
+        };
+
+        template <typename M>
+        AcceleratedValueIteration<M>::AcceleratedValueIteration(unsigned horizon, double epsilon, double omega, unsigned memory, ValueFunction v) :
+            ValueIterationParameters(horizon, epsilon, std::move(v)),
+            memory_(memory), S(0), A(0), iterations_(0), rejections_(0)
+        {
+            setRelaxation(omega);
+        }
+
+        template <typename M>
+        std::tuple<bool, ValueFunction, QFunction> AcceleratedValueIteration<M>::operator()(const M & model) {
+            // Extract necessary knowledge from model so we don't have to pass it around
+            S = model.getS();
+            A = model.getA();
+            discount_ = model.getDiscount();
+            tmp_.resize(S);
+
+            ValueFunction v1 = makeStartingValueFunction(vParameter_, S, "AcceleratedValueIteration::solve()");
+            auto & backup  = std::get<VALUES>(v1);
+            auto & actions = std::get<ACTIONS>(v1);
+
+            const auto ir = computeImmediateRewards(model);
+            QFunction q = makeQFunction(S, A);
+
+            double variation = epsilon_ * 2; // Make it bigger
+            iterations_ = rejections_ = 0;
+            if ( horizon_ == 0 )
+                return std::make_tuple(variation <= epsilon_, v1, q);
+
+            // The differences between consecutive values and residuals,
+            // stored in a ring buffer.
+            History dValues(S, memory_), dResiduals(S, memory_);
+            unsigned stored = 0, next = 0;
+            // After each failed extrapolation we do exponentially more
+            // plain backups before trying again.
+            unsigned wait = 0, backoff = 1;
+
+            Values values = backup;
+            double residual = bellmanOperator(model, ir, values, &q, &backup, &actions);
+            ++iterations_;
+
+            bool useEpsilon = checkDifferentSmall(epsilon_, 0.0);
+            Values newValues(S), newBackup(S);
+            QFunction newQ = makeQFunction(S, A);
+            Actions newActions(S);
+            while ( iterations_ < horizon_ && (!useEpsilon || residual > epsilon_) ) {
+                const Vector f = backup - values;
+                const bool extrapolated = !wait && (stored || omega_ != 1.0);
+
+                if ( !extrapolated ) {
+                    if ( wait ) --wait;
+                    newValues = backup;
+                } else if ( stored ) {
+                    const Vector gamma = dResiduals.leftCols(stored).colPivHouseholderQr().solve(f);
+                    newValues = values - dValues.leftCols(stored) * gamma + omega_ * (f - dResiduals.leftCols(stored) * gamma);
+                } else
+                    newValues = values + omega_ * f;
+
+                double newResidual = bellmanOperator(model, ir, newValues, &newQ, &newBackup, &newActions);
+                ++iterations_;
+
+                if ( extrapolated && newResidual >= residual && iterations_ < horizon_ ) {
+                    // The extrapolation did not help, so we fall back to a
+                    // plain backup, which is always a contraction.
+                    ++rejections_;
+                    wait = backoff;
+                    backoff = std::min(2 * backoff, 1024u);
+                    newValues = backup;
+                    newResidual = bellmanOperator(model, ir, newValues, &newQ, &newBackup, &newActions);
+                    ++iterations_;
+                } else if ( extrapolated )
+                    backoff = 1;
+                // The memory keeps the steps actually taken.
+                if ( memory_ ) {
+                    dValues.col(next) = newValues - values;
+                    dResiduals.col(next) = (newBackup - newValues) - f;
+                    next = (next + 1) % memory_;
+                    stored = std::min(stored + 1, memory_);
+                }
+
+                values.swap(newValues);
+                backup.swap(newBackup);
+                q.swap(newQ);
+                actions.swap(newActions);
+                residual = newResidual;
+            }
+            // We do this only if the epsilon specified is positive, otherwise we
+            // continue for all the timesteps.
+            if ( useEpsilon )
+                variation = residual;
+
+            // We do not guarantee that the Value/QFunctions are the perfect ones, as we stop as within epsilon.
+            return std::make_tuple(variation <= epsilon_, v1, q);
+        }
+
+        template <typename M>
+        double AcceleratedValueIteration<M>::bellmanOperator(const M & model, const QFunction & ir, const Values & values, QFunction * q, Values * backup, Actions * actions) {
+            assert(q && backup && actions);
+            for ( size_t a = 0; a < A; ++a ) {
+                tmp_.noalias() = model.getTransitionFunction(a) * values;
+                q->col(a) = ir.col(a) + discount_ * tmp_;
+            }
+
+            double variation = 0.0;
+            for ( size_t s = 0; s < S; ++s ) {
+                (*backup)(s) = q->row(s).maxCoeff(&(*actions)[s]);
+                variation = std::max(variation, static_cast<double>(std::fabs((*backup)(s) - values(s))));
+            }
+            return variation;
+        }
+
+        template <typename M>
+        void AcceleratedValueIteration<M>::setRelaxation(double omega) {
+            if ( omega <= 0.0 || omega >= 2.0 ) throw std::invalid_argument("Relaxation must be in (0,2)");
+            omega_ = omega;
+        }
+
+        template <typename M>
+        void AcceleratedValueIteration<M>::setMemory(unsigned m) {
+            memory_ = m;
+        }
+
+        template <typename M>
+        double AcceleratedValueIteration<M>::getRelaxation() const { return omega_; }
+
+        template <typename M>
+        unsigned AcceleratedValueIteration<M>::getMemory() const { return memory_; }
+
+        template <typename M>
+        unsigned AcceleratedValueIteration<M>::getIterations() const { return iterations_; }
+
+        template <typename M>
+        unsigned AcceleratedValueIteration<M>::getRejections() const { return rejections_; }
+    }
+}
+
+#endif
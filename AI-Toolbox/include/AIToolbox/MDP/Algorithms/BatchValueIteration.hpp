@@ -0,0 +1,249 @@
+#ifndef AI_TOOLBOX_MDP_BATCH_VALUE_ITERATION_HEADER_FILE
+#define AI_TOOLBOX_MDP_BATCH_VALUE_ITERATION_HEADER_FILE
+
+#include <tuple>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include <cmath>
+
+#include <AIToolbox/Utils.hpp>
+#include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
+#include <AIToolbox/MDP/Algorithms/Utils/ValueIterationParameters.hpp>
+
+namespace AIToolbox {
+    namespace MDP {
+
+#ifndef DOXYGEN_SKIP
+        // This is done to avoid bringing around the enable_if everywhere.
+        template <typename M, typename = typename std::enable_if<is_model_eigen<M>::value>::type>
+        class BatchValueIteration;
+#endif
+
+        /**
+         * @brief This class applies value iteration to many variants of the same Model at once.
+         *
+         * It is common to solve the same transition structure under many
+         * different reward functions and discounts. Solving each variant
+         * with ValueIteration reads the whole transition function once
+         * per iteration per variant, and each of these reads is a
+         * matrix-vector product, which is limited by memory bandwidth.
+         *
+         * This class instead stores the values of all K variants as the
+         * columns of a single S x K matrix, so that each iteration reads
+         * the transition function only once, with a matrix-matrix product
+         * per action. Each variant is then backed up with its own rewards
+         * and discount, and checked for convergence on its own. Variants
+         * which converge are removed from the batch, so that the others
+         * do not pay for them.
+         *
+         * The results for each variant are the same that ValueIteration
+         * would produce when solving the Model with its rewards and
+         * discount. All variants start from the same value function.
+         *
+         * @tparam M The type of model that is solved by the algorithm.
+         */
+        template <typename M>
+        class BatchValueIteration<M> : public ValueIterationParameters {
+            public:
+                using Results = std::vector<std::tuple<bool, ValueFunction, QFunction>>;
+
+                /**
+                 * @brief Basic constructor.
+                 *
+                 * The epsilon parameter must be >= 0.0, otherwise the
+                 * constructor will throw an std::invalid_argument. The
+                 * epsilon parameter sets the convergence criterion of each
+                 * variant. An epsilon of 0.0 forces the algorithm to
+                 * perform a number of iterations equal to the horizon
+                 * specified.
+                 *
+                 * Note that the default value function size needs to match
+                 * the number of states of the Model. Otherwise it will
+                 * be ignored. An empty value function will be defaulted
+                 * to all zeroes.
+                 *
+                 * @param horizon The maximum number of iterations to perform.
+                 * @param epsilon The epsilon factor to stop the value iteration loop.
+                 * @param v The initial value function from which each variant starts the loop.
+                 */
+                BatchValueIteration(unsigned horizon, double epsilon = 0.001, ValueFunction v = ValueFunction(Values(), Actions(0)));
+
+                /**
+                 * @brief This function applies value iteration on many variants of an MDP.
+                 *
+                 * Each variant is defined by the expected reward of each
+                 * state action pair (see computeImmediateRewards()) and by
+                 * a discount. The transition function is taken from the
+                 * Model, while its rewards and discount are ignored.
+                 *
+                 * This function throws std::invalid_argument if the number
+                 * of reward functions and discounts differ, if any reward
+                 * function does not have size S x A, or if any discount is
+                 * not in (0,1].
+                 *
+                 * @param m The MDP whose transition function is used.
+                 * @param rewards The expected rewards of each variant.
+                 * @param discounts The discount of each variant.
+                 *
+                 * @return For each variant, a tuple containing a boolean
+                 *         value specifying whether the specified epsilon
+                 *         bound was reached and the ValueFunction and the
+                 *         QFunction for that variant.
+                 */
+                Results operator()(const M & m, const std::vector<QFunction> & rewards, const std::vector<double> & discounts);
+
+                /**
+                 * @brief This function returns the number of iterations performed on each variant by the last call to operator().
+                 *
+                 * @return The number of iterations of each variant.
+                 */
+                const std::vector<unsigned> & getIterations() const;
+
+            private:
+                // Rows are contiguous, so that the products with sparse
+                // transition matrices read all variants of a state at once.
+                using Batch = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+                using ActionBatch = Eigen::Matrix<size_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+                // Internals
+                std::vector<unsigned> iterations_;
+        };
+
+        template <typename M>
+        BatchValueIteration<M>::BatchValueIteration(unsigned horizon, double epsilon, ValueFunction v) :
+            ValueIterationParameters(horizon, epsilon, std::move(v)) {}
+
+        template <typename M>
+        typename BatchValueIteration<M>::Results BatchValueIteration<M>::operator()(const M & model, const std::vector<QFunction> & rewards, const std::vector<double> & discounts) {
+            const size_t S = model.getS(), A = model.getA(), K = rewards.size();
+
+            if ( discounts.size() != K ) throw std::invalid_argument("There must be a discount for each reward function");
+            for ( size_t k = 0; k < K; ++k ) {
+                if ( static_cast<size_t>(rewards[k].rows()) != S || static_cast<size_t>(rewards[k].cols()) != A )
+                    throw std::invalid_argument("Reward functions must have size S x A");
+                if ( discounts[k] <= 0.0 || discounts[k] > 1.0 )
+                    throw std::invalid_argument("Discounts must be in (0,1]");
+            }
+
+            const ValueFunction start = makeStartingValueFunction(vParameter_, S, "BatchValueIteration::solve()");
+
+            Results results;
+            results.reserve(K);
+            for ( size_t k = 0; k < K; ++k )
+                results.emplace_back(false, start, makeQFunction(S, A));
+
+            iterations_.assign(K, 0);
+            std::vector<double> variations(K, epsilon_ * 2); // Make them bigger
+
+            // Column j of the batches holds the data of variant active[j].
+            std::vector<size_t> active(K);
+            for ( size_t k = 0; k < K; ++k ) active[k] = k;
+
+            std::vector<Batch> ir(A, Batch(S, K));
+            for ( size_t a = 0; a < A; ++a )
+                for ( size_t k = 0; k < K; ++k )
+                    ir[a].col(k) = rewards[k].col(a);
+            Eigen::Array<Scalar, 1, Eigen::Dynamic> discount(K);
+            for ( size_t k = 0; k < K; ++k ) discount(k) = discounts[k];
+
+            Batch values = std::get<VALUES>(start).replicate(1, K), newValues(S, K), tmp(S, K);
+            ActionBatch best(S, K);
+            Eigen::Array<Scalar, 1, Eigen::Dynamic> variation(K);
+
+            // The QFunction of a variant is only needed for its last
+            // iteration, so we compute it from its previous values.
+            auto store = [&](size_t j, const Batch & oldValues) {
+                const size_t k = active[j];
+                auto & q = std::get<2>(results[k]);
+                for ( size_t a = 0; a < A; ++a ) {
+                    Vector t = model.getTransitionFunction(a) * oldValues.col(j);
+                    q.col(a) = rewards[k].col(a) + discounts[k] * t;
+                }
+                std::get<VALUES>(std::get<1>(results[k])) = newValues.col(j);
+                auto & actions = std::get<ACTIONS>(std::get<1>(results[k]));
+                for ( size_t s = 0; s < S; ++s ) actions[s] = best(s, j);
+            };
+
+            bool useEpsilon = checkDifferentSmall(epsilon_, 0.0);
+            for ( unsigned timestep = 0; timestep < horizon_ && active.size(); ++timestep ) {
+                const size_t n = active.size();
+
+                // A single pass over each transition matrix serves all
+                // variants. We keep a running maximum over the actions, so
+                // that no per-variant QFunction needs to be written, and
+                // all batches are walked one contiguous row at a time.
+                for ( size_t a = 0; a < A; ++a ) {
+                    tmp.noalias() = model.getTransitionFunction(a) * values;
+                    for ( size_t s = 0; s < S; ++s ) {
+                        tmp.row(s) = ir[a].row(s).array() + discount * tmp.row(s).array();
+                        if ( a == 0 ) {
+                            newValues.row(s) = tmp.row(s);
+                            best.row(s).setZero();
+                            continue;
+                        }
+                        // Strict comparisons pick the first best action, as maxCoeff does.
+                        for ( size_t j = 0; j < n; ++j ) {
+                            if ( tmp(s, j) > newValues(s, j) ) {
+                                newValues(s, j) = tmp(s, j);
+                                best(s, j) = a;
+                            }
+                        }
+                    }
+                }
+
+                variation.setZero();
+                for ( size_t s = 0; s < S; ++s )
+                    variation = variation.max((newValues.row(s) - values.row(s)).array().abs());
+
+                // Converged variants are stored and removed from the batch.
+                std::vector<size_t> kept;
+                for ( size_t j = 0; j < n; ++j ) {
+                    const size_t k = active[j];
+                    ++iterations_[k];
+                    // We do this only if the epsilon specified is positive, otherwise we
+                    // continue for all the timesteps.
+                    if ( useEpsilon )
+                        variations[k] = variation(j);
+
+                    if ( (useEpsilon && variations[k] <= epsilon_) || timestep + 1 == horizon_ )
+                        store(j, values);
+                    else
+                        kept.push_back(j);
+                }
+                values.swap(newValues);
+                if ( kept.size() == n ) continue;
+
+                const size_t m = kept.size();
+                for ( size_t j = 0; j < m; ++j ) {
+                    const size_t from = kept[j];
+                    active[j] = active[from];
+                    if ( from == j ) continue;
+                    values.col(j) = values.col(from);
+                    discount(j) = discount(from);
+                    for ( auto & r : ir ) r.col(j) = r.col(from);
+                }
+                active.resize(m);
+                values.conservativeResize(S, m);
+                discount.conservativeResize(m);
+                for ( auto & r : ir ) r.conservativeResize(S, m);
+                newValues.resize(S, m);
+                tmp.resize(S, m);
+                best.resize(S, m);
+                variation.resize(m);
+            }
+
+            // We do not guarantee that the Value/QFunctions are the perfect ones, as we stop as within epsilon.
+            for ( size_t k = 0; k < K; ++k )
+                std::get<0>(results[k]) = variations[k] <= epsilon_;
+
+            return results;
+        }
+
+        template <typename M>
+        const std::vector<unsigned> & BatchValueIteration<M>::getIterations() const { return iterations_; }
+    }
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define AI_TOOLBOX_MDP_DYNAQ_HEADER_FILE
 
 #include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
 #include <AIToolbox/MDP/Algorithms/QLearning.hpp>
 #include <AIToolbox/Impl/Seeder.hpp>
 
@@ -139,7 +140,7 @@ namespace AIToolbox {
                 std::vector<std::pair<size_t,size_t>> visitedStatesActionsSampler_;
 
                 // Stuff for batch update
-                mutable std::default_random_engine rand_;
+                mutable RandomEngine rand_;
         };
 
         template <typename M>
@@ -169,7 +170,7 @@ namespace AIToolbox {
                 // O(1) sampling...
                 std::tie(s,a) = visitedStatesActionsSampler_[sampleDistribution_(rand_)];
 
-                std::tie(s1, rew) = model_.sample(s, a);
+                std::tie(s1, rew) = sampleSR(model_, s, a, rand_);
                 qLearning_.stepUpdateQ(s, s1, a, rew);
             }
         }
@@ -0,0 +1,179 @@
+#ifndef AI_TOOLBOX_MDP_FINITE_HORIZON_VALUE_ITERATION_HEADER_FILE
+#define AI_TOOLBOX_MDP_FINITE_HORIZON_VALUE_ITERATION_HEADER_FILE
+
+#include <tuple>
+#include <utility>
+
+#include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
+#include <AIToolbox/MDP/Algorithms/Utils/ValueIterationParameters.hpp>
+#include <AIToolbox/MDP/Policies/FiniteHorizonPolicy.hpp>
+
+namespace AIToolbox {
+    namespace MDP {
+
+#ifndef DOXYGEN_SKIP
+        // This is done to avoid bringing around the enable_if everywhere.
+        template <typename M, typename = typename std::enable_if<is_model_eigen<M>::value>::type>
+        class FiniteHorizonValueIteration;
+#endif
+
+        /**
+         * @brief This class solves a Model for a finite horizon, keeping the policy of every timestep.
+         *
+         * ValueIteration with a finite horizon only returns the
+         * ValueFunction of its last iteration. When an episode really
+         * lasts a fixed number of timesteps, the best action also depends
+         * on how many timesteps are missing, and so the policy of each
+         * horizon is needed.
+         *
+         * This class computes the ValueFunction backwards in time, from
+         * horizon 1 up to the requested horizon, and hands the greedy
+         * actions of each horizon to a callback as soon as they are
+         * computed. Only the current ValueFunction is kept, so the memory
+         * used does not depend on the horizon. The callback can store the
+         * actions in a FiniteHorizonPolicy, which is what the simpler
+         * overload of operator() does, or write them to a file through a
+         * FiniteHorizonPolicyWriter.
+         *
+         * @tparam M The type of model that is solved by the algorithm.
+         */
+        template <typename M>
+        class FiniteHorizonValueIteration<M> {
+            public:
+                /**
+                 * @brief Basic constructor.
+                 *
+                 * The starting value function contains the values obtained
+                 * at the end of the episode (horizon 0); an empty value
+                 * function defaults to all zeroes. Note that its size
+                 * needs to match the number of states of the Model.
+                 * Otherwise it will be ignored.
+                 *
+                 * @param horizon The number of timesteps of the episode.
+                 * @param v The values at the end of the episode.
+                 */
+                FiniteHorizonValueIteration(unsigned horizon, ValueFunction v = ValueFunction(Values(), Actions(0)));
+
+                /**
+                 * @brief This function solves an MDP, passing the actions of each horizon to a callback.
+                 *
+                 * The callback is called once per horizon, from 1 to the
+                 * set horizon, with the signature:
+                 *
+                 * ~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+                 * void callback(unsigned horizon, const Actions & actions);
+                 * ~~~~~~~~~~~~~~~~~~~~~~~
+                 *
+                 * @param m The MDP that needs to be solved.
+                 * @param callback The function receiving the actions of each horizon.
+                 *
+                 * @return The ValueFunction of the set horizon.
+                 */
+                template <typename F>
+                ValueFunction operator()(const M & m, F callback);
+
+                /**
+                 * @brief This function solves an MDP.
+                 *
+                 * @param m The MDP that needs to be solved.
+                 *
+                 * @return A tuple containing the Policy for all horizons
+                 *         and the ValueFunction of the set horizon.
+                 */
+                std::tuple<FiniteHorizonPolicy, ValueFunction> operator()(const M & m);
+
+                /**
+                 * @brief This function sets the horizon parameter.
+                 *
+                 * @param h The new horizon parameter.
+                 */
+                void setHorizon(unsigned h);
+
+                /**
+                 * @brief This function sets the values at the end of the episode.
+                 *
+                 * An empty value function defaults to all zeroes. Note
+                 * that its size needs to match the number of states of the
+                 * Model that needs to be solved. Otherwise it will be
+                 * ignored.
+                 *
+                 * @param v The new values at the end of the episode.
+                 */
+                void setValueFunction(ValueFunction v);
+
+                /**
+                 * @brief This function will return the current horizon parameter.
+                 *
+                 * @return The currently set horizon parameter.
+                 */
+                unsigned getHorizon() const;
+
+                /**
+                 * @brief This function will return the values at the end of the episode.
+                 *
+                 * @return The currently set starting value function.
+                 */
+                const ValueFunction & getValueFunction() const;
+
+            private:
+                unsigned horizon_;
+                ValueFunction vParameter_;
+        };
+
+        template <typename M>
+        FiniteHorizonValueIteration<M>::FiniteHorizonValueIteration(unsigned horizon, ValueFunction v) :
+            horizon_(horizon), vParameter_(std::move(v)) {}
+
+        template <typename M>
+        template <typename F>
+        ValueFunction FiniteHorizonValueIteration<M>::operator()(const M & model, F callback) {
+            const size_t S = model.getS(), A = model.getA();
+
+            ValueFunction v = makeStartingValueFunction(vParameter_, S, "FiniteHorizonValueIteration");
+
+            auto & values = std::get<VALUES>(v);
+            auto & actions = std::get<ACTIONS>(v);
+
+            const auto ir = computeImmediateRewards(model);
+            QFunction q = makeQFunction(S, A);
+
+            for ( unsigned h = 1; h <= horizon_; ++h ) {
+                for ( size_t a = 0; a < A; ++a )
+                    q.col(a).noalias() = ir.col(a) + model.getDiscount() * (model.getTransitionFunction(a) * values);
+                for ( size_t s = 0; s < S; ++s )
+                    values(s) = q.row(s).maxCoeff(&actions[s]);
+
+                callback(h, static_cast<const Actions &>(actions));
+            }
+            return v;
+        }
+
+        template <typename M>
+        std::tuple<FiniteHorizonPolicy, ValueFunction> FiniteHorizonValueIteration<M>::operator()(const M & model) {
+            FiniteHorizonPolicy policy(model.getS(), model.getA());
+            auto v = (*this)(model, [&policy](unsigned, const Actions & actions) {
+                policy.pushStep(actions);
+            });
+            return std::make_tuple(std::move(policy), std::move(v));
+        }
+
+        template <typename M>
+        void FiniteHorizonValueIteration<M>::setHorizon(unsigned h) {
+            horizon_ = h;
+        }
+
+        template <typename M>
+        void FiniteHorizonValueIteration<M>::setValueFunction(ValueFunction v) {
+            vParameter_ = std::move(v);
+        }
+
+        template <typename M>
+        unsigned FiniteHorizonValueIteration<M>::getHorizon() const { return horizon_; }
+
+        template <typename M>
+        const ValueFunction & FiniteHorizonValueIteration<M>::getValueFunction() const { return vParameter_; }
+    }
+}
+
+#endif
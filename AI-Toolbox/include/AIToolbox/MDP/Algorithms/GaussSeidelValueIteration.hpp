@@ -0,0 +1,225 @@
+#ifndef AI_TOOLBOX_MDP_GAUSS_SEIDEL_VALUE_ITERATION_HEADER_FILE
+#define AI_TOOLBOX_MDP_GAUSS_SEIDEL_VALUE_ITERATION_HEADER_FILE
+
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include <cmath>
+
+#include <AIToolbox/Utils.hpp>
+#include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
+#include <AIToolbox/MDP/Algorithms/Utils/ValueIterationParameters.hpp>
+#include <AIToolbox/MDP/Algorithms/Utils/StateGraph.hpp>
+
+namespace AIToolbox {
+    namespace MDP {
+        /**
+         * @brief This enum represents the orders in which GaussSeidelValueIteration can update the states.
+         */
+        enum StateOrdering {
+            // States are updated from 0 to S-1.
+            NATURAL,
+            // States are updated from S-1 to 0.
+            REVERSE,
+            // States are updated after the states they can transition to, as far as cycles allow (see StateGraph).
+            REVERSE_TOPOLOGICAL,
+            // States are updated by decreasing change in value during the previous sweep.
+            RESIDUAL
+        };
+
+#ifndef DOXYGEN_SKIP
+        // This is done to avoid bringing around the enable_if everywhere.
+        template <typename M, typename = typename std::enable_if<is_model_eigen<M>::value>::type>
+        class GaussSeidelValueIteration;
+#endif
+
+        /**
+         * @brief This class applies the Gauss-Seidel value iteration algorithm on a Model.
+         *
+         * This algorithm is a variant of ValueIteration which updates the
+         * ValueFunction in place. Where ValueIteration computes the new
+         * values of all states from the values of the previous iteration,
+         * here each state is backed up using the values that have already
+         * been updated during the current sweep. Information thus
+         * propagates through many states within a single sweep, which can
+         * greatly reduce the number of sweeps needed to converge,
+         * especially for problems with high discounts.
+         *
+         * How much faster information propagates depends on the order in
+         * which the states are updated. For goal-directed problems, the
+         * REVERSE_TOPOLOGICAL ordering updates states after their
+         * successors, which follows the flow of values backwards from the
+         * goals. The RESIDUAL ordering instead updates first the states
+         * whose values changed the most during the previous sweep.
+         *
+         * Convergence is checked in the same way as in ValueIteration: the
+         * algorithm stops when the largest change of a value during a
+         * sweep is within epsilon, or when the horizon is reached. Note
+         * that since the values are updated in place, the number of sweeps
+         * performed does not correspond to a finite horizon anymore.
+         *
+         * @tparam M The type of model that is solved by the algorithm.
+         */
+        template <typename M>
+        class GaussSeidelValueIteration<M> : public ValueIterationParameters {
+            public:
+                /**
+                 * @brief Basic constructor.
+                 *
+                 * The epsilon parameter must be >= 0.0, otherwise the
+                 * constructor will throw an std::invalid_argument. The
+                 * epsilon parameter sets the convergence criterion. An
+                 * epsilon of 0.0 forces the algorithm to perform a number
+                 * of sweeps equal to the horizon specified.
+                 *
+                 * Note that the default value function size needs to match
+                 * the number of states of the Model. Otherwise it will
+                 * be ignored. An empty value function will be defaulted
+                 * to all zeroes.
+                 *
+                 * @param horizon The maximum number of sweeps to perform.
+                 * @param epsilon The epsilon factor to stop the value iteration loop.
+                 * @param ordering The order in which states are updated.
+                 * @param v The initial value function from which to start the loop.
+                 */
+                GaussSeidelValueIteration(unsigned horizon, double epsilon = 0.001, StateOrdering ordering = NATURAL, ValueFunction v = ValueFunction(Values(), Actions(0)));
+
+                /**
+                 * @brief This function applies Gauss-Seidel value iteration on an MDP to solve it.
+                 *
+                 * The algorithm is constrained by the currently set parameters.
+                 *
+                 * @param m The MDP that needs to be solved.
+                 * @return A tuple containing a boolean value specifying whether
+                 *         the specified epsilon bound was reached and the
+                 *         ValueFunction and the QFunction for the Model.
+                 */
+                std::tuple<bool, ValueFunction, QFunction> operator()(const M & m);
+
+                /**
+                 * @brief This function sets the order in which states are updated.
+                 *
+                 * @param o The new state ordering.
+                 */
+                void setOrdering(StateOrdering o);
+
+                /**
+                 * @brief This function will return the current state ordering.
+                 *
+                 * @return The currently set state ordering.
+                 */
+                StateOrdering getOrdering() const;
+
+                /**
+                 * @brief This function returns the number of sweeps performed by the last call to operator().
+                 *
+                 * @return The number of sweeps of the last solve.
+                 */
+                unsigned getSweeps() const;
+
+            private:
+                // Parameters
+                double discount_;
+                unsigned sweeps_;
+                StateOrdering ordering_;
+
+                // Internals
+                size_t S, A;
+
+                /**
+                 * @brief This function computes the order of the first sweep.
+                 *
+                 * @param m The MDP that needs to be solved.
+                 *
+                 * @return The states, in the order in which they should be updated.
+                 */
+                std::vector<size_t> computeOrder(const M & model) const;
+        };
+
+        template <typename M>
+        GaussSeidelValueIteration<M>::GaussSeidelValueIteration(unsigned horizon, double epsilon, StateOrdering ordering, ValueFunction v) :
+            ValueIterationParameters(horizon, epsilon, std::move(v)),
+            sweeps_(0), ordering_(ordering), S(0), A(0) {}
+
+        template <typename M>
+        std::tuple<bool, ValueFunction, QFunction> GaussSeidelValueIteration<M>::operator()(const M & model) {
+            // Extract necessary knowledge from model so we don't have to pass it around
+            S = model.getS();
+            A = model.getA();
+            discount_ = model.getDiscount();
+
+            ValueFunction v1 = makeStartingValueFunction(vParameter_, S, "GaussSeidelValueIteration::solve()");
+            auto & values  = std::get<VALUES>(v1);
+            auto & actions = std::get<ACTIONS>(v1);
+
+            const auto ir = computeImmediateRewards(model);
+            QFunction q = makeQFunction(S, A);
+
+            auto order = computeOrder(model);
+            std::vector<double> residuals(ordering_ == RESIDUAL ? S : 0);
+
+            double variation = epsilon_ * 2; // Make it bigger
+            sweeps_ = 0;
+
+            bool useEpsilon = checkDifferentSmall(epsilon_, 0.0);
+            while ( sweeps_ < horizon_ && (!useEpsilon || variation > epsilon_) ) {
+                ++sweeps_;
+
+                double maxResidual = 0.0;
+                for ( auto s : order ) {
+                    // Each backup reads the values already updated in this sweep.
+                    for ( size_t a = 0; a < A; ++a )
+                        q(s, a) = ir(s, a) + discount_ * model.getTransitionFunction(a).row(s).dot(values);
+
+                    const double old = values(s);
+                    values(s) = q.row(s).maxCoeff(&actions[s]);
+
+                    const double residual = std::fabs(values(s) - old);
+                    maxResidual = std::max(maxResidual, residual);
+                    if ( ordering_ == RESIDUAL ) residuals[s] = residual;
+                }
+
+                if ( ordering_ == RESIDUAL )
+                    std::stable_sort(std::begin(order), std::end(order), [&residuals](size_t lhs, size_t rhs){ return residuals[lhs] > residuals[rhs]; });
+
+                // We do this only if the epsilon specified is positive, otherwise we
+                // continue for all the timesteps.
+                if ( useEpsilon )
+                    variation = maxResidual;
+            }
+
+            // We do not guarantee that the Value/QFunctions are the perfect ones, as we stop as within epsilon.
+            return std::make_tuple(variation <= epsilon_, v1, q);
+        }
+
+        template <typename M>
+        std::vector<size_t> GaussSeidelValueIteration<M>::computeOrder(const M & model) const {
+            std::vector<size_t> order(S);
+            std::iota(std::begin(order), std::end(order), 0);
+
+            if ( ordering_ == REVERSE )
+                std::reverse(std::begin(order), std::end(order));
+
+            if ( ordering_ == REVERSE_TOPOLOGICAL )
+                order = StateGraph(model).getReverseTopologicalOrder();
+
+            return order;
+        }
+
+        template <typename M>
+        void GaussSeidelValueIteration<M>::setOrdering(StateOrdering o) {
+            ordering_ = o;
+        }
+
+        template <typename M>
+        StateOrdering GaussSeidelValueIteration<M>::getOrdering() const { return ordering_; }
+
+        template <typename M>
+        unsigned GaussSeidelValueIteration<M>::getSweeps() const { return sweeps_; }
+    }
+}
+
+#endif
@@ -0,0 +1,346 @@
+#ifndef AI_TOOLBOX_MDP_INCREMENTAL_VALUE_ITERATION_HEADER_FILE
+#define AI_TOOLBOX_MDP_INCREMENTAL_VALUE_ITERATION_HEADER_FILE
+
+#include <tuple>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <cmath>
+
+#include <boost/heap/fibonacci_heap.hpp>
+
+#include <AIToolbox/Utils.hpp>
+#include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
+#include <AIToolbox/MDP/Algorithms/Utils/ValueIterationParameters.hpp>
+#include <AIToolbox/MDP/Algorithms/Utils/StateGraph.hpp>
+
+namespace AIToolbox {
+    namespace MDP {
+
+#ifndef DOXYGEN_SKIP
+        // This is done to avoid bringing around the enable_if everywhere.
+        template <typename M, typename = typename std::enable_if<is_model_eigen<M>::value>::type>
+        class IncrementalValueIteration;
+#endif
+
+        /**
+         * @brief This class keeps the solution of a Model up to date after localized changes.
+         *
+         * When only a few state action pairs of a Model change, for example
+         * after an RLModel::sync(s, a) call, most of its ValueFunction is
+         * still correct. Re-running ValueIteration, even from the previous
+         * solution, still backs up all states at every iteration.
+         *
+         * This class instead keeps a solution of the Model, and is told
+         * which state action pairs have changed. Those are backed up first;
+         * then, whenever the value of a state changes, its predecessors are
+         * queued to be backed up, in order of decreasing change. The
+         * propagation stops when no state has changed by more than epsilon
+         * since its predecessors were last updated, so the work done
+         * depends on how far the change spreads, rather than on the size
+         * of the Model.
+         *
+         * The Model is kept by reference, and must be modified in place
+         * between the calls to operator(). Transitions to new states are
+         * supported, as each changed pair is scanned for new predecessors.
+         *
+         * @tparam M The type of model that is solved by the algorithm.
+         */
+        template <typename M>
+        class IncrementalValueIteration<M> {
+            public:
+                using Changes = std::vector<std::pair<size_t, size_t>>;
+
+                /**
+                 * @brief Basic constructor.
+                 *
+                 * The epsilon parameter must be > 0.0, otherwise the
+                 * constructor will throw an std::invalid_argument.
+                 *
+                 * The starting value function is usually the solution of
+                 * the Model, for example from ValueIteration; it is used to
+                 * compute the QFunction, and is then kept up to date.
+                 * Note that its size needs to match the number of states of
+                 * the Model. Otherwise it will be ignored. An empty value
+                 * function will be defaulted to all zeroes.
+                 *
+                 * @param m The Model to keep solved.
+                 * @param epsilon The change in value under which states are not propagated.
+                 * @param v The current solution of the Model.
+                 */
+                IncrementalValueIteration(const M & m, double epsilon = 0.001, ValueFunction v = ValueFunction(Values(), Actions(0)));
+
+                /**
+                 * @brief This function updates the solution after some state action pairs have changed.
+                 *
+                 * The changed pairs are backed up, and their changes in
+                 * value are propagated backwards through the Model.
+                 *
+                 * If a maximum number of backups has been set and it is
+                 * reached, the propagation stops early, and the states still
+                 * to be propagated are kept for the next call.
+                 *
+                 * @param changes The state action pairs whose transitions or rewards have changed.
+                 *
+                 * @return True if no state has a pending change greater than epsilon, false otherwise.
+                 */
+                bool operator()(const Changes & changes);
+
+                /**
+                 * @brief This function sets the epsilon parameter.
+                 *
+                 * The epsilon parameter must be > 0.0, otherwise the
+                 * function will throw an std::invalid_argument.
+                 *
+                 * @param e The new epsilon parameter.
+                 */
+                void setEpsilon(double e);
+
+                /**
+                 * @brief This function sets the maximum number of backups performed by each call to operator().
+                 *
+                 * A value of 0 means no limit. Since all predecessors of a
+                 * state are backed up together, the limit can be exceeded
+                 * by the number of predecessors of the last state.
+                 *
+                 * @param b The new maximum number of backups.
+                 */
+                void setMaxBackups(size_t b);
+
+                /**
+                 * @brief This function will return the currently set epsilon parameter.
+                 *
+                 * @return The currently set epsilon parameter.
+                 */
+                double getEpsilon() const;
+
+                /**
+                 * @brief This function will return the currently set maximum number of backups.
+                 *
+                 * @return The currently set maximum number of backups.
+                 */
+                size_t getMaxBackups() const;
+
+                /**
+                 * @brief This function returns the number of single state backups performed by the last call to operator().
+                 *
+                 * @return The number of backups of the last update.
+                 */
+                size_t getBackups() const;
+
+                /**
+                 * @brief This function returns the number of states whose changes still need to be propagated.
+                 *
+                 * @return The current length of the queue.
+                 */
+                size_t getQueueLength() const;
+
+                /**
+                 * @brief This function returns a reference to the referenced Model.
+                 *
+                 * @return The internal Model.
+                 */
+                const M & getModel() const;
+
+                /**
+                 * @brief This function returns a reference to the internal ValueFunction.
+                 *
+                 * @return The internal ValueFunction.
+                 */
+                const ValueFunction & getValueFunction() const;
+
+                /**
+                 * @brief This function returns a reference to the internal QFunction.
+                 *
+                 * @return The internal QFunction.
+                 */
+                const QFunction & getQFunction() const;
+
+            private:
+                /**
+                 * @brief This function recomputes the QFunction of a state action pair.
+                 *
+                 * @param s The state.
+                 * @param a The action.
+                 */
+                void updateQ(size_t s, size_t a);
+
+                /**
+                 * @brief This function recomputes the value of a state, and queues it if it changed enough.
+                 *
+                 * @param s The state.
+                 */
+                void updateValue(size_t s);
+
+                size_t S, A;
+                double epsilon_;
+                size_t maxBackups_, backups_;
+
+                const M & model_;
+                QFunction ir_, qfun_;
+                ValueFunction vfun_;
+
+                StateGraph graph_;
+                // Predecessors found in changed pairs after the graph was built.
+                std::vector<std::vector<size_t>> newPredecessors_;
+
+                using PriorityQueueElement = std::tuple<double, size_t>;
+                enum {
+                    PRIORITY = 0,
+                    STATE    = 1,
+                };
+
+                class PriorityTupleLess {
+                    public:
+                        bool operator() (const PriorityQueueElement& arg1, const PriorityQueueElement& arg2) const;
+                };
+
+                using QueueType = boost::heap::fibonacci_heap<PriorityQueueElement, boost::heap::compare<PriorityTupleLess>>;
+
+                QueueType queue_;
+
+                // How much each state changed since its predecessors were last updated.
+                std::vector<double> pending_;
+                std::vector<typename QueueType::handle_type> queueHandles_;
+                std::vector<char> queued_;
+        };
+
+        template <typename M>
+        bool IncrementalValueIteration<M>::PriorityTupleLess::operator() (const PriorityQueueElement& arg1, const PriorityQueueElement& arg2) const
+        {
+            return std::get<PRIORITY>(arg1) < std::get<PRIORITY>(arg2);
+        }
+
+        template <typename M>
+        IncrementalValueIteration<M>::IncrementalValueIteration(const M & m, double epsilon, ValueFunction v) :
+            S(m.getS()), A(m.getA()), maxBackups_(0), backups_(0),
+            model_(m), ir_(computeImmediateRewards(m)), qfun_(makeQFunction(S, A)),
+            graph_(m), newPredecessors_(S),
+            pending_(S, 0.0), queueHandles_(S), queued_(S, false)
+        {
+            setEpsilon(epsilon);
+
+            vfun_ = makeStartingValueFunction(v, S, "IncrementalValueIteration");
+
+            const auto & values = std::get<VALUES>(vfun_);
+            auto & actions = std::get<ACTIONS>(vfun_);
+            for ( size_t a = 0; a < A; ++a )
+                qfun_.col(a) = ir_.col(a) + model_.getDiscount() * (model_.getTransitionFunction(a) * values);
+            // We keep the given values, and only pick the best actions.
+            for ( size_t s = 0; s < S; ++s )
+                qfun_.row(s).maxCoeff(&actions[s]);
+        }
+
+        template <typename M>
+        bool IncrementalValueIteration<M>::operator()(const Changes & changes) {
+            backups_ = 0;
+
+            for ( const auto & sa : changes ) {
+                const size_t s = sa.first, a = sa.second;
+                if ( s >= S || a >= A ) throw std::invalid_argument("Changed state action pair is out of range");
+
+                const auto & t = model_.getTransitionFunction(a);
+                ir_(s, a) = computeImmediateReward(model_, s, a);
+
+                forEachNonZero(t, s, [this, s](size_t s1, double) {
+                    if ( s1 == s ) return;
+                    auto p = graph_.getPredecessors(s1);
+                    auto & extra = newPredecessors_[s1];
+                    if ( std::find(p.first, p.second, s) == p.second && std::find(std::begin(extra), std::end(extra), s) == std::end(extra) )
+                        extra.push_back(s);
+                });
+            }
+            for ( const auto & sa : changes )
+                updateQ(sa.first, sa.second);
+            for ( const auto & sa : changes )
+                updateValue(sa.first);
+
+            while ( !queue_.empty() && (!maxBackups_ || backups_ < maxBackups_) ) {
+                // The state we extract has been updated already, so it
+                // is its predecessors that need to be backed up.
+                size_t s1;
+                std::tie(std::ignore, s1) = queue_.top();
+                queue_.pop();
+                queued_[s1] = false;
+                pending_[s1] = 0.0;
+
+                auto backup = [this, s1](size_t s) {
+                    for ( size_t a = 0; a < A; ++a )
+                        if ( checkDifferentSmall(model_.getTransitionFunction(a).coeff(s, s1), 0.0) )
+                            updateQ(s, a);
+                    updateValue(s);
+                };
+                auto p = graph_.getPredecessors(s1);
+                for ( auto it = p.first; it != p.second; ++it )
+                    backup(*it);
+                for ( auto s : newPredecessors_[s1] )
+                    backup(s);
+                // A state can also depend on itself.
+                backup(s1);
+            }
+
+            return queue_.empty();
+        }
+
+        template <typename M>
+        void IncrementalValueIteration<M>::updateQ(size_t s, size_t a) {
+            qfun_(s, a) = ir_(s, a) + model_.getDiscount() * model_.getTransitionFunction(a).row(s).dot(std::get<VALUES>(vfun_));
+        }
+
+        template <typename M>
+        void IncrementalValueIteration<M>::updateValue(size_t s) {
+            auto & values = std::get<VALUES>(vfun_);
+            const double old = values(s);
+            values(s) = qfun_.row(s).maxCoeff(&std::get<ACTIONS>(vfun_)[s]);
+            ++backups_;
+
+            // Small changes are accumulated, so that many of them still
+            // end up being propagated.
+            pending_[s] += std::fabs(values(s) - old);
+            if ( pending_[s] <= epsilon_ ) return;
+
+            if ( queued_[s] )
+                queue_.increase(queueHandles_[s], std::make_tuple(pending_[s], s));
+            else {
+                queueHandles_[s] = queue_.push(std::make_tuple(pending_[s], s));
+                queued_[s] = true;
+            }
+        }
+
+        template <typename M>
+        void IncrementalValueIteration<M>::setEpsilon(double e) {
+            if ( e <= 0.0 ) throw std::invalid_argument("Epsilon must be > 0");
+            epsilon_ = e;
+        }
+
+        template <typename M>
+        void IncrementalValueIteration<M>::setMaxBackups(size_t b) {
+            maxBackups_ = b;
+        }
+
+        template <typename M>
+        double IncrementalValueIteration<M>::getEpsilon() const { return epsilon_; }
+
+        template <typename M>
+        size_t IncrementalValueIteration<M>::getMaxBackups() const { return maxBackups_; }
+
+        template <typename M>
+        size_t IncrementalValueIteration<M>::getBackups() const { return backups_; }
+
+        template <typename M>
+        size_t IncrementalValueIteration<M>::getQueueLength() const { return queue_.size(); }
+
+        template <typename M>
+        const M & IncrementalValueIteration<M>::getModel() const { return model_; }
+
+        template <typename M>
+        const ValueFunction & IncrementalValueIteration<M>::getValueFunction() const { return vfun_; }
+
+        template <typename M>
+        const QFunction & IncrementalValueIteration<M>::getQFunction() const { return qfun_; }
+    }
+}
+
+#endif
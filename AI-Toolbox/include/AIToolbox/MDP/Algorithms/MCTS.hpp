@@ -2,10 +2,23 @@
 #define AI_TOOLBOX_MDP_MCTS_HEADER_FILE
 
 #include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
 #include <AIToolbox/ProbabilityUtils.hpp>
+#include <AIToolbox/SearchTree.hpp>
 #include <AIToolbox/Impl/Seeder.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
 #include <unordered_map>
+#include <vector>
 
 namespace AIToolbox {
     namespace MDP {
@@ -49,27 +62,32 @@ namespace AIToolbox {
          * for the action that has been performed and its respective new state.
          * Then it simply makes that root branch the new root, and starts
          * again.
+         *
+         * The tree is a SearchTree, where the children of each action are
+         * indexed by the sampled state. Its memory is reused between calls
+         * to sampleAction().
+         *
+         * The simulations can also run on multiple threads, which share the
+         * same tree (see setThreads()). Each thread descends the tree on its
+         * own, with its own random engine. While a thread is below an
+         * action, the action counts as visited once more with a lower value
+         * (a virtual loss, see setVirtualLoss()), so that other threads
+         * prefer different paths. The action statistics are kept in atomic
+         * variables during the simulations, and only the lookup and creation
+         * of nodes takes a lock, so that the rollouts and most of the tree
+         * walk run in parallel. With a single thread the algorithm runs the
+         * simulations one after the other exactly as before, so its results
+         * only depend on the seed.
          */
         template <typename M>
         class MCTS<M> {
             public:
                 using SampleBelief = std::vector<size_t>;
 
-                struct StateNode;
-                using StateNodes = std::unordered_map<size_t, StateNode>;
-
-                struct ActionNode {
-                    StateNodes children;
-                    double V = 0.0;
-                    unsigned N = 0;
-                };
-                using ActionNodes = std::vector<ActionNode>;
-
-                struct StateNode {
-                    StateNode() : N(0) {}
-                    ActionNodes children;
-                    unsigned N;
-                };
+                struct StateData {};
+                using Graph = SearchTree<StateData>;
+                using StateNode = typename Graph::Node;
+                using ActionNode = typename Graph::ActionNode;
 
                 /**
                  * @brief Basic constructor.
@@ -130,6 +148,61 @@ namespace AIToolbox {
                  */
                 void setExploration(double exp);
 
+                /**
+                 * @brief This function sets the number of particles used in each rollout.
+                 *
+                 * By default each rollout follows a single trajectory. When
+                 * more particles are used, each rollout advances all of
+                 * them in lockstep from the newly expanded node, each with
+                 * its own random actions, and returns their average
+                 * discounted reward. This reduces the variance of the
+                 * leaf estimates, and allows models which support batch
+                 * sampling to amortize the cost of each step over all
+                 * particles.
+                 *
+                 * Note that this changes the estimator: with k particles
+                 * each leaf value is the mean of k random rollouts, while
+                 * the simulation still counts as a single visit of the
+                 * nodes it went through. The steps of a single trajectory
+                 * depend on each other and cannot be batched, so with the
+                 * default of 1 the batch interface is never used, and
+                 * results are exactly the same as with models which do
+                 * not provide it.
+                 *
+                 * \sa is_generative_model_batch
+                 *
+                 * @param particles The new number of particles, at least 1.
+                 */
+                void setRolloutParticles(unsigned particles);
+
+                /**
+                 * @brief This function sets the number of threads used to run the simulations.
+                 *
+                 * The number of threads must be at least 1, otherwise the
+                 * function will throw an std::invalid_argument. Using more
+                 * than one thread requires a model which can be sampled with
+                 * an external generator, since all threads sample it at the
+                 * same time; otherwise the function will also throw.
+                 *
+                 * \sa is_generative_model_engine
+                 *
+                 * @param threads The new number of threads.
+                 */
+                void setThreads(unsigned threads);
+
+                /**
+                 * @brief This function sets the virtual loss used when running on multiple threads.
+                 *
+                 * While a thread is simulating below an action, the action
+                 * counts as visited once more, with a return lower than its
+                 * current value by the virtual loss. The virtual loss is in
+                 * the same units as the rewards, and must be >= 0, otherwise
+                 * the function will throw an std::invalid_argument.
+                 *
+                 * @param loss The new virtual loss.
+                 */
+                void setVirtualLoss(double loss);
+
                 /**
                  * @brief This function returns the MDP generative model being used.
                  *
@@ -140,9 +213,18 @@ namespace AIToolbox {
                 /**
                  * @brief This function returns a reference to the internal graph structure holding the results of rollouts.
                  *
+                 * The graph is a SearchTree, where nodes refer to each other by
+                 * index. This replaces the previous nested StateNode structure,
+                 * where each node held its action nodes and their children in
+                 * `children` members, so code walking the graph must be ported.
+                 * The root is getRoot() (index 0), the statistics of an action
+                 * of a node are getAction(node, a), and the child reached
+                 * through an action and a sampled state is getChild(node, a,
+                 * key), or can be found with forEachChild().
+                 *
                  * @return The internal graph.
                  */
-                const StateNode& getGraph() const;
+                const Graph& getGraph() const;
 
                 /**
                  * @brief This function returns the number of iterations performed to plan for an action.
@@ -158,60 +240,100 @@ namespace AIToolbox {
                  */
                 double getExploration() const;
 
+                /**
+                 * @brief This function returns the number of particles used in each rollout.
+                 *
+                 * @return The number of rollout particles.
+                 */
+                unsigned getRolloutParticles() const;
+
+                /**
+                 * @brief This function returns the number of threads used to run the simulations.
+                 *
+                 * @return The number of threads.
+                 */
+                unsigned getThreads() const;
+
+                /**
+                 * @brief This function returns the virtual loss used when running on multiple threads.
+                 *
+                 * @return The virtual loss.
+                 */
+                double getVirtualLoss() const;
+
             private:
+                // Buffers for batched rollouts, to avoid reallocations.
+                struct RolloutBuffers {
+                    std::vector<size_t> particles, actions;
+                    std::vector<double> rewards;
+                };
+
+                // The statistics of an action while running on multiple threads.
+                struct SharedActionNode {
+                    std::atomic<double> V;
+                    std::atomic<unsigned> N, virtualN;
+                };
+
+                // The statistics of a node while running on multiple threads.
+                struct SharedNode {
+                    size_t node;
+                    std::atomic<unsigned> N;
+                    SharedActionNode * actions;
+                };
+
                 const M& model_;
                 size_t S, A;
-                unsigned iterations_, maxDepth_;
-                double exploration_;
+                unsigned iterations_, maxDepth_, rolloutParticles_, threads_;
+                double exploration_, virtualLoss_;
 
-                StateNode graph_;
+                Graph graph_;
+                RolloutBuffers buffers_;
 
-                mutable std::default_random_engine rand_;
+                mutable RandomEngine rand_;
 
                 // Private Methods
                 size_t runSimulation(size_t s, unsigned horizon);
-                double simulate(StateNode & sn, size_t s, unsigned horizon);
-                double rollout(size_t s, unsigned horizon);
+                double simulate(size_t node, size_t s, unsigned horizon);
+                void simulateShared(size_t s);
+
+                template <typename G>
+                double rollout(size_t s, unsigned horizon, G & rand, RolloutBuffers & buffers) const;
 
                 template <typename Iterator>
                 Iterator findBestA(Iterator begin, Iterator end);
 
                 template <typename Iterator>
                 Iterator findBestBonusA(Iterator begin, Iterator end, unsigned count);
+
+                static std::tuple<double, unsigned, unsigned> getStatistics(const ActionNode & an);
+                static std::tuple<double, unsigned, unsigned> getStatistics(const SharedActionNode & an);
         };
 
         template <typename M>
         MCTS<M>::MCTS(const M& m, unsigned iter, double exp) : model_(m), S(model_.getS()), A(model_.getA()), iterations_(iter),
-                                                               exploration_(exp), graph_(), rand_(Impl::Seeder::getSeed()) {}
+                                                               rolloutParticles_(1), threads_(1), exploration_(exp), virtualLoss_(1.0), graph_(A), rand_(Impl::Seeder::getSeed()) {}
 
         template <typename M>
         size_t MCTS<M>::sampleAction(size_t s, unsigned horizon) {
             // Reset graph
-            graph_ = StateNode();
-            graph_.children.resize(A);
+            graph_.reset();
+            graph_.expand(0);
 
             return runSimulation(s, horizon);
         }
 
         template <typename M>
         size_t MCTS<M>::sampleAction(size_t a, size_t s1, unsigned horizon) {
-            auto & states = graph_.children[a].children;
-
-            auto it = states.find(s1);
-            if ( it == states.end() )
+            const size_t child = graph_.getChild(0, a, s1);
+            if ( child == Graph::npos )
                 return sampleAction(s1, horizon);
 
-            // Here we need an additional step, because *it is contained by graph_.
-            // If we just move assign, graph_ is first going to delete everything it
-            // contains (included *it), and then we are going to move unallocated memory
-            // into graph_! So we move *it outside of the graph_ hierarchy, so that
-            // we can then assign safely.
-            { auto tmp = std::move(it->second); graph_ = std::move(tmp); }
+            graph_.reroot(child);
 
-            // We resize here in case we didn't have time to sample the new
+            // We expand here in case we didn't have time to sample the new
             // head node. In this case, the new head may not have children.
             // This would break the UCT call.
-            graph_.children.resize(A);
+            graph_.expand(0);
 
             return runSimulation(s1, horizon);
         }
@@ -222,36 +344,37 @@ namespace AIToolbox {
 
             maxDepth_ = horizon;
 
-            for (unsigned i = 0; i < iterations_; ++i )
-                simulate(graph_, s, 0);
+            if ( threads_ == 1 ) {
+                for (unsigned i = 0; i < iterations_; ++i )
+                    simulate(0, s, 0);
+            } else {
+                simulateShared(s);
+            }
 
-            auto begin = std::begin(graph_.children);
-            return std::distance(begin, findBestA(begin, std::end(graph_.children)));
+            auto begin = graph_.getActions(0);
+            return std::distance(begin, findBestA(begin, begin + A));
         }
 
         template <typename M>
-        double MCTS<M>::simulate(StateNode & sn, size_t s, unsigned depth) {
+        double MCTS<M>::simulate(size_t node, size_t s, unsigned depth) {
             // Head update
-            sn.N++;
+            const unsigned count = ++graph_.getNode(node).N;
 
-            auto begin = std::begin(sn.children);
-            size_t a = std::distance(begin, findBestBonusA(begin, std::end(sn.children), sn.N));
+            auto begin = graph_.getActions(node);
+            size_t a = std::distance(begin, findBestBonusA(begin, begin + A, count));
 
             size_t s1; double rew;
-            std::tie(s1, rew) = model_.sampleSR(s, a);
-
-            auto & aNode = sn.children[a];
+            std::tie(s1, rew) = sampleSR(model_, s, a, rand_);
 
             // We only go deeper if needed (maxDepth_ is always at least 1).
             if ( depth + 1 < maxDepth_ && !model_.isTerminal(s1) ) {
-                auto end = std::end(aNode.children);
-                auto it = aNode.children.find(s1);
+                const size_t child = graph_.getChild(node, a, s1);
 
                 double futureRew;
-                if ( it == end ) {
-                    // Touch node to create it
-                    aNode.children[s1];
-                    futureRew = rollout(s1, depth + 1);
+                if ( child == Graph::npos ) {
+                    // Add the node to create it
+                    graph_.addChild(node, a, s1);
+                    futureRew = rollout(s1, depth + 1, rand_, buffers_);
                 }
                 else {
                     // Since most memory is allocated on the leaves,
@@ -259,14 +382,16 @@ namespace AIToolbox {
                     // we are actually descending into a node. If the node
                     // already has memory this should not do anything in
                     // any case.
-                    it->second.children.resize(A);
-                    futureRew = simulate( it->second, s1, depth + 1 );
+                    graph_.expand(child);
+                    futureRew = simulate( child, s1, depth + 1 );
                 }
 
                 rew += model_.getDiscount() * futureRew;
             }
 
-            // Action update
+            // Action update; the tree may have grown, so we only get the
+            // action node now.
+            auto & aNode = graph_.getAction(node, a);
             aNode.N++;
             aNode.V += ( rew - aNode.V ) / static_cast<double>(aNode.N);
 
@@ -274,17 +399,184 @@ namespace AIToolbox {
         }
 
         template <typename M>
-        double MCTS<M>::rollout(size_t s, unsigned depth) {
+        void MCTS<M>::simulateShared(size_t s0) {
+            // Only the nodes that the simulations descend into get shared
+            // statistics, so the cost of a call does not grow with the part
+            // of the tree kept from previous calls. The statistics are
+            // allocated in blocks which never move while the threads run.
+            constexpr size_t blockSize = 256;
+            std::deque<SharedNode> shared;
+            std::vector<std::unique_ptr<SharedActionNode[]>> actionBlocks;
+            std::unordered_map<size_t, SharedNode*> sharedSlots;
+            sharedSlots.reserve(std::min<size_t>(graph_.size(), iterations_));
+
+            // Must be called with the tree locked, or before the threads start.
+            auto acquire = [&](size_t node) -> SharedNode* {
+                const auto it = sharedSlots.find(node);
+                if ( it != sharedSlots.end() ) return it->second;
+
+                graph_.expand(node);
+                const size_t i = shared.size() % blockSize;
+                if ( i == 0 )
+                    actionBlocks.emplace_back(new SharedActionNode[blockSize * A]);
+                shared.emplace_back();
+                SharedNode * sn = &shared.back();
+                sharedSlots.emplace(node, sn);
+
+                sn->node = node;
+                sn->actions = actionBlocks.back().get() + i * A;
+                sn->N.store(graph_.getNode(node).N, std::memory_order_relaxed);
+                for ( size_t a = 0; a < A; ++a ) {
+                    const auto & an = graph_.getAction(node, a);
+                    sn->actions[a].V.store(an.V, std::memory_order_relaxed);
+                    sn->actions[a].N.store(an.N, std::memory_order_relaxed);
+                    sn->actions[a].virtualN.store(0, std::memory_order_relaxed);
+                }
+                return sn;
+            };
+            SharedNode * root = acquire(0);
+
+            // The lock protects the structure of the tree and the map of
+            // the shared statistics; the statistics themselves are atomic.
+            std::mutex treeMutex;
+            std::atomic<long long> budget(iterations_);
+
+            // The first exception thrown by a worker stops all of them,
+            // and is rethrown on the calling thread.
+            std::mutex errorMutex;
+            std::exception_ptr error;
+
+            auto worker = [&](RandomEngine & rand) {
+                try {
+                    RolloutBuffers buffers;
+                    std::vector<SharedActionNode*> path;
+                    std::vector<double> rewards;
+
+                    while ( budget.fetch_sub(1) > 0 ) {
+                        path.clear();
+                        rewards.clear();
+
+                        SharedNode * node = root;
+                        size_t s = s0;
+                        double futureRew = 0.0;
+                        for ( unsigned depth = 0; ; ++depth ) {
+                            // Head update
+                            const unsigned count = node->N.fetch_add(1) + 1;
+
+                            auto begin = node->actions;
+                            size_t a = std::distance(begin, findBestBonusA(begin, begin + A, count));
+                            begin[a].virtualN.fetch_add(1);
+                            path.push_back(begin + a);
+
+                            size_t s1; double rew;
+                            std::tie(s1, rew) = sampleSR(model_, s, a, rand);
+                            rewards.push_back(rew);
+
+                            // We only go deeper if needed (maxDepth_ is always at least 1).
+                            if ( depth + 1 >= maxDepth_ || model_.isTerminal(s1) ) break;
+
+                            SharedNode * next = nullptr;
+                            {
+                                std::lock_guard<std::mutex> lock(treeMutex);
+                                const size_t child = graph_.getChild(node->node, a, s1);
+                                if ( child == Graph::npos )
+                                    graph_.addChild(node->node, a, s1);
+                                else
+                                    next = acquire(child);
+                            }
+                            if ( !next ) {
+                                futureRew = rollout(s1, depth + 1, rand, buffers);
+                                break;
+                            }
+                            node = next;
+                            s = s1;
+                        }
+
+                        // Action updates, from the bottom of the path.
+                        for ( size_t i = path.size(); i-- > 0; ) {
+                            futureRew = rewards[i] + model_.getDiscount() * futureRew;
+
+                            auto & aNode = *path[i];
+                            const unsigned n = aNode.N.fetch_add(1) + 1;
+                            double v = aNode.V.load();
+                            while ( !aNode.V.compare_exchange_weak(v, v + ( futureRew - v ) / static_cast<double>(n)) );
+                            aNode.virtualN.fetch_sub(1);
+                        }
+                    }
+                } catch ( ... ) {
+                    budget.store(0);
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if ( !error ) error = std::current_exception();
+                }
+            };
+
+            std::vector<RandomEngine> engines;
+            engines.reserve(threads_);
+            for ( unsigned t = 0; t < threads_; ++t )
+                engines.push_back(rand_.split());
+
+            std::vector<std::thread> threads;
+            threads.reserve(threads_ - 1);
+            try {
+                for ( unsigned t = 1; t < threads_; ++t )
+                    threads.emplace_back(worker, std::ref(engines[t]));
+            } catch ( ... ) {
+                // Threads which were started must be stopped and joined
+                // before their destructors run, or the program terminates.
+                budget.store(0);
+                for ( auto & thread : threads )
+                    thread.join();
+                throw;
+            }
+            worker(engines[0]);
+            for ( auto & thread : threads )
+                thread.join();
+
+            if ( error ) std::rethrow_exception(error);
+
+            // Finally we copy the statistics back into the tree.
+            for ( const auto & sn : shared ) {
+                graph_.getNode(sn.node).N = sn.N.load(std::memory_order_relaxed);
+                for ( size_t a = 0; a < A; ++a ) {
+                    auto & an = graph_.getAction(sn.node, a);
+                    an.V = sn.actions[a].V.load(std::memory_order_relaxed);
+                    an.N = sn.actions[a].N.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        template <typename M>
+        template <typename G>
+        double MCTS<M>::rollout(size_t s, unsigned depth, G & rand, RolloutBuffers & buffers) const {
             double rew = 0.0, totalRew = 0.0, gamma = 1.0;
 
             std::uniform_int_distribution<size_t> generator(0, A-1);
+            if ( rolloutParticles_ == 1 ) {
+                for ( ; depth < maxDepth_; ++depth ) {
+                    std::tie( s, rew ) = sampleSR( model_, s, generator(rand), rand );
+
+                    totalRew += gamma * rew;
+                    gamma *= model_.getDiscount();
+                }
+                return totalRew;
+            }
+
+            // All particles start from the same state, and are advanced
+            // together one step at a time.
+            auto & particles = buffers.particles;
+            auto & actions = buffers.actions;
+            particles.assign(rolloutParticles_, s);
+            actions.resize(rolloutParticles_);
             for ( ; depth < maxDepth_; ++depth ) {
-                std::tie( s, rew ) = model_.sampleSR( s, generator(rand_) );
+                for ( auto & a : actions ) a = generator(rand);
+                sampleSRBatch( model_, particles, actions, particles, buffers.rewards, rand );
 
+                for ( auto r : buffers.rewards ) rew += r;
                 totalRew += gamma * rew;
+                rew = 0.0;
                 gamma *= model_.getDiscount();
             }
-            return totalRew;
+            return totalRew / rolloutParticles_;
         }
 
         template <typename M>
@@ -301,8 +593,14 @@ namespace AIToolbox {
             double logCount = std::log(count + 1.0);
             // We use this function to produce a score for each action. This can be easily
             // substituted with something else to produce different POMCP variants.
-            auto evaluationFunction = [this, logCount](const ActionNode & an){
-                    return an.V + exploration_ * std::sqrt( logCount / an.N );
+            // Visits of other threads still in progress count as visits
+            // with a lower value; with a single thread there are none.
+            auto evaluationFunction = [this, logCount](const typename std::iterator_traits<Iterator>::value_type & an){
+                    double V; unsigned N, virtualN;
+                    std::tie(V, N, virtualN) = getStatistics(an);
+                    const double visits = N + virtualN;
+                    const double penalty = virtualN ? virtualLoss_ * virtualN / visits : 0.0;
+                    return V - penalty + exploration_ * std::sqrt( logCount / visits );
             };
 
             auto bestIterator = begin++;
@@ -319,6 +617,16 @@ namespace AIToolbox {
             return bestIterator;
         }
 
+        template <typename M>
+        std::tuple<double, unsigned, unsigned> MCTS<M>::getStatistics(const ActionNode & an) {
+            return std::make_tuple(an.V, an.N, 0u);
+        }
+
+        template <typename M>
+        std::tuple<double, unsigned, unsigned> MCTS<M>::getStatistics(const SharedActionNode & an) {
+            return std::make_tuple(an.V.load(std::memory_order_relaxed), an.N.load(std::memory_order_relaxed), an.virtualN.load(std::memory_order_relaxed));
+        }
+
         template <typename M>
         void MCTS<M>::setIterations(unsigned iter) {
             iterations_ = iter;
@@ -329,13 +637,33 @@ namespace AIToolbox {
             exploration_ = exp;
         }
 
+        template <typename M>
+        void MCTS<M>::setRolloutParticles(unsigned particles) {
+            if ( !particles ) throw std::invalid_argument("The number of rollout particles must be at least 1");
+            rolloutParticles_ = particles;
+        }
+
+        template <typename M>
+        void MCTS<M>::setThreads(unsigned threads) {
+            if ( !threads ) throw std::invalid_argument("The number of threads must be at least 1");
+            if ( threads > 1 && !is_generative_model_engine<M>::value )
+                throw std::invalid_argument("Running on multiple threads requires a model which can be sampled with an external generator");
+            threads_ = threads;
+        }
+
+        template <typename M>
+        void MCTS<M>::setVirtualLoss(double loss) {
+            if ( loss < 0.0 ) throw std::invalid_argument("The virtual loss must be >= 0");
+            virtualLoss_ = loss;
+        }
+
         template <typename M>
         const M& MCTS<M>::getModel() const {
             return model_;
         }
 
         template <typename M>
-        const typename MCTS<M>::StateNode& MCTS<M>::getGraph() const {
+        const typename MCTS<M>::Graph& MCTS<M>::getGraph() const {
             return graph_;
         }
 
@@ -348,6 +676,21 @@ namespace AIToolbox {
         double MCTS<M>::getExploration() const {
             return exploration_;
         }
+
+        template <typename M>
+        unsigned MCTS<M>::getRolloutParticles() const {
+            return rolloutParticles_;
+        }
+
+        template <typename M>
+        unsigned MCTS<M>::getThreads() const {
+            return threads_;
+        }
+
+        template <typename M>
+        double MCTS<M>::getVirtualLoss() const {
+            return virtualLoss_;
+        }
     }
 }
 
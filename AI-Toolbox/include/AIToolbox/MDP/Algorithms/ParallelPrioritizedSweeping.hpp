@@ -0,0 +1,400 @@
+#ifndef AI_TOOLBOX_MDP_PARALLEL_PRIORITIZEDSWEEPING_HEADER_FILE
+#define AI_TOOLBOX_MDP_PARALLEL_PRIORITIZEDSWEEPING_HEADER_FILE
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+#include <AIToolbox/MultiQueue.hpp>
+#include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
+#include <AIToolbox/MDP/Algorithms/Utils/TransitionIndex.hpp>
+
+#include <AIToolbox/ProbabilityUtils.hpp>
+#include <AIToolbox/Impl/Seeder.hpp>
+
+namespace AIToolbox {
+    namespace MDP {
+#ifndef DOXYGEN_SKIP
+        // This is done to avoid bringing around the enable_if everywhere.
+        template <typename M, typename = typename std::enable_if<is_model<M>::value>::type>
+        class ParallelPrioritizedSweeping;
+#endif
+
+        /**
+         * @brief This class represents a multi-threaded version of the PrioritizedSweeping algorithm.
+         *
+         * The algorithm is the same as PrioritizedSweeping, but
+         * batchUpdateQ() processes the queue with several threads at once.
+         * The queue is a MultiQueue, which only approximately pops the
+         * states in order of priority, but lets threads push and pop
+         * without contending on a single lock.
+         *
+         * Each thread backs up the predecessors of the states it pops. The
+         * row of the QFunction and the value of a state are only written
+         * while holding a lock for that state, and threads read the values
+         * of successor states from a copy stored in atomic variables, so a
+         * backup may use a value that another thread is just updating. As
+         * in asynchronous value iteration this only changes the order of
+         * the updates, and the values still converge to the same solution.
+         *
+         * The N queue pops of batchUpdateQ() are shared between all
+         * threads, so the amount of work is the same as for
+         * PrioritizedSweeping. Threads are started at every call of
+         * batchUpdateQ(), so very small values of N are not worth
+         * running in parallel.
+         *
+         * stepUpdateQ(), batchUpdateQ() and rebuildIndex() must not be
+         * called concurrently with each other, and the model must not be
+         * modified while batchUpdateQ() runs.
+         */
+        template <typename M>
+        class ParallelPrioritizedSweeping<M> {
+            public:
+                /**
+                 * @brief Basic constructor.
+                 *
+                 * The queue is made of two heaps per thread, and is
+                 * rebuilt when the number of threads is changed with
+                 * setThreads().
+                 *
+                 * @param m The model to be used to update the QFunction.
+                 * @param theta The queue threshold.
+                 * @param n The number of sampling passes to do on the model upon batchUpdateQ().
+                 * @param threads The number of threads used by batchUpdateQ(). At least one thread is always used.
+                 */
+                ParallelPrioritizedSweeping(const M & m, double theta = 0.5, unsigned n = 50, unsigned threads = std::thread::hardware_concurrency());
+
+                /**
+                 * @brief This function updates the internal update queue.
+                 *
+                 * This function updates the QFunction for the specified pair, and decides
+                 * whether any parent couple that can lead to this state is worth pushing
+                 * into the queue.
+                 *
+                 * Any new transition of the pair found in the model is
+                 * added to the internal index.
+                 *
+                 * @param s The previous state.
+                 * @param a The action performed.
+                 */
+                void stepUpdateQ(size_t s, size_t a);
+
+                /**
+                 * @brief This function updates a QFunction based on simulated experience.
+                 *
+                 * All threads pop states from the queue, for at most N pops
+                 * in total, and back up the predecessors of each of them.
+                 * The function returns once the N pops are done, or when
+                 * the queue is empty and no thread can push into it
+                 * anymore.
+                 */
+                void batchUpdateQ();
+
+                /**
+                 * @brief This function rebuilds the internal index of transitions from the model.
+                 *
+                 * This is only needed if the model has changed in pairs
+                 * which have not been passed to stepUpdateQ() since.
+                 */
+                void rebuildIndex();
+
+                /**
+                 * @brief This function sets the theta parameter.
+                 *
+                 * The discount parameter must be >= 0.0.
+                 * otherwise the function will throw an std::invalid_argument.
+                 *
+                 * @param t The new theta parameter.
+                 */
+                void setQueueThreshold(double t);
+
+                /**
+                 * @brief This function will return the currently set theta parameter.
+                 *
+                 * @return The currently set theta parameter.
+                 */
+                double getQueueThreshold() const;
+
+                /**
+                 * @brief This function sets the number of sampling passes during batchUpdateQ().
+                 *
+                 * @param n The new number of updates.
+                 */
+                void setN(unsigned n);
+
+                /**
+                 * @brief This function returns the currently set number of sampling passes during batchUpdateQ().
+                 *
+                 * @return The current number of updates().
+                 */
+                unsigned getN() const;
+
+                /**
+                 * @brief This function sets the number of threads used by batchUpdateQ().
+                 *
+                 * The number of threads must be at least 1, otherwise the
+                 * function will throw an std::invalid_argument. The queue
+                 * is rebuilt with two heaps per thread, keeping the states
+                 * in it.
+                 *
+                 * @param threads The new number of threads.
+                 */
+                void setThreads(unsigned threads);
+
+                /**
+                 * @brief This function returns the number of threads used by batchUpdateQ().
+                 *
+                 * @return The currently set number of threads.
+                 */
+                unsigned getThreads() const;
+
+                /**
+                 * @brief This function returns the current number of elements unprocessed in the queue.
+                 *
+                 * @return The current length of the queue.
+                 */
+                size_t getQueueLength() const;
+
+                /**
+                 * @brief This function returns a reference to the referenced Model.
+                 *
+                 * @return The internal Model.
+                 */
+                const M & getModel() const;
+
+                /**
+                 * @brief This function returns a reference to the internal QFunction.
+                 *
+                 * @return The internal QFunction.
+                 */
+                const QFunction & getQFunction() const;
+
+                /**
+                 * @brief This function allows you to set the value of the internal QFunction.
+                 *
+                 * This function can be useful in case you are starting with an already populated
+                 * Experience/Model, which you can solve (for example with ValueIteration)
+                 * and then improve the solution with new experience.
+                 *
+                 * The ValueFunction is recomputed from the new QFunction.
+                 *
+                 * @param q The QFunction that will be copied.
+                 */
+                void setQFunction(const QFunction & q);
+
+                /**
+                 * @brief This function returns a reference to the internal ValueFunction.
+                 *
+                 * @return The internal ValueFunction.
+                 */
+                const ValueFunction & getValueFunction() const;
+
+            private:
+                size_t S, A;
+                unsigned N, threads_;
+                double theta_;
+
+                const M & model_;
+                TransitionIndex index_;
+                QFunction qfun_;
+                ValueFunction vfun_;
+
+                // A copy of the values which threads can read while
+                // others write them.
+                std::unique_ptr<std::atomic<double>[]> shadow_;
+                // Locks protecting the rows of qfun_ and the values, each
+                // shared by all states with the same remainder.
+                std::vector<std::mutex> locks_;
+
+                /**
+                 * @brief This function updates the QFunction of a pair from the transitions in the index.
+                 *
+                 * @param s The state of the pair.
+                 * @param a The action of the pair.
+                 * @param rand The random engine of the calling thread.
+                 */
+                void updateQ(size_t s, size_t a, RandomEngine & rand);
+
+                RandomEngine rand_;
+                MultiQueue queue_;
+        };
+
+        template <typename M>
+        ParallelPrioritizedSweeping<M>::ParallelPrioritizedSweeping(const M & m, double theta, unsigned n, unsigned threads) :
+                                                                                                                S(m.getS()),
+                                                                                                                A(m.getA()),
+                                                                                                                N(n),
+                                                                                                                threads_(std::max(1u, threads)),
+                                                                                                                theta_(theta),
+                                                                                                                model_(m),
+                                                                                                                index_(m),
+                                                                                                                qfun_(makeQFunction(S,A)),
+                                                                                                                vfun_(makeValueFunction(S)),
+                                                                                                                shadow_(new std::atomic<double>[S]),
+                                                                                                                locks_(std::min<size_t>(S, 4096)),
+                                                                                                                rand_(Impl::Seeder::getSeed()),
+                                                                                                                queue_(S, 2 * threads_)
+        {
+            for ( size_t s = 0; s < S; ++s )
+                shadow_[s].store(0.0, std::memory_order_relaxed);
+        }
+
+        template <typename M>
+        void ParallelPrioritizedSweeping<M>::stepUpdateQ(size_t s, size_t a) {
+            index_.updatePair(model_, s, a);
+            updateQ(s, a, rand_);
+        }
+
+        template <typename M>
+        void ParallelPrioritizedSweeping<M>::updateQ(size_t s, size_t a, RandomEngine & rand) {
+            // The backup only reads the shadow values, so it needs no lock.
+            double newQValue = 0;
+            index_.forEachSuccessor(s, a, [&](size_t s1) {
+                double probability = model_.getTransitionProbability(s,a,s1);
+                if ( checkDifferentSmall( probability, 0.0 ) )
+                    newQValue += probability * ( model_.getExpectedReward(s,a,s1) + model_.getDiscount() * shadow_[s1].load(std::memory_order_relaxed) );
+            });
+
+            double p;
+            {
+                std::lock_guard<std::mutex> lock(locks_[s % locks_.size()]);
+                auto & values = std::get<VALUES>(vfun_);
+
+                qfun_(s, a) = newQValue;
+                p = values[s];
+                values[s] = qfun_.row(s).maxCoeff(&std::get<ACTIONS>(vfun_)[s]);
+                p = std::fabs(values[s] - p);
+
+                shadow_[s].store(values[s], std::memory_order_relaxed);
+            }
+
+            // If it changed enough, we're going to update its parents.
+            if ( p > theta_ )
+                queue_.push(s, p, rand);
+        }
+
+        template <typename M>
+        void ParallelPrioritizedSweeping<M>::batchUpdateQ() {
+            // Pops left to do; it can briefly go below zero while threads
+            // try to pop from an empty queue.
+            std::atomic<long long> budget(N);
+            // Threads which may still push into the queue.
+            std::atomic<unsigned> busy(0);
+
+            auto worker = [&](RandomEngine & rand) {
+                while ( budget.fetch_sub(1) > 0 ) {
+                    ++busy;
+                    size_t s1;
+                    if ( queue_.pop(&s1, rand) ) {
+                        // The state we extract has been processed already
+                        // So it is the future we have to backtrack from.
+                        index_.forEachPredecessor(s1, [&](size_t s, size_t a) {
+                            if ( checkDifferentSmall(model_.getTransitionProbability(s,a,s1), 0.0) )
+                                updateQ(s, a, rand);
+                        });
+                        --busy;
+                        continue;
+                    }
+                    --busy;
+                    ++budget;
+
+                    // If nobody is working the queue is going to stay empty.
+                    if ( !busy.load() && queue_.empty() ) return;
+                    std::this_thread::yield();
+                }
+            };
+
+            if ( threads_ == 1 ) {
+                worker(rand_);
+                return;
+            }
+
+            std::vector<RandomEngine> engines;
+            engines.reserve(threads_);
+            for ( unsigned t = 0; t < threads_; ++t )
+                engines.push_back(rand_.split());
+
+            std::vector<std::thread> threads;
+            for ( unsigned t = 1; t < threads_; ++t )
+                threads.emplace_back(worker, std::ref(engines[t]));
+            worker(engines[0]);
+            for ( auto & thread : threads )
+                thread.join();
+        }
+
+        template <typename M>
+        void ParallelPrioritizedSweeping<M>::rebuildIndex() {
+            index_ = TransitionIndex(model_);
+        }
+
+        template <typename M>
+        void ParallelPrioritizedSweeping<M>::setN(unsigned n) {
+            N = n;
+        }
+
+        template <typename M>
+        unsigned ParallelPrioritizedSweeping<M>::getN() const {
+            return N;
+        }
+
+        template <typename M>
+        void ParallelPrioritizedSweeping<M>::setThreads(unsigned threads) {
+            if ( !threads ) throw std::invalid_argument("The number of threads must be at least 1");
+            threads_ = threads;
+            queue_.setQueues(2 * threads_);
+        }
+
+        template <typename M>
+        unsigned ParallelPrioritizedSweeping<M>::getThreads() const {
+            return threads_;
+        }
+
+        template <typename M>
+        void ParallelPrioritizedSweeping<M>::setQueueThreshold(double t) {
+            if ( t < 0.0 ) throw std::invalid_argument("Theta parameter must be >= 0");
+            theta_ = t;
+        }
+
+        template <typename M>
+        double ParallelPrioritizedSweeping<M>::getQueueThreshold() const {
+            return theta_;
+        }
+
+        template <typename M>
+        size_t ParallelPrioritizedSweeping<M>::getQueueLength() const {
+            return queue_.size();
+        }
+
+        template <typename M>
+        const M & ParallelPrioritizedSweeping<M>::getModel() const {
+            return model_;
+        }
+
+        template <typename M>
+        const QFunction & ParallelPrioritizedSweeping<M>::getQFunction() const {
+            return qfun_;
+        }
+
+        template <typename M>
+        void ParallelPrioritizedSweeping<M>::setQFunction(const QFunction & qfun) {
+            qfun_ = qfun;
+
+            // The values and their shadow copies must follow the new QFunction.
+            auto & values = std::get<VALUES>(vfun_);
+            for ( size_t s = 0; s < S; ++s ) {
+                values[s] = qfun_.row(s).maxCoeff(&std::get<ACTIONS>(vfun_)[s]);
+                shadow_[s].store(values[s], std::memory_order_relaxed);
+            }
+        }
+
+        template <typename M>
+        const ValueFunction & ParallelPrioritizedSweeping<M>::getValueFunction() const {
+            return vfun_;
+        }
+    }
+}
+#endif
@@ -0,0 +1,261 @@
+#ifndef AI_TOOLBOX_MDP_POLICY_ITERATION_HEADER_FILE
+#define AI_TOOLBOX_MDP_POLICY_ITERATION_HEADER_FILE
+
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <vector>
+#include <cmath>
+#include <limits>
+
+#include <Eigen/IterativeLinearSolvers>
+
+#include <AIToolbox/Utils.hpp>
+#include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
+#include <AIToolbox/MDP/Algorithms/Utils/ValueIterationParameters.hpp>
+
+namespace AIToolbox {
+    namespace MDP {
+
+#ifndef DOXYGEN_SKIP
+        // This is done to avoid bringing around the enable_if everywhere.
+        template <typename M, typename = typename std::enable_if<is_model_eigen<M>::value>::type>
+        class PolicyIteration;
+#endif
+
+        /**
+         * @brief This class applies the policy iteration algorithm on a Model.
+         *
+         * Policy iteration alternates two steps. In the evaluation step,
+         * the ValueFunction of the current policy is computed. In the
+         * improvement step, the policy is replaced by the one which is
+         * greedy with respect to that ValueFunction. Since each
+         * improvement step can change the policy in many states at once,
+         * the number of iterations needed is usually very small, and does
+         * not grow with the discount like it happens for ValueIteration.
+         *
+         * By default the evaluation is exact: the linear system
+         * (I - discount * T_pi) V = R_pi is solved with a sparse iterative
+         * solver (BiCGSTAB), warm-started from the previous values. If the
+         * solver fails to converge, as can happen with a discount of 1,
+         * the evaluation step reduces to a single Bellman backup for that
+         * iteration. Since the values then do not belong to the policy,
+         * the next improvement step cannot stop on a stable policy, and
+         * uses the epsilon criterion of approximate evaluation instead.
+         *
+         * Alternatively, the evaluation can be approximated with a fixed
+         * number of sweeps of the Bellman operator for the current policy.
+         * This is modified policy iteration, which sits between
+         * ValueIteration (a single sweep) and policy iteration (infinite
+         * sweeps), and is often faster than both.
+         *
+         * With exact evaluation, the algorithm stops when the policy is
+         * stable, which means that it is optimal. With approximate
+         * evaluation, it stops when an improvement step changes no value
+         * more than epsilon, as ValueIteration does. In both cases it also
+         * stops when the horizon is reached. The output has the same format
+         * as ValueIteration.
+         *
+         * @tparam M The type of model that is solved by the algorithm.
+         */
+        template <typename M>
+        class PolicyIteration<M> : public ValueIterationParameters {
+            public:
+                /**
+                 * @brief Basic constructor.
+                 *
+                 * The epsilon parameter must be >= 0.0, otherwise the
+                 * constructor will throw an std::invalid_argument. The
+                 * epsilon is only used with approximate evaluation, and an
+                 * epsilon of 0.0 forces the algorithm to perform a number
+                 * of improvement steps equal to the horizon specified.
+                 *
+                 * Note that the default value function size needs to match
+                 * the number of states of the Model. Otherwise it will
+                 * be ignored. An empty value function will be defaulted
+                 * to all zeroes.
+                 *
+                 * @param horizon The maximum number of improvement steps to perform.
+                 * @param epsilon The epsilon factor to stop the policy iteration loop.
+                 * @param evaluationSweeps The number of sweeps of each evaluation step, or 0 for exact evaluation.
+                 * @param v The initial value function from which to start the loop.
+                 */
+                PolicyIteration(unsigned horizon, double epsilon = 0.001, unsigned evaluationSweeps = 0, ValueFunction v = ValueFunction(Values(), Actions(0)));
+
+                /**
+                 * @brief This function applies policy iteration on an MDP to solve it.
+                 *
+                 * The algorithm is constrained by the currently set parameters.
+                 *
+                 * @param m The MDP that needs to be solved.
+                 * @return A tuple containing a boolean value specifying whether
+                 *         the algorithm converged and the ValueFunction and
+                 *         the QFunction for the Model.
+                 */
+                std::tuple<bool, ValueFunction, QFunction> operator()(const M & m);
+
+                /**
+                 * @brief This function sets the number of sweeps of each evaluation step.
+                 *
+                 * A value of 0 selects exact evaluation.
+                 *
+                 * @param k The new number of evaluation sweeps.
+                 */
+                void setEvaluationSweeps(unsigned k);
+
+                /**
+                 * @brief This function will return the current number of sweeps of each evaluation step.
+                 *
+                 * @return The currently set number of evaluation sweeps.
+                 */
+                unsigned getEvaluationSweeps() const;
+
+                /**
+                 * @brief This function returns the number of improvement steps performed by the last call to operator().
+                 *
+                 * @return The number of improvement steps of the last solve.
+                 */
+                unsigned getIterations() const;
+
+            private:
+                // Parameters
+                double discount_;
+                unsigned evaluationSweeps_, iterations_;
+
+                // Internals
+                size_t S, A;
+
+                /**
+                 * @brief This function evaluates a policy, improving the input values.
+                 *
+                 * @param model The MDP that needs to be solved.
+                 * @param ir The immediate rewards of the model.
+                 * @param actions The policy to evaluate.
+                 * @param values The values to improve; they must already be one Bellman backup of the policy.
+                 *
+                 * @return True if the values are now exactly those of the policy, false otherwise.
+                 */
+                bool evaluatePolicy(const M & model, const QFunction & ir, const Actions & actions, Values * values) const;
+        };
+
+        template <typename M>
+        PolicyIteration<M>::PolicyIteration(unsigned horizon, double epsilon, unsigned evaluationSweeps, ValueFunction v) :
+            ValueIterationParameters(horizon, epsilon, std::move(v)),
+            evaluationSweeps_(evaluationSweeps), iterations_(0), S(0), A(0) {}
+
+        template <typename M>
+        std::tuple<bool, ValueFunction, QFunction> PolicyIteration<M>::operator()(const M & model) {
+            // Extract necessary knowledge from model so we don't have to pass it around
+            S = model.getS();
+            A = model.getA();
+            discount_ = model.getDiscount();
+
+            ValueFunction v1 = makeStartingValueFunction(vParameter_, S, "PolicyIteration::solve()");
+            auto & values  = std::get<VALUES>(v1);
+            auto & actions = std::get<ACTIONS>(v1);
+
+            const auto ir = computeImmediateRewards(model);
+            QFunction q = makeQFunction(S, A);
+            Values newValues(S);
+            Vector tmp(S);
+
+            bool useEpsilon = checkDifferentSmall(epsilon_, 0.0);
+            bool converged = false, exact = false;
+            iterations_ = 0;
+
+            while ( iterations_ < horizon_ ) {
+                ++iterations_;
+
+                // Improvement step.
+                for ( size_t a = 0; a < A; ++a ) {
+                    tmp.noalias() = model.getTransitionFunction(a) * values;
+                    q.col(a) = ir.col(a) + discount_ * tmp;
+                }
+
+                bool stable = exact;
+                const double tolerance = std::numeric_limits<Scalar>::epsilon() * 16;
+                for ( size_t s = 0; s < S; ++s ) {
+                    size_t best;
+                    newValues(s) = q.row(s).maxCoeff(&best);
+                    // We only switch action on a strict improvement, or
+                    // policies with ties could cycle forever.
+                    if ( iterations_ == 1 || q(s, actions[s]) < newValues(s) - tolerance * std::max(1.0, static_cast<double>(std::fabs(newValues(s)))) ) {
+                        if ( actions[s] != best ) stable = false;
+                        actions[s] = best;
+                    }
+                }
+                const double variation = (newValues - values).cwiseAbs().maxCoeff();
+                values = newValues;
+
+                // After an exact evaluation the values are those of the
+                // policy, so a stable policy is optimal. A small
+                // improvement does not imply that the policy is optimal,
+                // as the gap can be up to epsilon / (1 - discount).
+                if ( exact ? stable : (useEpsilon && variation <= epsilon_) ) {
+                    converged = true;
+                    break;
+                }
+
+                // Evaluation step.
+                exact = evaluatePolicy(model, ir, actions, &values);
+            }
+
+            // We do not guarantee that the Value/QFunctions are the perfect ones, as we stop as within epsilon.
+            return std::make_tuple(converged, v1, q);
+        }
+
+        template <typename M>
+        bool PolicyIteration<M>::evaluatePolicy(const M & model, const QFunction & ir, const Actions & actions, Values * pv) const {
+            auto & values = *pv;
+
+            // The improvement step already did the first sweep.
+            if ( evaluationSweeps_ == 1 ) return false;
+
+            // We gather the transition function and rewards of the policy.
+            std::vector<Eigen::Triplet<Scalar>> triplets;
+            Vector rewards(S);
+            for ( size_t s = 0; s < S; ++s ) {
+                rewards(s) = ir(s, actions[s]);
+                forEachNonZero(model.getTransitionFunction(actions[s]), s, [&triplets, s](size_t s1, double p) {
+                    triplets.emplace_back(s, s1, p);
+                });
+            }
+            SparseMatrix2D transitions(S, S);
+            transitions.setFromTriplets(std::begin(triplets), std::end(triplets));
+
+            if ( evaluationSweeps_ ) {
+                Vector tmp(S);
+                for ( unsigned i = 1; i < evaluationSweeps_; ++i ) {
+                    tmp.noalias() = transitions * values;
+                    values = rewards + discount_ * tmp;
+                }
+                return false;
+            }
+
+            SparseMatrix2D system(S, S);
+            system.setIdentity();
+            system -= discount_ * transitions;
+
+            Eigen::BiCGSTAB<SparseMatrix2D> solver(system);
+            Values solution = solver.solveWithGuess(rewards, values);
+            if ( solver.info() != Eigen::Success ) return false;
+
+            values = solution;
+            return true;
+        }
+
+        template <typename M>
+        void PolicyIteration<M>::setEvaluationSweeps(unsigned k) {
+            evaluationSweeps_ = k;
+        }
+
+        template <typename M>
+        unsigned PolicyIteration<M>::getEvaluationSweeps() const { return evaluationSweeps_; }
+
+        template <typename M>
+        unsigned PolicyIteration<M>::getIterations() const { return iterations_; }
+    }
+}
+
+#endif
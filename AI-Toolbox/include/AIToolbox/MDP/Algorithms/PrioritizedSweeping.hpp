@@ -2,12 +2,11 @@
 #define AI_TOOLBOX_MDP_PRIORITIZEDSWEEPING_HEADER_FILE
 
 #include <tuple>
-#include <unordered_map>
-
-#include <boost/heap/fibonacci_heap.hpp>
 
+#include <AIToolbox/IndexedHeap.hpp>
 #include <AIToolbox/MDP/Types.hpp>
 #include <AIToolbox/MDP/Utils.hpp>
+#include <AIToolbox/MDP/Algorithms/Utils/TransitionIndex.hpp>
 
 #include <AIToolbox/ProbabilityUtils.hpp>
 
@@ -47,6 +46,15 @@ namespace AIToolbox {
          * 
          * Given how this algorithm updates the QFunction, the only problems
          * supported by this approach are ones with an infinite horizon.
+         *
+         * The possible transitions of the model are kept in a
+         * TransitionIndex, so that each update only costs time
+         * proportional to the number of predecessors and successors
+         * involved, rather than to the number of states. The index is
+         * built from the model on construction, and the transitions of a
+         * pair are rescanned every time stepUpdateQ() is called on it,
+         * which is what happens when learning with an RLModel. If the model
+         * is changed in other ways, rebuildIndex() rescans all of it.
          */
         template <typename M>
         class PrioritizedSweeping<M> {
@@ -67,6 +75,9 @@ namespace AIToolbox {
                  * whether any parent couple that can lead to this state is worth pushing
                  * into the queue.
                  *
+                 * Any new transition of the pair found in the model is
+                 * added to the internal index.
+                 *
                  * @param s The previous state.
                  * @param a The action performed.
                  */
@@ -84,6 +95,14 @@ namespace AIToolbox {
                  */
                 void batchUpdateQ();
 
+                /**
+                 * @brief This function rebuilds the internal index of transitions from the model.
+                 *
+                 * This is only needed if the model has changed in pairs
+                 * which have not been passed to stepUpdateQ() since.
+                 */
+                void rebuildIndex();
+
                 /**
                  * @brief This function sets the theta parameter.
                  *
@@ -160,33 +179,21 @@ namespace AIToolbox {
                 double theta_;
 
                 const M & model_;
+                TransitionIndex index_;
                 QFunction qfun_;
                 ValueFunction vfun_;
 
-                using PriorityQueueElement = std::tuple<double, size_t>;
-                enum {
-                    PRIORITY = 0,
-                    STATE    = 1,
-                };
-
-                class PriorityTupleLess {
-                    public:
-                        bool operator() (const PriorityQueueElement& arg1, const PriorityQueueElement& arg2) const;
-                };
-
-                using QueueType = boost::heap::fibonacci_heap<PriorityQueueElement, boost::heap::compare<PriorityTupleLess>>;
-
-                QueueType queue_;
+                /**
+                 * @brief This function updates the QFunction of a pair from the transitions in the index.
+                 *
+                 * @param s The state of the pair.
+                 * @param a The action of the pair.
+                 */
+                void updateQ(size_t s, size_t a);
 
-                std::unordered_map<size_t, typename QueueType::handle_type> queueHandles_;
+                IndexedHeap<> queue_;
         };
 
-        template <typename M>
-        bool PrioritizedSweeping<M>::PriorityTupleLess::operator() (const PriorityQueueElement& arg1, const PriorityQueueElement& arg2) const
-        {
-            return std::get<PRIORITY>(arg1) < std::get<PRIORITY>(arg2);
-        }
-
         template <typename M>
         PrioritizedSweeping<M>::PrioritizedSweeping(const M & m, double theta, unsigned n) :
                                                                                                                 S(m.getS()),
@@ -194,19 +201,27 @@ namespace AIToolbox {
                                                                                                                 N(n),
                                                                                                                 theta_(theta),
                                                                                                                 model_(m),
+                                                                                                                index_(m),
                                                                                                                 qfun_(makeQFunction(S,A)),
-                                                                                                                vfun_(makeValueFunction(S)) {}
+                                                                                                                vfun_(makeValueFunction(S)),
+                                                                                                                queue_(S) {}
 
         template <typename M>
         void PrioritizedSweeping<M>::stepUpdateQ(size_t s, size_t a) {
+            index_.updatePair(model_, s, a);
+            updateQ(s, a);
+        }
+
+        template <typename M>
+        void PrioritizedSweeping<M>::updateQ(size_t s, size_t a) {
             auto & values = std::get<VALUES>(vfun_);
             { // Update q[s][a]
                 double newQValue = 0;
-                for ( size_t s1 = 0; s1 < S; ++s1 ) {
+                index_.forEachSuccessor(s, a, [&](size_t s1) {
                     double probability = model_.getTransitionProbability(s,a,s1);
                     if ( checkDifferentSmall( probability, 0.0 ) )
                         newQValue += probability * ( model_.getExpectedReward(s,a,s1) + model_.getDiscount() * values[s1] );
-                }
+                });
                 qfun_(s, a) = newQValue;
             }
 
@@ -219,14 +234,8 @@ namespace AIToolbox {
             p = std::fabs(values[s] - p);
 
             // If it changed enough, we're going to update its parents.
-            if ( p > theta_ ) {
-                auto it = queueHandles_.find(s);
-
-                if ( it != std::end(queueHandles_) && std::get<PRIORITY>(*(it->second)) < p )
-                    queue_.increase(it->second, std::make_tuple(p, s));
-                else
-                    queueHandles_[s] = queue_.push(std::make_tuple(p, s));
-            }
+            if ( p > theta_ && ( !queue_.contains(s) || queue_.getPriority(s) < p ) )
+                queue_.push(s, p);
         }
 
         template <typename M>
@@ -236,19 +245,21 @@ namespace AIToolbox {
 
                 // The state we extract has been processed already
                 // So it is the future we have to backtrack from.
-                size_t s1;
-                std::tie(std::ignore, s1) = queue_.top();
-
+                const size_t s1 = queue_.top();
                 queue_.pop();
-                queueHandles_.erase(s1);
 
-                for ( size_t s = 0; s < S; ++s )
-                    for ( size_t a = 0; a < A; ++a )
-                        if ( checkDifferentSmall(model_.getTransitionProbability(s,a,s1), 0.0) )
-                            stepUpdateQ(s, a);
+                index_.forEachPredecessor(s1, [this, s1](size_t s, size_t a) {
+                    if ( checkDifferentSmall(model_.getTransitionProbability(s,a,s1), 0.0) )
+                        updateQ(s, a);
+                });
             }
         }
 
+        template <typename M>
+        void PrioritizedSweeping<M>::rebuildIndex() {
+            index_ = TransitionIndex(model_);
+        }
+
         template <typename M>
         void PrioritizedSweeping<M>::setN(unsigned n) {
             N = n;
@@ -0,0 +1,179 @@
+#ifndef AI_TOOLBOX_MDP_TOPOLOGICAL_VALUE_ITERATION_HEADER_FILE
+#define AI_TOOLBOX_MDP_TOPOLOGICAL_VALUE_ITERATION_HEADER_FILE
+
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <vector>
+#include <cmath>
+
+#include <AIToolbox/Utils.hpp>
+#include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
+#include <AIToolbox/MDP/Algorithms/Utils/ValueIterationParameters.hpp>
+#include <AIToolbox/MDP/Algorithms/Utils/StateGraph.hpp>
+
+namespace AIToolbox {
+    namespace MDP {
+
+#ifndef DOXYGEN_SKIP
+        // This is done to avoid bringing around the enable_if everywhere.
+        template <typename M, typename = typename std::enable_if<is_model_eigen<M>::value>::type>
+        class TopologicalValueIteration;
+#endif
+
+        /**
+         * @brief This class applies the topological value iteration algorithm on a Model.
+         *
+         * Many MDPs are nearly acyclic: once a state has been left, it
+         * cannot be reached again. ValueIteration ignores this, and keeps
+         * backing up all states at every iteration, even those whose
+         * values have long converged.
+         *
+         * This algorithm instead splits the graph of the possible
+         * transitions into its strongly connected components (see
+         * StateGraph), and solves them one at a time, in reverse
+         * topological order. When a component is solved, the values of all
+         * the states it can reach have already converged, so it can be
+         * solved in isolation; its states are backed up in place until
+         * their values change less than epsilon, and then never again.
+         * Components made of a single state which cannot transition to
+         * itself only need a single backup.
+         *
+         * The horizon bounds the number of sweeps performed on each
+         * component. The output has the same format as ValueIteration.
+         *
+         * @tparam M The type of model that is solved by the algorithm.
+         */
+        template <typename M>
+        class TopologicalValueIteration<M> : public ValueIterationParameters {
+            public:
+                /**
+                 * @brief Basic constructor.
+                 *
+                 * The epsilon parameter must be >= 0.0, otherwise the
+                 * constructor will throw an std::invalid_argument. The
+                 * epsilon parameter sets the convergence criterion for
+                 * each component. An epsilon of 0.0 forces the algorithm
+                 * to perform a number of sweeps equal to the horizon
+                 * specified on each component which may need them.
+                 *
+                 * Note that the default value function size needs to match
+                 * the number of states of the Model. Otherwise it will
+                 * be ignored. An empty value function will be defaulted
+                 * to all zeroes.
+                 *
+                 * @param horizon The maximum number of sweeps to perform on each component.
+                 * @param epsilon The epsilon factor to stop the value iteration loop.
+                 * @param v The initial value function from which to start the loop.
+                 */
+                TopologicalValueIteration(unsigned horizon, double epsilon = 0.001, ValueFunction v = ValueFunction(Values(), Actions(0)));
+
+                /**
+                 * @brief This function applies topological value iteration on an MDP to solve it.
+                 *
+                 * The algorithm is constrained by the currently set parameters.
+                 *
+                 * @param m The MDP that needs to be solved.
+                 * @return A tuple containing a boolean value specifying whether
+                 *         the specified epsilon bound was reached on all
+                 *         components and the ValueFunction and the QFunction
+                 *         for the Model.
+                 */
+                std::tuple<bool, ValueFunction, QFunction> operator()(const M & m);
+
+                /**
+                 * @brief This function returns the number of single state backups performed by the last call to operator().
+                 *
+                 * ValueIteration performs S backups per iteration, so this
+                 * allows to compare the work done by the two algorithms.
+                 *
+                 * @return The number of backups of the last solve.
+                 */
+                size_t getBackups() const;
+
+            private:
+                // Parameters
+                double discount_;
+
+                // Internals
+                size_t S, A, backups_;
+        };
+
+        template <typename M>
+        TopologicalValueIteration<M>::TopologicalValueIteration(unsigned horizon, double epsilon, ValueFunction v) :
+            ValueIterationParameters(horizon, epsilon, std::move(v)),
+            S(0), A(0), backups_(0) {}
+
+        template <typename M>
+        std::tuple<bool, ValueFunction, QFunction> TopologicalValueIteration<M>::operator()(const M & model) {
+            // Extract necessary knowledge from model so we don't have to pass it around
+            S = model.getS();
+            A = model.getA();
+            discount_ = model.getDiscount();
+
+            ValueFunction v1 = makeStartingValueFunction(vParameter_, S, "TopologicalValueIteration::solve()");
+            auto & values  = std::get<VALUES>(v1);
+            auto & actions = std::get<ACTIONS>(v1);
+
+            const auto ir = computeImmediateRewards(model);
+            QFunction q = makeQFunction(S, A);
+
+            const StateGraph graph(model);
+            auto components = graph.getComponents();
+
+            bool useEpsilon = checkDifferentSmall(epsilon_, 0.0);
+            bool converged = true;
+            backups_ = 0;
+
+            for ( auto & component : components ) {
+                // A lone state which cannot come back to itself only
+                // depends on states which have already been solved.
+                bool acyclic = false;
+                if ( component.size() == 1 ) {
+                    const size_t s = component[0];
+                    acyclic = true;
+                    for ( size_t a = 0; a < A; ++a )
+                        if ( model.getTransitionFunction(a).coeff(s, s) != 0.0 ) acyclic = false;
+                } else {
+                    graph.sortComponent(&component);
+                }
+
+                double variation = epsilon_ * 2; // Make it bigger
+                unsigned sweeps = 0;
+                while ( sweeps < horizon_ && (!useEpsilon || variation > epsilon_) ) {
+                    ++sweeps;
+
+                    double maxResidual = 0.0;
+                    for ( auto s : component ) {
+                        for ( size_t a = 0; a < A; ++a )
+                            q(s, a) = ir(s, a) + discount_ * model.getTransitionFunction(a).row(s).dot(values);
+
+                        const double old = values(s);
+                        values(s) = q.row(s).maxCoeff(&actions[s]);
+                        maxResidual = std::max(maxResidual, static_cast<double>(std::fabs(values(s) - old)));
+                    }
+                    backups_ += component.size();
+
+                    if ( acyclic ) {
+                        variation = 0.0;
+                        break;
+                    }
+                    // We do this only if the epsilon specified is positive, otherwise we
+                    // continue for all the timesteps.
+                    if ( useEpsilon )
+                        variation = maxResidual;
+                }
+                converged = converged && variation <= epsilon_;
+            }
+
+            // We do not guarantee that the Value/QFunctions are the perfect ones, as we stop as within epsilon.
+            return std::make_tuple(converged, v1, q);
+        }
+
+        template <typename M>
+        size_t TopologicalValueIteration<M>::getBackups() const { return backups_; }
+    }
+}
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef AI_TOOLBOX_MDP_STATE_GRAPH_HEADER_FILE
+#define AI_TOOLBOX_MDP_STATE_GRAPH_HEADER_FILE
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
+
+namespace AIToolbox {
+    namespace MDP {
+        /**
+         * @brief This class represents the graph of the possible transitions between the states of a Model.
+         *
+         * There is an edge from s to s' if s' can be reached from s with
+         * any action. Self loops are ignored. Both successors and
+         * predecessors are stored contiguously, so that the graph can be
+         * walked in both directions without pointer chasing.
+         *
+         * The graph is a snapshot of the Model, so it needs to be rebuilt
+         * whenever the transition function of the Model changes.
+         */
+        class StateGraph {
+            public:
+                using Components = std::vector<std::vector<size_t>>;
+
+                /**
+                 * @brief This constructor builds the graph from an Eigen Model.
+                 *
+                 * @tparam M The type of the Model.
+                 * @param model The Model to read.
+                 */
+                template <typename M, typename = typename std::enable_if<is_model_eigen<M>::value>::type>
+                explicit StateGraph(const M & model);
+
+                /**
+                 * @brief This function computes the strongly connected components of the graph.
+                 *
+                 * Two states are in the same component if each can be
+                 * reached from the other. Components are returned in
+                 * reverse topological order: no component can reach the
+                 * components that come before it.
+                 *
+                 * @return The strongly connected components of the graph.
+                 */
+                Components getComponents() const;
+
+                /**
+                 * @brief This function orders the states so that successors come before their predecessors as much as possible.
+                 *
+                 * States are returned component by component, following
+                 * the order of getComponents(), so that for acyclic graphs
+                 * this is a reverse topological order. Within each
+                 * component, states are ordered by increasing distance from
+                 * the states which can leave the component; if the
+                 * component is closed, its states are left in the order
+                 * given by getComponents().
+                 *
+                 * @return All states, in reverse topological order.
+                 */
+                std::vector<size_t> getReverseTopologicalOrder() const;
+
+                /**
+                 * @brief This function orders the states of a single component by increasing distance from its exits.
+                 *
+                 * This is the order used within each component by
+                 * getReverseTopologicalOrder().
+                 *
+                 * @param component The component to order, in place.
+                 */
+                void sortComponent(std::vector<size_t> * component) const;
+
+                /**
+                 * @brief This function returns the number of states in the graph.
+                 *
+                 * @return The number of states.
+                 */
+                size_t getS() const;
+
+                /**
+                 * @brief This function returns the successors of a state.
+                 *
+                 * @param s The state.
+                 *
+                 * @return A pointer to the first successor, and one past the last successor.
+                 */
+                std::pair<const size_t *, const size_t *> getSuccessors(size_t s) const;
+
+                /**
+                 * @brief This function returns the predecessors of a state.
+                 *
+                 * @param s The state.
+                 *
+                 * @return A pointer to the first predecessor, and one past the last predecessor.
+                 */
+                std::pair<const size_t *, const size_t *> getPredecessors(size_t s) const;
+
+            private:
+                /**
+                 * @brief This function builds the predecessor lists from the successor ones.
+                 */
+                void computePredecessors();
+
+                size_t S;
+                // Compressed rows: the neighbours of s are in [start[s], start[s+1]).
+                std::vector<size_t> successorsStart_, successors_;
+                std::vector<size_t> predecessorsStart_, predecessors_;
+        };
+
+        template <typename M, typename>
+        StateGraph::StateGraph(const M & model) : S(model.getS()), successorsStart_(S + 1, 0) {
+            const size_t A = model.getA();
+            std::vector<size_t> last(S, S);
+
+            for ( size_t s = 0; s < S; ++s ) {
+                for ( size_t a = 0; a < A; ++a )
+                    forEachNonZero(model.getTransitionFunction(a), s, [this, &last, s](size_t s1, double) {
+                        // Different actions often share successors, which
+                        // we only store once.
+                        if ( s1 == s || last[s1] == s ) return;
+                        last[s1] = s;
+                        successors_.push_back(s1);
+                    });
+                successorsStart_[s + 1] = successors_.size();
+            }
+            computePredecessors();
+        }
+    }
+}
+
+#endif
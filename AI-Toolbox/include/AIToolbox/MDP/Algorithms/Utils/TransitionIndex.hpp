@@ -0,0 +1,204 @@
+#ifndef AI_TOOLBOX_MDP_TRANSITION_INDEX_HEADER_FILE
+#define AI_TOOLBOX_MDP_TRANSITION_INDEX_HEADER_FILE
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
+#include <AIToolbox/Utils.hpp>
+
+namespace AIToolbox {
+    namespace MDP {
+        /**
+         * @brief This class indexes the possible transitions of a model, in both directions.
+         *
+         * For each state action pair the index stores the states that can
+         * be reached from it, and for each state the state action pairs
+         * that can reach it. Both are stored as compressed rows, so that
+         * walking them costs time proportional to the number of
+         * transitions, rather than to the number of states.
+         *
+         * Models which are learned, like RLModel, gain new transitions
+         * over time. These can be added with updatePair(), which rescans a
+         * single state action pair. New transitions are kept in separate
+         * lists, and are merged into the compressed rows once they become
+         * as many as the transitions already stored, so additions take
+         * amortized constant time.
+         *
+         * Transitions whose probability drops to zero are not removed;
+         * algorithms reading the index should multiply by the probability
+         * of each transition, which makes them harmless.
+         */
+        class TransitionIndex {
+            public:
+                /**
+                 * @brief This constructor builds the index from a model.
+                 *
+                 * Eigen models are read through their transition
+                 * matrices, other models one transition at a time.
+                 *
+                 * @tparam M The type of the model.
+                 * @param model The model to read.
+                 */
+                template <typename M, typename = typename std::enable_if<is_model<M>::value>::type>
+                explicit TransitionIndex(const M & model);
+
+                /**
+                 * @brief This function adds the new transitions of a state action pair to the index.
+                 *
+                 * @tparam M The type of the model.
+                 * @param model The model to read.
+                 * @param s The state of the pair.
+                 * @param a The action of the pair.
+                 *
+                 * @return The number of transitions that were added.
+                 */
+                template <typename M>
+                size_t updatePair(const M & model, size_t s, size_t a);
+
+                /**
+                 * @brief This function calls a function on all states that can be reached from a state action pair.
+                 *
+                 * @param s The state of the pair.
+                 * @param a The action of the pair.
+                 * @param f The function called as f(s1) for each reachable state.
+                 */
+                template <typename F>
+                void forEachSuccessor(size_t s, size_t a, F f) const;
+
+                /**
+                 * @brief This function calls a function on all state action pairs that can reach a state.
+                 *
+                 * @param s1 The state reached.
+                 * @param f The function called as f(s, a) for each pair.
+                 */
+                template <typename F>
+                void forEachPredecessor(size_t s1, F f) const;
+
+                /**
+                 * @brief This function returns the number of transitions in the index.
+                 *
+                 * @return The number of indexed transitions.
+                 */
+                size_t getTransitions() const;
+
+            private:
+                /**
+                 * @brief This function merges the transitions added by updatePair() into the compressed rows.
+                 */
+                void compact();
+
+                /**
+                 * @brief This function builds the predecessor rows from the successor ones.
+                 */
+                void computePredecessors();
+
+                /**
+                 * @brief This function calls a function on all non-zero transitions of a pair of an Eigen model.
+                 */
+                template <typename M, typename F, typename std::enable_if<is_model_eigen<M>::value, int>::type = 0>
+                static void forEachTransition(const M & model, size_t s, size_t a, F f);
+
+#ifndef DOXYGEN_SKIP
+                template <typename M, typename F, typename std::enable_if<!is_model_eigen<M>::value, int>::type = 0>
+                static void forEachTransition(const M & model, size_t s, size_t a, F f);
+#endif
+
+                size_t S, A;
+                // Compressed rows: the successors of pair p = s*A + a are
+                // in [start[p], start[p+1]), the predecessors of s1 in
+                // [start[s1], start[s1+1]), stored as pair ids.
+                std::vector<size_t> successorsStart_, successors_;
+                std::vector<size_t> predecessorsStart_, predecessors_;
+
+                // Transitions added after the last compaction.
+                std::unordered_map<size_t, std::vector<size_t>> newSuccessors_;
+                std::vector<std::vector<size_t>> newPredecessors_;
+                size_t newTransitions_;
+        };
+
+        template <typename M, typename>
+        TransitionIndex::TransitionIndex(const M & model) :
+                S(model.getS()), A(model.getA()), successorsStart_(S * A + 1, 0),
+                newPredecessors_(S), newTransitions_(0)
+        {
+            for ( size_t s = 0; s < S; ++s ) {
+                for ( size_t a = 0; a < A; ++a ) {
+                    forEachTransition(model, s, a, [this](size_t s1) {
+                        successors_.push_back(s1);
+                    });
+                    successorsStart_[s * A + a + 1] = successors_.size();
+                }
+            }
+            computePredecessors();
+        }
+
+        template <typename M>
+        size_t TransitionIndex::updatePair(const M & model, size_t s, size_t a) {
+            const size_t p = s * A + a;
+            const auto begin = std::begin(successors_) + successorsStart_[p];
+            const auto end   = std::begin(successors_) + successorsStart_[p + 1];
+            auto extra = newSuccessors_.find(p);
+
+            size_t added = 0;
+            forEachTransition(model, s, a, [&](size_t s1) {
+                if ( std::find(begin, end, s1) != end ) return;
+                if ( extra != std::end(newSuccessors_) && std::find(std::begin(extra->second), std::end(extra->second), s1) != std::end(extra->second) ) return;
+
+                if ( extra == std::end(newSuccessors_) )
+                    extra = newSuccessors_.emplace(p, std::vector<size_t>()).first;
+                extra->second.push_back(s1);
+                newPredecessors_[s1].push_back(p);
+                ++added;
+            });
+
+            newTransitions_ += added;
+            if ( newTransitions_ > successors_.size() )
+                compact();
+
+            return added;
+        }
+
+        template <typename F>
+        void TransitionIndex::forEachSuccessor(size_t s, size_t a, F f) const {
+            const size_t p = s * A + a;
+            for ( size_t i = successorsStart_[p]; i < successorsStart_[p + 1]; ++i )
+                f(successors_[i]);
+
+            if ( newTransitions_ == 0 ) return;
+            const auto extra = newSuccessors_.find(p);
+            if ( extra != std::end(newSuccessors_) )
+                for ( auto s1 : extra->second )
+                    f(s1);
+        }
+
+        template <typename F>
+        void TransitionIndex::forEachPredecessor(size_t s1, F f) const {
+            for ( size_t i = predecessorsStart_[s1]; i < predecessorsStart_[s1 + 1]; ++i )
+                f(predecessors_[i] / A, predecessors_[i] % A);
+            for ( auto p : newPredecessors_[s1] )
+                f(p / A, p % A);
+        }
+
+        template <typename M, typename F, typename std::enable_if<is_model_eigen<M>::value, int>::type>
+        void TransitionIndex::forEachTransition(const M & model, size_t s, size_t a, F f) {
+            forEachNonZero(model.getTransitionFunction(a), s, [&f](size_t s1, double p) {
+                if ( checkDifferentSmall(p, 0.0) ) f(s1);
+            });
+        }
+
+        template <typename M, typename F, typename std::enable_if<!is_model_eigen<M>::value, int>::type>
+        void TransitionIndex::forEachTransition(const M & model, size_t s, size_t a, F f) {
+            const size_t S = model.getS();
+            for ( size_t s1 = 0; s1 < S; ++s1 )
+                if ( checkDifferentSmall(model.getTransitionProbability(s, a, s1), 0.0) )
+                    f(s1);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef AI_TOOLBOX_MDP_VALUE_ITERATION_PARAMETERS_HEADER_FILE
+#define AI_TOOLBOX_MDP_VALUE_ITERATION_PARAMETERS_HEADER_FILE
+
+#include <cstddef>
+
+#include <AIToolbox/MDP/Types.hpp>
+
+namespace AIToolbox {
+    namespace MDP {
+        /**
+         * @brief This class holds the parameters shared by the value iteration variants.
+         *
+         * The variants derive from this class, so that they all handle the
+         * horizon, the epsilon and the starting value function in the same
+         * way.
+         */
+        class ValueIterationParameters {
+            public:
+                /**
+                 * @brief Basic constructor.
+                 *
+                 * The epsilon parameter must be >= 0.0, otherwise the
+                 * constructor will throw an std::invalid_argument.
+                 *
+                 * @param horizon The maximum number of iterations to perform.
+                 * @param epsilon The epsilon factor to stop the loop.
+                 * @param v The initial value function from which to start the loop.
+                 */
+                ValueIterationParameters(unsigned horizon, double epsilon, ValueFunction v);
+
+                /**
+                 * @brief This function sets the epsilon parameter.
+                 *
+                 * The epsilon parameter must be >= 0.0, otherwise the
+                 * function will throw an std::invalid_argument. An epsilon
+                 * of 0.0 forces the algorithm to perform a number of
+                 * iterations equal to the horizon.
+                 *
+                 * @param e The new epsilon parameter.
+                 */
+                void setEpsilon(double e);
+
+                /**
+                 * @brief This function sets the horizon parameter.
+                 *
+                 * @param h The new horizon parameter.
+                 */
+                void setHorizon(unsigned h);
+
+                /**
+                 * @brief This function sets the starting value function.
+                 *
+                 * An empty value function defaults to all zeroes. Note
+                 * that the default value function size needs to match
+                 * the number of states of the Model that needs to be
+                 * solved. Otherwise it will be ignored.
+                 *
+                 * @param v The new starting value function.
+                 */
+                void setValueFunction(ValueFunction v);
+
+                /**
+                 * @brief This function will return the currently set epsilon parameter.
+                 *
+                 * @return The currently set epsilon parameter.
+                 */
+                double getEpsilon() const;
+
+                /**
+                 * @brief This function will return the current horizon parameter.
+                 *
+                 * @return The currently set horizon parameter.
+                 */
+                unsigned getHorizon() const;
+
+                /**
+                 * @brief This function will return the current set default value function.
+                 *
+                 * @return The currently set default value function.
+                 */
+                const ValueFunction & getValueFunction() const;
+
+            protected:
+                double epsilon_;
+                unsigned horizon_;
+                ValueFunction vParameter_;
+        };
+
+        /**
+         * @brief This function returns the value function an algorithm should start from.
+         *
+         * If the provided value function does not have exactly S values,
+         * it is ignored and a value function of all zeroes is returned
+         * instead. In that case a warning is printed, unless the provided
+         * value function was empty.
+         *
+         * @param v The starting value function provided by the user.
+         * @param S The number of states of the Model being solved.
+         * @param name The name of the algorithm, for the warning.
+         *
+         * @return The value function to start from.
+         */
+        ValueFunction makeStartingValueFunction(const ValueFunction & v, size_t S, const char * name);
+    }
+}
+
+#endif
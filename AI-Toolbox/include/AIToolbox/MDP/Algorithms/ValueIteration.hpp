@@ -15,7 +15,10 @@ namespace AIToolbox {
          * several times better than the most general one.
          *
          * Both implementation have exactly the same API and are used
-         * in the exact same way.
+         * in the exact same way, except that only the Eigen version can
+         * run on multiple threads (see ValueIterationEigen::setThreads())
+         * and eliminate suboptimal actions (see
+         * ValueIterationEigen::setActionElimination()).
          *
          * This class in itself cannot be instantiated.
          */
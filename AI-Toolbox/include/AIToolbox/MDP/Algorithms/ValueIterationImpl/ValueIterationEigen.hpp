@@ -2,12 +2,18 @@
 #define AI_TOOLBOX_MDP_VALUE_ITERATION_EIGEN_HEADER_FILE
 
 #include <tuple>
-#include <iostream>
 #include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <AIToolbox/MDP/Types.hpp>
 #include <AIToolbox/MDP/Utils.hpp>
+#include <AIToolbox/MDP/Algorithms/Utils/ValueIterationParameters.hpp>
 #include <AIToolbox/ProbabilityUtils.hpp>
+#include <AIToolbox/Impl/Barrier.hpp>
 
 namespace AIToolbox {
     namespace MDP {
@@ -36,6 +42,22 @@ namespace AIToolbox {
          *
          * This version of the algorithm is optimized to work with Eigen matrices.
          *
+         * The algorithm can also run on multiple threads. In that case the
+         * state space is split in contiguous blocks of rows, one per
+         * thread, and each thread computes the QFunction, the Bellman
+         * backup and the convergence check for its own block. Threads only
+         * synchronize once per iteration, and the output does not depend
+         * on the number of threads used.
+         *
+         * Optionally, the algorithm can also eliminate actions which are
+         * provably suboptimal (see setActionElimination()). After each
+         * iteration the smallest and largest changes in value bound how far
+         * the current QFunction can be from the optimal one; any state
+         * action pair whose upper bound falls below the lower bound of
+         * another action in the same state can never be optimal, and is
+         * not computed anymore in the following iterations. This can save
+         * most of the work on models with many actions.
+         *
          * @tparam M The type of model that is solved by the algorithm.
          */
         template <typename M>
@@ -109,6 +131,34 @@ namespace AIToolbox {
                  */
                 void setValueFunction(ValueFunction v);
 
+                /**
+                 * @brief This function sets the number of threads used to solve the MDP.
+                 *
+                 * The number of threads must be at least 1, otherwise the
+                 * function will throw an std::invalid_argument. Models with
+                 * fewer states than threads only use one thread per state.
+                 *
+                 * @param threads The new number of threads.
+                 */
+                void setThreads(unsigned threads);
+
+                /**
+                 * @brief This function sets whether suboptimal actions are eliminated during the iterations.
+                 *
+                 * Action elimination relies on the discount to bound the
+                 * optimal values, so it has no effect on Models with a
+                 * discount of 1. Eliminated actions are computed again
+                 * once at the end, so the returned QFunction is the same
+                 * that would be computed from the final values.
+                 *
+                 * Note that, as eliminated actions are not considered
+                 * anymore, values before convergence can differ from the
+                 * ones computed without elimination.
+                 *
+                 * @param elimination Whether to eliminate suboptimal actions.
+                 */
+                void setActionElimination(bool elimination);
+
                 /**
                  * @brief This function will return the currently set epsilon parameter.
                  *
@@ -130,51 +180,124 @@ namespace AIToolbox {
                  */
                 const ValueFunction & getValueFunction() const;
 
+                /**
+                 * @brief This function returns the number of threads used to solve the MDP.
+                 *
+                 * @return The currently set number of threads.
+                 */
+                unsigned getThreads() const;
+
+                /**
+                 * @brief This function returns whether suboptimal actions are eliminated during the iterations.
+                 *
+                 * @return Whether action elimination is enabled.
+                 */
+                bool getActionElimination() const;
+
+                /**
+                 * @brief This function returns the number of state action pairs eliminated by the last call to operator().
+                 *
+                 * @return The number of eliminated state action pairs.
+                 */
+                size_t getEliminatedActions() const;
+
             private:
                 // Parameters
                 double discount_, epsilon_;
-                unsigned horizon_;
+                unsigned horizon_, threads_;
+                bool elimination_;
                 ValueFunction vParameter_;
 
                 // Internals
                 ValueFunction v1_;
-                size_t S, A;
+                size_t S, A, eliminatedActions_;
+
+                // The actions of each state are stored in A slots; the
+                // first remaining_[s] of them have not been eliminated.
+                std::vector<size_t> actions_, remaining_;
+
+                // Buffer for the matrix-vector products, so that no
+                // memory is allocated while iterating.
+                Vector tmp_;
 
                 /**
-                 * @brief This function computes all immediate rewards (state and action) of the MDP once for improved speed.
+                 * @brief This function computes the Model's most up-to-date QFunction for a block of states.
                  *
-                 * @param m The MDP that needs to be solved.
+                 * For each action this computes a single matrix-vector
+                 * product between the rows of the transition function in
+                 * the block and the current values, so that sparse models
+                 * are multiplied sparsely and dense ones use Eigen's
+                 * blocked GEMV kernels. The output QFunction must already
+                 * have the correct size.
                  *
-                 * @return The Models's immediate rewards.
+                 * @param m The MDP that needs to be solved.
+                 * @param ir The immediate rewards of the model.
+                 * @param values The current values.
+                 * @param begin The first state of the block.
+                 * @param end The state after the last state of the block.
+                 * @param q The output QFunction.
                  */
-                QFunction computeImmediateRewards(const M & model) const;
+                void computeQFunction(const M & model, const QFunction & ir, const Values & values, size_t begin, size_t end, QFunction * q);
 
                 /**
-                 * @brief This function creates the Model's most up-to-date QFunction.
+                 * @brief This function computes the QFunction of the actions which have not been eliminated for a block of states.
+                 *
+                 * Each state action pair is computed on its own, which is
+                 * slower than computeQFunction() per pair, and so is only
+                 * worth it once most pairs have been eliminated. The
+                 * values of eliminated pairs are left untouched.
                  *
                  * @param m The MDP that needs to be solved.
                  * @param ir The immediate rewards of the model.
-                 *
-                 * @return A new QFunction.
+                 * @param values The current values.
+                 * @param begin The first state of the block.
+                 * @param end The state after the last state of the block.
+                 * @param q The output QFunction.
                  */
-                QFunction computeQFunction(const M & model, const QFunction & ir) const;
+                void computeRemainingQFunction(const M & model, const QFunction & ir, const Values & values, size_t begin, size_t end, QFunction * q) const;
 
                 /**
-                 * @brief This function applies a single pass Bellman operator, improving the current ValueFunction estimate.
+                 * @brief This function applies a single pass Bellman operator on a block of states, improving the current ValueFunction estimate.
                  *
                  * This function computes the optimal value and action for
-                 * each state, given the precomputed QFunction.
+                 * each state in the block, given the precomputed QFunction.
+                 * Eliminated actions are not considered.
                  *
                  * @param q The precomputed QFunction.
-                 * @param vOut The newly estimated ValueFunction.
+                 * @param values The current values.
+                 * @param begin The first state of the block.
+                 * @param end The state after the last state of the block.
+                 * @param vOut The newly estimated values.
+                 * @param aOut The newly estimated actions.
+                 *
+                 * @return The minimum and maximum change in value within the block.
                  */
-                inline void bellmanOperator(const QFunction & q, ValueFunction * vOut) const;
+                inline std::pair<double, double> bellmanOperator(const QFunction & q, const Values & values, size_t begin, size_t end, Values * vOut, Actions * aOut) const;
+
+                /**
+                 * @brief This function eliminates the suboptimal actions of a block of states.
+                 *
+                 * The optimal QFunction is within [q + gap * minChange, q +
+                 * gap * maxChange], where gap is discount / (1 - discount).
+                 * An action whose upper bound is lower than the lower bound
+                 * of the best action is removed.
+                 *
+                 * @param values The values computed from the QFunction.
+                 * @param minChange The minimum change in value of the last iteration.
+                 * @param maxChange The maximum change in value of the last iteration.
+                 * @param begin The first state of the block.
+                 * @param end The state after the last state of the block.
+                 * @param q The QFunction computed in the last iteration.
+                 *
+                 * @return The number of eliminated state action pairs.
+                 */
+                size_t eliminateActions(const Values & values, double minChange, double maxChange, size_t begin, size_t end, const QFunction & q);
         };
 
         template <typename M>
         ValueIterationEigen<M>::ValueIterationEigen(unsigned horizon, double epsilon, ValueFunction v) :
-            horizon_(horizon), vParameter_(v),
-            S(0), A(0)
+            horizon_(horizon), threads_(1), elimination_(false), vParameter_(v),
+            S(0), A(0), eliminatedActions_(0)
         {
             setEpsilon(epsilon);
         }
@@ -186,41 +309,111 @@ namespace AIToolbox {
             A = model.getA();
             discount_ = model.getDiscount();
 
-            {
-                // Verify that parameter value function is compatible.
-                size_t size = std::get<VALUES>(vParameter_).size();
-                if ( size != S ) {
-                    if ( size != 0 )
-                        std::cerr << "AIToolbox: Size of starting value function in ValueIteration::solve() is incorrect, ignoring...\n";
-                    // Defaulting
-                    v1_ = makeValueFunction(S);
-                }
-                else
-                    v1_ = vParameter_;
-            }
+            v1_ = makeStartingValueFunction(vParameter_, S, "ValueIteration::solve()");
 
             auto ir = computeImmediateRewards(model);
 
-            unsigned timestep = 0;
             double variation = epsilon_ * 2; // Make it bigger
 
-            Values val0;
+            // Values are double buffered: iteration t reads values[t % 2]
+            // and writes values[(t+1) % 2], so that no thread can
+            // overwrite values that another thread may still be reading.
+            Values values[2] = { std::get<VALUES>(v1_), std::get<VALUES>(v1_) };
+            auto & actions = std::get<ACTIONS>(v1_);
             QFunction q = makeQFunction(S, A);
+            tmp_.resize(S);
+            const bool eliminate = elimination_ && discount_ < 1.0;
+            actions_.resize(eliminate ? S * A : 0);
+            remaining_.assign(eliminate ? S : 0, A);
+            for ( size_t i = 0; i < actions_.size(); ++i ) actions_[i] = i % A;
+            eliminatedActions_ = 0;
 
             bool useEpsilon = checkDifferentSmall(epsilon_, 0.0);
-            while ( timestep < horizon_ && (!useEpsilon || variation > epsilon_) ) {
-                ++timestep;
-
-                auto & val1 = std::get<VALUES>(v1_);
-                val0 = val1;
-
-                q = computeQFunction(model, ir);
-                bellmanOperator(q, &v1_);
+            if ( horizon_ == 0 )
+                return std::make_tuple(variation <= epsilon_, v1_, q);
+            // An empty model has nothing to iterate on, and no states to
+            // split into blocks.
+            if ( S == 0 )
+                return std::make_tuple(true, v1_, q);
+
+            const size_t blocks = std::min(static_cast<size_t>(threads_), S);
+            // Per-block minimum and maximum changes, double buffered like the values.
+            std::vector<std::pair<double, double>> changes(2 * blocks);
+            std::vector<size_t> eliminations(blocks, 0);
+            // Per-block remaining pairs, double buffered like the values.
+            std::vector<size_t> remaining(2 * blocks);
+            Impl::Barrier barrier(blocks);
+            unsigned timestep = 0;
 
-                // We do this only if the epsilon specified is positive, otherwise we
-                // continue for all the timesteps.
-                if ( useEpsilon )
-                    variation = (val1 - val0).cwiseAbs().maxCoeff();
+            auto worker = [&](size_t block) {
+                const size_t begin = S * block / blocks, end = S * (block + 1) / blocks;
+                // Whether enough pairs have been eliminated to compute
+                // them one by one. All blocks agree on it, so that the
+                // output does not depend on the number of threads.
+                bool pairs = false;
+
+                for ( unsigned t = 0; ; ++t ) {
+                    const auto & val0 = values[t % 2];
+                    auto & val1 = values[(t + 1) % 2];
+
+                    if ( pairs )
+                        computeRemainingQFunction(model, ir, val0, begin, end, &q);
+                    else
+                        computeQFunction(model, ir, val0, begin, end, &q);
+                    changes[(t % 2) * blocks + block] = bellmanOperator(q, val0, begin, end, &val1, &actions);
+                    remaining[(t % 2) * blocks + block] = (end - begin) * A - eliminations[block];
+
+                    barrier.wait();
+
+                    // Every thread takes the same decision from the same
+                    // data, so there is no need to synchronize again.
+                    const auto first = std::begin(changes) + (t % 2) * blocks;
+                    double minChange = first->first, maxChange = first->second;
+                    for ( auto it = first + 1; it != first + blocks; ++it ) {
+                        minChange = std::min(minChange, it->first);
+                        maxChange = std::max(maxChange, it->second);
+                    }
+                    const double v = std::max(-minChange, maxChange);
+
+                    // We do this only if the epsilon specified is positive, otherwise we
+                    // continue for all the timesteps.
+                    if ( t + 1 >= horizon_ || (useEpsilon && v <= epsilon_) ) {
+                        if ( block == 0 ) {
+                            timestep = t + 1;
+                            if ( useEpsilon ) variation = v;
+                        }
+                        return;
+                    }
+
+                    if ( eliminate ) {
+                        eliminations[block] += eliminateActions(val1, minChange, maxChange, begin, end, q);
+
+                        size_t total = 0;
+                        for ( size_t b = 0; b < blocks; ++b ) total += remaining[(t % 2) * blocks + b];
+                        pairs = 2 * total < S * A;
+                    }
+                }
+            };
+
+            std::vector<std::thread> threads;
+            for ( size_t block = 1; block < blocks; ++block )
+                threads.emplace_back(worker, block);
+            worker(0);
+            for ( auto & thread : threads )
+                thread.join();
+
+            std::get<VALUES>(v1_) = std::move(values[timestep % 2]);
+
+            for ( auto e : eliminations ) eliminatedActions_ += e;
+            if ( eliminatedActions_ ) {
+                // Eliminated pairs are computed from the values used in the last iteration.
+                const auto & last = values[(timestep + 1) % 2];
+                for ( size_t s = 0; s < S; ++s ) {
+                    for ( size_t i = remaining_[s]; i < A; ++i ) {
+                        const size_t a = actions_[s * A + i];
+                        q(s, a) = ir(s, a) + discount_ * model.getTransitionFunction(a).row(s).dot(last);
+                    }
+                }
             }
 
             // We do not guarantee that the Value/QFunctions are the perfect ones, as we stop as within epsilon.
@@ -228,35 +421,77 @@ namespace AIToolbox {
         }
 
         template <typename M>
-        QFunction ValueIterationEigen<M>::computeImmediateRewards(const M & model) const {
-            QFunction pr = makeQFunction(S, A);
-
-            for ( size_t a = 0; a < A; ++a )
-                pr.col(a).noalias() = model.getTransitionFunction(a).cwiseProduct(model.getRewardFunction(a)) * Vector::Ones(S);
-
-            return pr;
+        void ValueIterationEigen<M>::computeQFunction(const M & model, const QFunction & ir, const Values & values, size_t begin, size_t end, QFunction * q) {
+            assert(q);
+            const size_t n = end - begin;
+            auto tmp = tmp_.segment(begin, n);
+
+            // The product is done into a contiguous buffer, since the
+            // columns of the row-major QFunction are strided.
+            for ( size_t a = 0; a < A; ++a ) {
+                tmp.noalias() = model.getTransitionFunction(a).middleRows(begin, n) * values;
+                q->block(begin, a, n, 1) = ir.block(begin, a, n, 1) + discount_ * tmp;
+            }
         }
 
         template <typename M>
-        QFunction ValueIterationEigen<M>::computeQFunction(const M & model, const QFunction & ir) const {
-            QFunction q(S, A);
-
-            for ( size_t a = 0; a < A; ++a )
-                q.col(a).noalias() = discount_ * ( model.getTransitionFunction(a).cwiseProduct(std::get<VALUES>(v1_).replicate(1, S).transpose() )) * Vector::Ones(S);
-
-            q += ir;
-
-            return q;
+        void ValueIterationEigen<M>::computeRemainingQFunction(const M & model, const QFunction & ir, const Values & values, size_t begin, size_t end, QFunction * q) const {
+            assert(q);
+            for ( size_t s = begin; s < end; ++s ) {
+                for ( size_t i = 0; i < remaining_[s]; ++i ) {
+                    const size_t a = actions_[s * A + i];
+                    (*q)(s, a) = ir(s, a) + discount_ * model.getTransitionFunction(a).row(s).dot(values);
+                }
+            }
         }
 
         template <typename M>
-        void ValueIterationEigen<M>::bellmanOperator(const QFunction & q, ValueFunction * v) const {
-            assert(v);
-            auto & values  = std::get<VALUES> (*v);
-            auto & actions = std::get<ACTIONS>(*v);
+        std::pair<double, double> ValueIterationEigen<M>::bellmanOperator(const QFunction & q, const Values & values, size_t begin, size_t end, Values * vOut, Actions * aOut) const {
+            assert(vOut && aOut);
+            auto & newValues  = *vOut;
+            auto & newActions = *aOut;
+
+            double minChange = 0.0, maxChange = 0.0;
+            for ( size_t s = begin; s < end; ++s ) {
+                if ( remaining_.empty() || remaining_[s] == A )
+                    newValues(s) = q.row(s).maxCoeff(&newActions[s]);
+                else {
+                    // Only the remaining actions need to be checked. Ties
+                    // pick the lowest action, as maxCoeff does.
+                    size_t best = actions_[s * A];
+                    for ( size_t i = 1; i < remaining_[s]; ++i ) {
+                        const size_t a = actions_[s * A + i];
+                        if ( q(s, a) > q(s, best) || (q(s, a) == q(s, best) && a < best) ) best = a;
+                    }
+                    newValues(s) = q(s, best);
+                    newActions[s] = best;
+                }
+                const double change = newValues(s) - values(s);
+                if ( s == begin ) minChange = maxChange = change;
+                minChange = std::min(minChange, change);
+                maxChange = std::max(maxChange, change);
+            }
+            return std::make_pair(minChange, maxChange);
+        }
 
-            for ( size_t s = 0; s < S; ++s )
-                values(s) = q.row(s).maxCoeff(&actions[s]);
+        template <typename M>
+        size_t ValueIterationEigen<M>::eliminateActions(const Values & values, double minChange, double maxChange, size_t begin, size_t end, const QFunction & q) {
+            // The best action has the highest lower bound, as the bounds
+            // of all actions are equally wide.
+            const double width = discount_ / (1.0 - discount_) * (maxChange - minChange);
+
+            size_t eliminated = 0;
+            for ( size_t s = begin; s < end; ++s ) {
+                auto & remaining = remaining_[s];
+                for ( size_t i = 0; i < remaining; ) {
+                    const size_t a = actions_[s * A + i];
+                    if ( q(s, a) + width >= values(s) ) { ++i; continue; }
+                    // Eliminated actions are moved after the remaining ones.
+                    std::swap(actions_[s * A + i], actions_[s * A + --remaining]);
+                    ++eliminated;
+                }
+            }
+            return eliminated;
         }
 
         template <typename M>
@@ -275,6 +510,17 @@ namespace AIToolbox {
             vParameter_ = v;
         }
 
+        template <typename M>
+        void ValueIterationEigen<M>::setThreads(unsigned threads) {
+            if ( !threads ) throw std::invalid_argument("The number of threads must be at least 1");
+            threads_ = threads;
+        }
+
+        template <typename M>
+        void ValueIterationEigen<M>::setActionElimination(bool elimination) {
+            elimination_ = elimination;
+        }
+
         template <typename M>
         double ValueIterationEigen<M>::getEpsilon()   const { return epsilon_; }
 
@@ -283,6 +529,15 @@ namespace AIToolbox {
 
         template <typename M>
         const ValueFunction & ValueIterationEigen<M>::getValueFunction() const { return vParameter_; }
+
+        template <typename M>
+        unsigned ValueIterationEigen<M>::getThreads() const { return threads_; }
+
+        template <typename M>
+        bool ValueIterationEigen<M>::getActionElimination() const { return elimination_; }
+
+        template <typename M>
+        size_t ValueIterationEigen<M>::getEliminatedActions() const { return eliminatedActions_; }
     }
 }
 
@@ -2,11 +2,11 @@
 #define AI_TOOLBOX_MDP_VALUE_ITERATION_GENERAL_HEADER_FILE
 
 #include <tuple>
-#include <iostream>
 #include <iterator>
 
 #include <AIToolbox/MDP/Types.hpp>
 #include <AIToolbox/MDP/Utils.hpp>
+#include <AIToolbox/MDP/Algorithms/Utils/ValueIterationParameters.hpp>
 #include <AIToolbox/ProbabilityUtils.hpp>
 
 namespace AIToolbox {
@@ -187,18 +187,7 @@ namespace AIToolbox {
             A = model.getA();
             discount_ = model.getDiscount();
 
-            {
-                // Verify that parameter value function is compatible.
-                size_t size = std::get<VALUES>(vParameter_).size();
-                if ( size != S ) {
-                    if ( size != 0 )
-                        std::cerr << "AIToolbox: Size of starting value function in ValueIteration::solve() is incorrect, ignoring...\n";
-                    // Defaulting
-                    v1_ = makeValueFunction(S);
-                }
-                else
-                    v1_ = vParameter_;
-            }
+            v1_ = makeStartingValueFunction(vParameter_, S, "ValueIteration::solve()");
 
             auto ir = computeImmediateRewards(model);
 
@@ -0,0 +1,242 @@
+#ifndef AI_TOOLBOX_MDP_FINITE_HORIZON_POLICY_HEADER_FILE
+#define AI_TOOLBOX_MDP_FINITE_HORIZON_POLICY_HEADER_FILE
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+#include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/PolicyInterface.hpp>
+
+namespace AIToolbox {
+    namespace MDP {
+        /**
+         * @brief This class represents a deterministic time-dependent MDP Policy.
+         *
+         * When an MDP is solved for a finite horizon, the best action in a
+         * state depends on how many timesteps are missing until the end of
+         * the episode. This class stores one action per state for each of
+         * those horizons.
+         *
+         * To keep this small, each action is stored using only the bits
+         * needed to represent A actions, and a horizon whose actions are
+         * the same as the ones of the previous horizon does not store them
+         * again. Since finite horizon policies usually become stationary
+         * after a few timesteps, most horizons end up sharing the same
+         * actions. Looking up an action is still a constant time operation.
+         *
+         * As in POMDP::Policy, horizons count the number of timesteps
+         * missing until the end of the episode, so that horizon 1 is the
+         * last timestep. The Policy is built one horizon at a time,
+         * starting from horizon 1, which is the order in which the
+         * FiniteHorizonValueIteration algorithm computes them.
+         */
+        class FiniteHorizonPolicy : public PolicyInterface<size_t> {
+            public:
+                /**
+                 * @brief Basic constructor.
+                 *
+                 * This constructor initializes the Policy with no horizons.
+                 * This is most useful if the Policy needs to be read from a
+                 * file, or built with pushStep().
+                 *
+                 * @param s The number of states of the world.
+                 * @param a The number of actions available to the agent.
+                 */
+                FiniteHorizonPolicy(size_t s, size_t a);
+
+                /**
+                 * @brief This function adds the actions for the next horizon.
+                 *
+                 * The first call sets the actions for horizon 1, the
+                 * second for horizon 2, and so on.
+                 *
+                 * If the actions do not have size S, or contain an action
+                 * which is not less than A, this function will throw an
+                 * std::invalid_argument.
+                 *
+                 * @param actions The action to take in each state.
+                 */
+                void pushStep(const Actions & actions);
+
+                /**
+                 * @brief This function returns the action to take in a state when horizon steps are missing.
+                 *
+                 * The horizon must be between 1 and getH(), otherwise this
+                 * function will throw an std::invalid_argument.
+                 *
+                 * @param s The selected state.
+                 * @param horizon The number of timesteps missing until the end of the episode.
+                 *
+                 * @return The action to take.
+                 */
+                size_t getAction(size_t s, unsigned horizon) const;
+
+                /**
+                 * @brief This function chooses the action for state s.
+                 *
+                 * Note that this will sample from the highest horizon that the
+                 * Policy contains. If the Policy contains no horizons yet,
+                 * the action is chosen uniformly at random.
+                 *
+                 * @param s The sampled state of the policy.
+                 *
+                 * @return The chosen action.
+                 */
+                virtual size_t sampleAction(const size_t & s) const override;
+
+                /**
+                 * @brief This function chooses the action for state s when horizon steps are missing.
+                 *
+                 * The horizon must be between 1 and getH(), otherwise this
+                 * function will throw an std::invalid_argument.
+                 *
+                 * @param s The sampled state of the policy.
+                 * @param horizon The number of timesteps missing until the end of the episode.
+                 *
+                 * @return The chosen action.
+                 */
+                size_t sampleAction(const size_t & s, unsigned horizon) const;
+
+                /**
+                 * @brief This function returns the probability of taking the specified action in the specified state.
+                 *
+                 * Note that this will use the highest horizon that the
+                 * Policy contains. If the Policy contains no horizons yet,
+                 * all actions have the same probability.
+                 *
+                 * @param s The selected state.
+                 * @param a The selected action.
+                 *
+                 * @return The probability of taking the selected action in the specified state.
+                 */
+                virtual double getActionProbability(const size_t & s, size_t a) const override;
+
+                /**
+                 * @brief This function returns the probability of taking the specified action in the specified state when horizon steps are missing.
+                 *
+                 * The horizon must be between 1 and getH(), otherwise this
+                 * function will throw an std::invalid_argument.
+                 *
+                 * @param s The selected state.
+                 * @param a The selected action.
+                 * @param horizon The number of timesteps missing until the end of the episode.
+                 *
+                 * @return The probability of taking the selected action in the specified state in the specified horizon.
+                 */
+                double getActionProbability(const size_t & s, size_t a, unsigned horizon) const;
+
+                /**
+                 * @brief This function returns a copy of the actions of a given horizon.
+                 *
+                 * @param horizon The number of timesteps missing until the end of the episode.
+                 *
+                 * @return The action to take in each state.
+                 */
+                Actions getStep(unsigned horizon) const;
+
+                /**
+                 * @brief This function returns the highest horizon available within this Policy.
+                 *
+                 * @return The highest horizon policied.
+                 */
+                size_t getH() const;
+
+                /**
+                 * @brief This function returns the number of horizons whose actions are actually stored.
+                 *
+                 * Horizons with the same actions as the previous one share
+                 * its storage, so this is the number of times the policy
+                 * changes, plus one.
+                 *
+                 * @return The number of distinct stored horizons.
+                 */
+                size_t getStoredSteps() const;
+
+            private:
+                using Word = std::uint64_t;
+
+                // Actions are packed into words, without crossing word
+                // boundaries, so that each lookup reads a single word.
+                unsigned bits_, perWord_;
+                size_t wordsPerStep_;
+                Word mask_;
+
+                std::vector<Word> words_;
+                // For each horizon, the index of its actions in words_.
+                std::vector<size_t> steps_;
+
+                friend std::istream& operator>>(std::istream &is, FiniteHorizonPolicy & p);
+        };
+
+        /**
+         * @brief This class writes a FiniteHorizonPolicy to a stream, one horizon at a time.
+         *
+         * This class can be passed directly as the callback of the
+         * FiniteHorizonValueIteration algorithm, so that each horizon is
+         * written as soon as it is computed, and the full Policy never
+         * needs to be kept in memory.
+         *
+         * The output starts with the number of horizons, followed by one
+         * line per horizon. Each line contains the horizon and the number
+         * of actions that follow it; if the actions are the same as the
+         * ones of the previous horizon, that number is zero and they are
+         * not written again.
+         */
+        class FiniteHorizonPolicyWriter {
+            public:
+                /**
+                 * @brief Basic constructor.
+                 *
+                 * @param os The stream where the policy is printed.
+                 * @param horizon The number of horizons that will be written.
+                 */
+                FiniteHorizonPolicyWriter(std::ostream & os, unsigned horizon);
+
+                /**
+                 * @brief This function writes the actions of a horizon.
+                 *
+                 * Horizons must be written in increasing order, starting
+                 * from 1.
+                 *
+                 * @param horizon The horizon being written.
+                 * @param actions The action to take in each state.
+                 */
+                void operator()(unsigned horizon, const Actions & actions);
+
+            private:
+                std::ostream & os_;
+                Actions last_;
+        };
+
+        /**
+         * @brief This function reads a policy from a file.
+         *
+         * This function reads files that have been outputted through
+         * operator<<() or FiniteHorizonPolicyWriter. If not enough values
+         * can be extracted from the stream, or the horizons are not in
+         * order, or the actions are out of range, the function stops and
+         * the input policy is not modified.
+         *
+         * @param is The stream were the policy is being read from.
+         * @param p The policy that is being assigned.
+         *
+         * @return The input stream.
+         */
+        std::istream& operator>>(std::istream &is, FiniteHorizonPolicy & p);
+
+        /**
+         * @brief This function prints the whole policy to a stream.
+         *
+         * The format is the one of FiniteHorizonPolicyWriter.
+         *
+         * @param os The stream where the policy is printed.
+         * @param p The policy that is begin printed.
+         *
+         * @return The original stream.
+         */
+        std::ostream& operator<<(std::ostream &os, const FiniteHorizonPolicy & p);
+    }
+}
+
+#endif
@@ -5,6 +5,8 @@
 #include <random>
 
 #include <AIToolbox/Types.hpp>
+#include <AIToolbox/FenwickTree.hpp>
+#include <AIToolbox/RandomEngine.hpp>
 #include <AIToolbox/MDP/Experience.hpp>
 
 namespace AIToolbox {
@@ -151,6 +153,12 @@ namespace AIToolbox {
                  * of the transition in the model. After a new state is picked, the reward
                  * is the corresponding reward contained in the reward function.
                  *
+                 * The new state is sampled in O(log S) from the visit counts
+                 * of the underlying Experience as they were at the last sync,
+                 * so sampling stays fast even when the model is being updated
+                 * after every step. State action pairs which have never been
+                 * synced are self-absorbing.
+                 *
                  * @param s The state that needs to be sampled.
                  * @param a The action that needs to be sampled.
                  *
@@ -158,6 +166,50 @@ namespace AIToolbox {
                  */
                 std::tuple<size_t, double> sampleSR(size_t s, size_t a) const;
 
+                /**
+                 * @brief This function samples the MDP for the specified state action pair, using the provided generator.
+                 *
+                 * This function is equivalent to sampleSR(size_t, size_t),
+                 * but it uses the supplied generator rather than the one
+                 * stored in the RLModel. As it does not modify the RLModel in any
+                 * way, it is safe to call it from multiple threads on the
+                 * same instance, as long as each thread uses its own
+                 * generator.
+                 *
+                 * @tparam G The type of the generator used.
+                 * @param s The state that needs to be sampled.
+                 * @param a The action that needs to be sampled.
+                 * @param generator The generator used to sample.
+                 *
+                 * @return A tuple containing a new state and a reward.
+                 */
+                template <typename G>
+                std::tuple<size_t, double> sampleSR(size_t s, size_t a, G & generator) const;
+
+                /**
+                 * @brief This function samples the MDP for many state action pairs at once.
+                 *
+                 * This function advances a batch of particles in lockstep.
+                 * It is equivalent to calling sampleSR(size_t, size_t, G&)
+                 * for each element of the input, but it avoids the
+                 * overhead of dispatching each sample separately.
+                 *
+                 * The output vectors are resized to the size of the input.
+                 * The same vector may be passed as both the input states and
+                 * the output states, in order to advance the particles in
+                 * place.
+                 *
+                 * @tparam G The type of the generator used.
+                 * @param states The states that need to be sampled.
+                 * @param actions The actions that need to be sampled, one per state.
+                 * @param next The output vector of sampled new states.
+                 * @param rewards The output vector of sampled rewards.
+                 * @param generator The generator used to sample.
+                 */
+                template <typename G>
+                void sampleSRBatch(const std::vector<size_t> & states, const std::vector<size_t> & actions,
+                                   std::vector<size_t> & next, std::vector<double> & rewards, G & generator) const;
+
                 /**
                  * @brief This function returns the number of states of the world.
                  *
@@ -258,8 +310,32 @@ namespace AIToolbox {
                 TransitionTable transitions_;
                 RewardTable rewards_;
 
-                mutable std::default_random_engine rand_;
+                // One tree over the synced visit counts for each state action pair.
+                std::vector<FenwickTree> samplers_;
+
+                mutable RandomEngine rand_;
         };
+
+        template <typename G>
+        std::tuple<size_t, double> RLModel::sampleSR(size_t s, size_t a, G & generator) const {
+            const auto & sampler = samplers_[s * A + a];
+            // Pairs which have never been synced are self-absorbing.
+            size_t s1 = sampler.getTotal() ? sampler.sample(generator) : s;
+
+            return std::make_tuple(s1, rewards_[a](s, s1));
+        }
+
+        template <typename G>
+        void RLModel::sampleSRBatch(const std::vector<size_t> & states, const std::vector<size_t> & actions,
+                                    std::vector<size_t> & next, std::vector<double> & rewards, G & generator) const
+        {
+            const size_t n = states.size();
+            next.resize(n);
+            rewards.resize(n);
+
+            for ( size_t i = 0; i < n; ++i )
+                std::tie(next[i], rewards[i]) = sampleSR(states[i], actions[i], generator);
+        }
     }
 }
 
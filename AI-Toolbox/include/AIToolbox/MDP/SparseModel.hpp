@@ -1,9 +1,11 @@
 #ifndef AI_TOOLBOX_MDP_SPARSE_MODEL_HEADER_FILE
 #define AI_TOOLBOX_MDP_SPARSE_MODEL_HEADER_FILE
 
+#include <AIToolbox/AliasTable.hpp>
 #include <AIToolbox/Impl/Seeder.hpp>
 
 #include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
 
 #include <AIToolbox/ProbabilityUtils.hpp>
 
@@ -77,6 +79,12 @@ namespace AIToolbox {
                  * course such a solution can be done only when the number of states
                  * and actions is not too big.
                  *
+                 * If the other model exposes its transition and reward
+                 * functions as Eigen matrices (see is_model_eigen), they
+                 * are copied and validated one whole matrix at a time, and
+                 * sparse ones are read by iterating only over their nonzero
+                 * elements.
+                 *
                  * @tparam M The type of the other model.
                  * @param model The model that needs to be copied.
                  */
@@ -127,6 +135,25 @@ namespace AIToolbox {
                 template <typename R>
                 void setRewardFunction(const R & r);
 
+                /**
+                 * @brief This function replaces the SparseModel reward function with the expected reward of each state action pair.
+                 *
+                 * After this call, the SparseModel only stores R(s,a), and
+                 * so getExpectedReward(s, a, s1) returns R(s,a) for all s1
+                 * (see setCompactRewards()).
+                 *
+                 * The container needs to support data access through
+                 * operator[]. In addition, the dimensions of the container
+                 * must match the ones provided as arguments (for two
+                 * dimensions: s,a). A Matrix2D of size SxA, like a
+                 * QFunction, can also be used.
+                 *
+                 * @tparam R The external rewards container type.
+                 * @param r The external rewards container.
+                 */
+                template <typename R>
+                void setExpectedRewardFunction(const R & r);
+
                 /**
                  * @brief This function sets a new discount factor for the Model.
                  *
@@ -134,6 +161,44 @@ namespace AIToolbox {
                  */
                 void setDiscount(double d);
 
+                /**
+                 * @brief This function enables or disables alias sampling of the transition function.
+                 *
+                 * By default sampleSR() picks the next state by scanning the
+                 * non-zero entries of the appropriate row of the transition
+                 * function.
+                 *
+                 * When alias sampling is enabled, the SparseModel
+                 * precomputes an alias table for each state-action pair, and
+                 * samples from it in O(1). The tables take memory
+                 * proportional to the number of non-zero transitions, and are
+                 * rebuilt every time the transition function is replaced.
+                 *
+                 * @param alias Whether sampleSR() should use alias tables.
+                 */
+                void setAliasSampling(bool alias);
+
+                /**
+                 * @brief This function selects whether rewards are stored as R(s,a) or R(s,a,s').
+                 *
+                 * By default the SparseModel stores a reward for each
+                 * non-zero transition, together with the expected reward of
+                 * each state action pair.
+                 *
+                 * When compact rewards are enabled, only the expected reward
+                 * of each state action pair is kept, and the sparse reward
+                 * matrices are freed. getExpectedReward(s, a, s1) and
+                 * sampleSR() then return R(s,a), and getRewardFunction()
+                 * returns empty matrices; algorithms should use
+                 * getExpectedRewardFunction() instead.
+                 *
+                 * Disabling compact rewards stores R(s,a) for every
+                 * non-zero transition.
+                 *
+                 * @param compact Whether only R(s,a) should be stored.
+                 */
+                void setCompactRewards(bool compact);
+
                 /**
                  * @brief This function samples the MDP for the specified state action pair.
                  *
@@ -154,6 +219,52 @@ namespace AIToolbox {
                  */
                 std::tuple<size_t, double> sampleSR(size_t s, size_t a) const;
 
+                /**
+                 * @brief This function samples the MDP for the specified state action pair, using the provided generator.
+                 *
+                 * This function is equivalent to sampleSR(size_t, size_t),
+                 * but it uses the supplied generator rather than the one
+                 * stored in the SparseModel. As it does not modify the SparseModel in any
+                 * way, it is safe to call it from multiple threads on the
+                 * same instance, as long as each thread uses its own
+                 * generator.
+                 *
+                 * @tparam G The type of the generator used.
+                 * @param s The state that needs to be sampled.
+                 * @param a The action that needs to be sampled.
+                 * @param generator The generator used to sample.
+                 *
+                 * @return A tuple containing a new state and a reward.
+                 */
+                template <typename G>
+                std::tuple<size_t, double> sampleSR(size_t s, size_t a, G & generator) const;
+
+                /**
+                 * @brief This function samples the MDP for many state action pairs at once.
+                 *
+                 * This function advances a batch of particles in lockstep.
+                 * It is equivalent to calling sampleSR(size_t, size_t, G&)
+                 * for each element of the input, but it draws all
+                 * random numbers first, and then resolves them with alias
+                 * table lookups in a second tight loop when alias sampling
+                 * is enabled, which avoids most of the per-call overhead.
+                 *
+                 * The output vectors are resized to the size of the input.
+                 * The same vector may be passed as both the input states and
+                 * the output states, in order to advance the particles in
+                 * place.
+                 *
+                 * @tparam G The type of the generator used.
+                 * @param states The states that need to be sampled.
+                 * @param actions The actions that need to be sampled, one per state.
+                 * @param next The output vector of sampled new states.
+                 * @param rewards The output vector of sampled rewards.
+                 * @param generator The generator used to sample.
+                 */
+                template <typename G>
+                void sampleSRBatch(const std::vector<size_t> & states, const std::vector<size_t> & actions,
+                                   std::vector<size_t> & next, std::vector<double> & rewards, G & generator) const;
+
                 /**
                  * @brief This function returns the number of states of the world.
                  *
@@ -229,6 +340,20 @@ namespace AIToolbox {
                  */
                 const SparseMatrix2D & getRewardFunction(size_t a) const;
 
+                /**
+                 * @brief This function returns the expected reward of each state action pair.
+                 *
+                 * @return A matrix SxA containing R(s,a).
+                 */
+                const Matrix2D & getExpectedRewardFunction() const;
+
+                /**
+                 * @brief This function returns whether rewards are only stored as R(s,a).
+                 *
+                 * @return True if compact rewards are enabled, false otherwise.
+                 */
+                bool getCompactRewards() const;
+
                 /**
                  * @brief This function returns whether a given state is a terminal.
                  *
@@ -238,31 +363,95 @@ namespace AIToolbox {
                  */
                 bool isTerminal(size_t s) const;
 
+                /**
+                 * @brief This function returns whether alias sampling is enabled.
+                 *
+                 * @return True if sampleSR() uses alias tables, false otherwise.
+                 */
+                bool getAliasSampling() const;
+
             private:
                 size_t S, A;
                 double discount_;
 
                 TransitionTable transitions_;
                 RewardTable rewards_;
+                Matrix2D expectedRewards_;
+                bool compactRewards_;
 
-                mutable std::default_random_engine rand_;
+                bool aliasSampling_;
+                std::vector<AliasTable> transitionSamplers_;
+
+                mutable RandomEngine rand_;
+
+                /**
+                 * @brief This function recomputes the expected rewards from the transition and reward functions.
+                 *
+                 * It does nothing when compact rewards are enabled.
+                 */
+                void computeExpectedRewards();
+
+                /**
+                 * @brief This function copies the transition and reward functions of another model.
+                 *
+                 * @param model The model that needs to be copied.
+                 */
+                template <typename M, typename std::enable_if<is_model_eigen<M>::value, int>::type = 0>
+                void copyModel(const M & model);
+
+#ifndef DOXYGEN_SKIP
+                template <typename M, typename std::enable_if<!is_model_eigen<M>::value, int>::type = 0>
+                void copyModel(const M & model);
+#endif
 
                 friend std::istream& operator>>(std::istream &is, SparseModel &);
         };
 
         template <typename T, typename R>
         SparseModel::SparseModel(size_t s, size_t a, const T & t, const R & r, double d) : S(s), A(a), transitions_(A, SparseMatrix2D(S, S)), rewards_(A, SparseMatrix2D(S, S)),
-                                                                                           rand_(Impl::Seeder::getSeed())
+                                                                                           expectedRewards_(S, A), compactRewards_(false),
+                                                                                           aliasSampling_(false), rand_(Impl::Seeder::getSeed())
         {
             setDiscount(d);
             setTransitionFunction(t);
             setRewardFunction(r);
         }
 
+        template <>
+        inline void SparseModel::setExpectedRewardFunction(const Matrix2D & r) {
+            if ( static_cast<size_t>(r.rows()) != S || static_cast<size_t>(r.cols()) != A )
+                throw std::invalid_argument("Expected reward function must have size S x A");
+            expectedRewards_ = r;
+
+            setCompactRewards(true);
+        }
+
         template <typename M, typename std::enable_if<is_model<M>::value, int>::type>
         SparseModel::SparseModel(const M& model) : S(model.getS()), A(model.getA()), discount_(model.getDiscount()), transitions_(A, SparseMatrix2D(S, S)), rewards_(A, SparseMatrix2D(S, S)),
-                                       rand_(Impl::Seeder::getSeed())
+                                       expectedRewards_(S, A), compactRewards_(false),
+                                       aliasSampling_(false), rand_(Impl::Seeder::getSeed())
         {
+            copyModel(model);
+        }
+
+        template <typename M, typename std::enable_if<is_model_eigen<M>::value, int>::type>
+        void SparseModel::copyModel(const M & model) {
+            for ( size_t a = 0; a < A; ++a ) {
+                copySparseMatrix2D(model.getTransitionFunction(a), transitions_[a]);
+                if ( ! isProbabilityMatrix(transitions_[a]) ) throw std::invalid_argument("Input transition table does not contain valid probabilities.");
+            }
+            // Compact rewards are kept compact.
+            if ( hasCompactRewards(model) ) {
+                setExpectedRewardFunction(computeImmediateRewards(model));
+                return;
+            }
+            for ( size_t a = 0; a < A; ++a )
+                copySparseMatrix2D(model.getRewardFunction(a), rewards_[a]);
+            computeExpectedRewards();
+        }
+
+        template <typename M, typename std::enable_if<!is_model_eigen<M>::value, int>::type>
+        void SparseModel::copyModel(const M & model) {
             for ( size_t s = 0; s < S; ++s )
                 for ( size_t a = 0; a < A; ++a ) {
                     for ( size_t s1 = 0; s1 < S; ++s1 ) {
@@ -274,6 +463,7 @@ namespace AIToolbox {
                     }
                     if ( checkDifferentSmall(1.0, transitions_[a].row(s).sum()) ) throw std::invalid_argument("Input transition table does not contain valid probabilities.");
                 }
+            computeExpectedRewards();
         }
 
         template <typename T>
@@ -282,23 +472,80 @@ namespace AIToolbox {
             for ( size_t s = 0; s < S; ++s )
                 for ( size_t a = 0; a < A; ++a )
                     if ( ! isProbability(S, t[s][a]) ) throw std::invalid_argument("Input transition table does not contain valid probabilities.");
-            // Then we copy.
+            // Then we copy. Old entries are dropped first, as insert()
+            // cannot overwrite them.
+            for ( auto & m : transitions_ ) m.setZero();
             for ( size_t s = 0; s < S; ++s )
                 for ( size_t a = 0; a < A; ++a )
                     for ( size_t s1 = 0; s1 < S; ++s1 ) {
                         double p = t[s][a][s1];
                         if ( checkDifferentSmall(0.0, p) ) transitions_[a].insert(s, s1) = p;
                     }
+
+            computeExpectedRewards();
+            if ( aliasSampling_ ) setAliasSampling(true);
+        }
+
+        template <typename G>
+        std::tuple<size_t, double> SparseModel::sampleSR(size_t s, size_t a, G & generator) const {
+            size_t s1 = aliasSampling_ ? transitionSamplers_[a].sampleRow(s, generator) :
+                                         sampleProbability(S, transitions_[a].row(s), generator);
+
+            return std::make_tuple(s1, getExpectedReward(s, a, s1));
+        }
+
+        template <typename G>
+        void SparseModel::sampleSRBatch(const std::vector<size_t> & states, const std::vector<size_t> & actions,
+                                        std::vector<size_t> & next, std::vector<double> & rewards, G & generator) const
+        {
+            const size_t n = states.size();
+            next.resize(n);
+            rewards.resize(n);
+
+            if ( !aliasSampling_ ) {
+                for ( size_t i = 0; i < n; ++i )
+                    std::tie(next[i], rewards[i]) = sampleSR(states[i], actions[i], generator);
+                return;
+            }
+
+            // First we draw all random numbers, and then we resolve them
+            // with the alias tables. Rewards are used as scratch space.
+            std::uniform_real_distribution<double> sampleDistribution(0.0, 1.0);
+            for ( auto & u : rewards ) u = sampleDistribution(generator);
+
+            for ( size_t i = 0; i < n; ++i ) {
+                const size_t s = states[i], a = actions[i];
+                const size_t s1 = transitionSamplers_[a].sampleRow(s, rewards[i]);
+                next[i] = s1;
+                rewards[i] = getExpectedReward(s, a, s1);
+            }
         }
 
         template <typename R>
         void SparseModel::setRewardFunction( const R & r ) {
+            if ( compactRewards_ ) {
+                rewards_.assign(A, SparseMatrix2D(S, S));
+                compactRewards_ = false;
+            } else {
+                for ( auto & m : rewards_ ) m.setZero();
+            }
             for ( size_t s = 0; s < S; ++s )
                 for ( size_t a = 0; a < A; ++a )
                     for ( size_t s1 = 0; s1 < S; ++s1 ) {
                         double w = r[s][a][s1];
                         if ( checkDifferentSmall(0.0, w) ) rewards_[a].insert(s, s1) = w;
                     }
+
+            computeExpectedRewards();
+        }
+
+        template <typename R>
+        void SparseModel::setExpectedRewardFunction(const R & r) {
+            for ( size_t s = 0; s < S; ++s )
+                for ( size_t a = 0; a < A; ++a )
+                    expectedRewards_(s, a) = r[s][a];
+
+            setCompactRewards(true);
         }
     }
 }
@@ -0,0 +1,414 @@
+#ifndef AI_TOOLBOX_MDP_TENSOR_MODEL_HEADER_FILE
+#define AI_TOOLBOX_MDP_TENSOR_MODEL_HEADER_FILE
+
+#include <random>
+#include <vector>
+
+#include <AIToolbox/Types.hpp>
+#include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
+#include <AIToolbox/Utils.hpp>
+#include <AIToolbox/ProbabilityUtils.hpp>
+#include <AIToolbox/Impl/Seeder.hpp>
+
+namespace AIToolbox {
+    namespace MDP {
+        /**
+         * @brief This enum represents the orders in which a TensorModel can store its SxAxS' tables.
+         */
+        enum TensorLayout {
+            // Element (s,a,s1) is at (s*A + a)*S + s1: all transitions of a state are contiguous.
+            STATE_MAJOR,
+            // Element (s,a,s1) is at (a*S + s)*S + s1: all transitions of an action are contiguous.
+            ACTION_MAJOR,
+        };
+
+        /**
+         * @brief This class represents a Markov Decision Process stored in contiguous tensors.
+         *
+         * This class offers the same functionality as Model, but it stores
+         * the transition and reward functions in a single buffer each,
+         * rather than in one heap allocation per action. The layout of the
+         * buffers can be chosen at construction (see TensorLayout).
+         *
+         * With STATE_MAJOR layout, everything that concerns a single state
+         * (the rows of all actions, as returned by getStateTransitions())
+         * is contiguous in memory, which helps algorithms that work one
+         * state at a time, like GaussSeidelValueIteration or
+         * PrioritizedSweeping. With ACTION_MAJOR layout each action matrix
+         * is contiguous, which is best for algorithms that multiply whole
+         * action matrices, like ValueIteration.
+         *
+         * getTransitionFunction() and getRewardFunction() return Eigen
+         * Map views into the buffers, so all Eigen algorithms can use
+         * this class directly.
+         */
+        class TensorModel {
+            public:
+                using MatrixView = Eigen::Map<const Matrix2D, Eigen::Unaligned, Eigen::OuterStride<>>;
+
+                /**
+                 * @brief Basic constructor.
+                 *
+                 * This constructor initializes the TensorModel so that all
+                 * transitions happen with probability 0 but for transitions
+                 * that bring back to the same state, no matter the action.
+                 *
+                 * All rewards are set to 0.
+                 *
+                 * @param s The number of states of the world.
+                 * @param a The number of actions available to the agent.
+                 * @param discount The discount factor for the MDP.
+                 * @param layout The order in which the tables are stored.
+                 */
+                TensorModel(size_t s, size_t a, double discount = 1.0, TensorLayout layout = STATE_MAJOR);
+
+                /**
+                 * @brief Basic constructor.
+                 *
+                 * This constructor takes two arbitrary three dimensional
+                 * containers and tries to copy their contents into the
+                 * transitions and rewards tables respectively.
+                 *
+                 * The containers need to support data access through
+                 * operator[]. In addition, the dimensions of the containers
+                 * must match the ones provided as arguments (for three
+                 * dimensions: s,a,s).
+                 *
+                 * This is important, as this constructor DOES NOT perform any
+                 * size checks on the external containers.
+                 *
+                 * In addition, the transition container must contain a valid
+                 * transition function, and the discount parameter must be
+                 * between 0 and 1 included, otherwise the constructor will
+                 * throw an std::invalid_argument.
+                 *
+                 * @tparam T The external transition container type.
+                 * @tparam R The external rewards container type.
+                 * @param s The number of states of the world.
+                 * @param a The number of actions available to the agent.
+                 * @param t The external transitions container.
+                 * @param r The external rewards container.
+                 * @param d The discount factor for the MDP.
+                 * @param layout The order in which the tables are stored.
+                 */
+                template <typename T, typename R>
+                TensorModel(size_t s, size_t a, const T & t, const R & r, double d = 1.0, TensorLayout layout = STATE_MAJOR);
+
+                /**
+                 * @brief This constructor copies from any other MDP model.
+                 *
+                 * Models which expose Eigen matrices are copied one whole
+                 * action matrix at a time.
+                 *
+                 * @tparam M The type of the other model.
+                 * @param model The model that needs to be copied.
+                 * @param layout The order in which the tables are stored.
+                 */
+                template <typename M, typename std::enable_if<is_model<M>::value, int>::type = 0>
+                TensorModel(const M & model, TensorLayout layout = STATE_MAJOR);
+
+                /**
+                 * @brief Copy constructor.
+                 *
+                 * The Eigen views of the copy point to its own buffers.
+                 *
+                 * @param other The TensorModel to copy.
+                 */
+                TensorModel(const TensorModel & other);
+
+                /**
+                 * @brief Copy assignment operator.
+                 *
+                 * @param other The TensorModel to copy.
+                 *
+                 * @return This TensorModel.
+                 */
+                TensorModel & operator=(const TensorModel & other);
+
+                /**
+                 * @brief This function replaces the TensorModel transition function with the one provided.
+                 *
+                 * The container needs to support data access through
+                 * operator[]. In addition, the dimensions of the
+                 * containers must match the ones provided as arguments
+                 * (for three dimensions: s,a,s).
+                 *
+                 * Currently the TensorModel is not updated if the new
+                 * transition function is invalid, in which case this
+                 * function throws an std::invalid_argument.
+                 *
+                 * @tparam T The external transition container type.
+                 * @param t The external transitions container.
+                 */
+                template <typename T>
+                void setTransitionFunction(const T & t);
+
+                /**
+                 * @brief This function replaces the TensorModel reward function with the one provided.
+                 *
+                 * The container needs to support data access through
+                 * operator[]. In addition, the dimensions of the
+                 * containers must match the ones provided as arguments
+                 * (for three dimensions: s,a,s).
+                 *
+                 * @tparam R The external rewards container type.
+                 * @param r The external rewards container.
+                 */
+                template <typename R>
+                void setRewardFunction(const R & r);
+
+                /**
+                 * @brief This function sets a new discount factor for the TensorModel.
+                 *
+                 * @param d The new discount factor for the TensorModel.
+                 */
+                void setDiscount(double d);
+
+                /**
+                 * @brief This function samples the MDP for the specified state action pair.
+                 *
+                 * @param s The state that needs to be sampled.
+                 * @param a The action that needs to be sampled.
+                 *
+                 * @return A tuple containing a new state and a reward.
+                 */
+                std::tuple<size_t, double> sampleSR(size_t s, size_t a) const;
+
+                /**
+                 * @brief This function samples the MDP for the specified state action pair using the provided generator.
+                 *
+                 * @tparam G The type of the random engine.
+                 * @param s The state that needs to be sampled.
+                 * @param a The action that needs to be sampled.
+                 * @param generator The random engine to use.
+                 *
+                 * @return A tuple containing a new state and a reward.
+                 */
+                template <typename G>
+                std::tuple<size_t, double> sampleSR(size_t s, size_t a, G & generator) const;
+
+                /**
+                 * @brief This function returns the number of states of the world.
+                 *
+                 * @return The total number of states.
+                 */
+                size_t getS() const;
+
+                /**
+                 * @brief This function returns the number of available actions to the agent.
+                 *
+                 * @return The total number of actions.
+                 */
+                size_t getA() const;
+
+                /**
+                 * @brief This function returns the currently set discount factor.
+                 *
+                 * @return The currently set discount factor.
+                 */
+                double getDiscount() const;
+
+                /**
+                 * @brief This function returns the order in which the tables are stored.
+                 *
+                 * @return The layout of the TensorModel.
+                 */
+                TensorLayout getLayout() const;
+
+                /**
+                 * @brief This function returns the stored transition probability for the specified transition.
+                 *
+                 * @param s The initial state of the transition.
+                 * @param a The action performed in the transition.
+                 * @param s1 The final state of the transition.
+                 *
+                 * @return The probability of the specified transition.
+                 */
+                double getTransitionProbability(size_t s, size_t a, size_t s1) const;
+
+                /**
+                 * @brief This function returns the stored expected reward for the specified transition.
+                 *
+                 * @param s The initial state of the transition.
+                 * @param a The action performed in the transition.
+                 * @param s1 The final state of the transition.
+                 *
+                 * @return The expected reward of the specified transition.
+                 */
+                double getExpectedReward(size_t s, size_t a, size_t s1) const;
+
+                /**
+                 * @brief This function returns the transition function for a given action.
+                 *
+                 * @param a The action requested.
+                 *
+                 * @return A SxS' view of the transition function for the input action.
+                 */
+                const MatrixView & getTransitionFunction(size_t a) const;
+
+                /**
+                 * @brief This function returns the reward function for a given action.
+                 *
+                 * @param a The action requested.
+                 *
+                 * @return A SxS' view of the reward function for the input action.
+                 */
+                const MatrixView & getRewardFunction(size_t a) const;
+
+                /**
+                 * @brief This function returns the transition function for a given state.
+                 *
+                 * With STATE_MAJOR layout the returned view covers a
+                 * single contiguous block of memory.
+                 *
+                 * @param s The state requested.
+                 *
+                 * @return A AxS' view of the transitions from the input state.
+                 */
+                MatrixView getStateTransitions(size_t s) const;
+
+                /**
+                 * @brief This function returns the reward function for a given state.
+                 *
+                 * @param s The state requested.
+                 *
+                 * @return A AxS' view of the rewards from the input state.
+                 */
+                MatrixView getStateRewards(size_t s) const;
+
+                /**
+                 * @brief This function returns whether a given state is a terminal.
+                 *
+                 * @param s The state examined.
+                 *
+                 * @return True if the input state is a terminal, false otherwise.
+                 */
+                bool isTerminal(size_t s) const;
+
+            private:
+                using MutableView = Eigen::Map<Matrix2D, Eigen::Unaligned, Eigen::OuterStride<>>;
+
+                /**
+                 * @brief This function returns the position of an element in the buffers.
+                 */
+                size_t index(size_t s, size_t a, size_t s1) const;
+
+                /**
+                 * @brief This function returns a writable view of an action matrix in a buffer.
+                 */
+                MutableView actionView(Vector & buffer, size_t a);
+
+                /**
+                 * @brief This function points the action views to the buffers of this TensorModel.
+                 */
+                void makeViews();
+
+                /**
+                 * @brief This function copies the transition and reward functions of another model.
+                 *
+                 * @param model The model that needs to be copied.
+                 */
+                template <typename M, typename std::enable_if<is_model_eigen<M>::value, int>::type = 0>
+                void copyModel(const M & model);
+
+#ifndef DOXYGEN_SKIP
+                template <typename M, typename std::enable_if<!is_model_eigen<M>::value, int>::type = 0>
+                void copyModel(const M & model);
+#endif
+
+                size_t S, A;
+                double discount_;
+                TensorLayout layout_;
+
+                Vector transitions_, rewards_;
+                std::vector<MatrixView> transitionViews_, rewardViews_;
+
+                mutable RandomEngine rand_;
+        };
+
+        template <typename T, typename R>
+        TensorModel::TensorModel(size_t s, size_t a, const T & t, const R & r, double d, TensorLayout layout) :
+                S(s), A(a), layout_(layout), transitions_(Vector::Zero(S * A * S)), rewards_(Vector::Zero(S * A * S)),
+                rand_(Impl::Seeder::getSeed())
+        {
+            makeViews();
+            setDiscount(d);
+            setTransitionFunction(t);
+            setRewardFunction(r);
+        }
+
+        template <typename M, typename std::enable_if<is_model<M>::value, int>::type>
+        TensorModel::TensorModel(const M & model, TensorLayout layout) :
+                S(model.getS()), A(model.getA()), discount_(model.getDiscount()), layout_(layout),
+                transitions_(S * A * S), rewards_(S * A * S), rand_(Impl::Seeder::getSeed())
+        {
+            makeViews();
+            copyModel(model);
+        }
+
+        template <typename M, typename std::enable_if<is_model_eigen<M>::value, int>::type>
+        void TensorModel::copyModel(const M & model) {
+            for ( size_t a = 0; a < A; ++a ) {
+                actionView(transitions_, a) = model.getTransitionFunction(a);
+                if ( ! isProbabilityMatrix(transitionViews_[a]) ) throw std::invalid_argument("Input transition table does not contain valid probabilities.");
+            }
+            // Compact models have no SxS reward matrices, so their R(s,a)
+            // is used for all s'.
+            if ( hasCompactRewards(model) ) {
+                const auto ir = computeImmediateRewards(model);
+                for ( size_t a = 0; a < A; ++a )
+                    actionView(rewards_, a) = ir.col(a).replicate(1, S);
+                return;
+            }
+            for ( size_t a = 0; a < A; ++a )
+                actionView(rewards_, a) = model.getRewardFunction(a);
+        }
+
+        template <typename M, typename std::enable_if<!is_model_eigen<M>::value, int>::type>
+        void TensorModel::copyModel(const M & model) {
+            for ( size_t s = 0; s < S; ++s ) {
+                for ( size_t a = 0; a < A; ++a ) {
+                    for ( size_t s1 = 0; s1 < S; ++s1 ) {
+                        transitions_[index(s, a, s1)] = model.getTransitionProbability(s, a, s1);
+                        rewards_    [index(s, a, s1)] = model.getExpectedReward       (s, a, s1);
+                    }
+                    if ( ! isProbability(S, transitionViews_[a].row(s)) ) throw std::invalid_argument("Input transition table does not contain valid probabilities.");
+                }
+            }
+        }
+
+        template <typename T>
+        void TensorModel::setTransitionFunction(const T & t) {
+            for ( size_t s = 0; s < S; ++s )
+                for ( size_t a = 0; a < A; ++a )
+                    if ( ! isProbability(S, t[s][a]) ) throw std::invalid_argument("Input transition table does not contain valid probabilities.");
+
+            for ( size_t s = 0; s < S; ++s )
+                for ( size_t a = 0; a < A; ++a )
+                    for ( size_t s1 = 0; s1 < S; ++s1 )
+                        transitions_[index(s, a, s1)] = t[s][a][s1];
+        }
+
+        template <typename R>
+        void TensorModel::setRewardFunction( const R & r ) {
+            for ( size_t s = 0; s < S; ++s )
+                for ( size_t a = 0; a < A; ++a )
+                    for ( size_t s1 = 0; s1 < S; ++s1 )
+                        rewards_[index(s, a, s1)] = r[s][a][s1];
+        }
+
+        template <typename G>
+        std::tuple<size_t, double> TensorModel::sampleSR(size_t s, size_t a, G & generator) const {
+            const size_t s1 = sampleProbability(S, transitionViews_[a].row(s), generator);
+
+            return std::make_tuple(s1, rewards_[index(s, a, s1)]);
+        }
+
+        inline size_t TensorModel::index(size_t s, size_t a, size_t s1) const {
+            return (layout_ == STATE_MAJOR ? s * A + a : a * S + s) * S + s1;
+        }
+    }
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include <AIToolbox/Types.hpp>
+#include <AIToolbox/RandomEngine.hpp>
 
 namespace AIToolbox {
     namespace MDP {
@@ -92,6 +93,81 @@ namespace AIToolbox {
                 enum { value = std::is_same<decltype(test<M>(0)),std::true_type>::value };
         };
 
+        /**
+         * @brief This struct represents the interface for a generative MDP which can use external generators.
+         *
+         * This struct is used to check interfaces of classes in templates.
+         * In particular, this struct tests whether a generative MDP model
+         * can be sampled with a generator supplied by the caller, rather
+         * than with one stored in the model itself. Such models can be
+         * shared between threads, each using its own generator. The
+         * interface is the following:
+         *
+         * - std::tuple<size_t, double> sampleSR(size_t s, size_t a, G & generator) const : Returns a sampled state-reward pair from (s,a) using the input generator.
+         *
+         * In addition the MDP needs to respect the interface for the MDP generative model.
+         *
+         * \sa MDP::is_generative_model
+         *
+         * is_generative_model_engine<M, G>::value will be equal to true is M implements the interface,
+         * and false otherwise.
+         *
+         * @tparam M The class to test for the interface.
+         * @tparam G The generator type which needs to be supported.
+         */
+        template <typename M, typename G = RandomEngine>
+        struct is_generative_model_engine {
+            private:
+                template <typename Z> static auto test(int) -> decltype(
+
+                        static_cast<std::tuple<size_t, double>>(std::declval<const Z&>().sampleSR(size_t(), size_t(), std::declval<G&>())),
+
+                        std::true_type()
+                );
+
+                template <typename Z> static auto test(...) -> std::false_type;
+
+            public:
+                enum { value = std::is_same<decltype(test<M>(0)),std::true_type>::value && is_generative_model<M>::value };
+        };
+
+        /**
+         * @brief This struct represents the interface for a generative MDP which can be sampled in batches.
+         *
+         * This struct is used to check interfaces of classes in templates.
+         * In particular, this struct tests whether a generative MDP model
+         * can advance many state-action pairs at once, stored as separate
+         * vectors. The interface is the following:
+         *
+         * - void sampleSRBatch(const std::vector<size_t> & states, const std::vector<size_t> & actions, std::vector<size_t> & next, std::vector<double> & rewards, G & generator) const : Samples a state-reward pair for each input pair.
+         *
+         * In addition the MDP needs to respect the interface for the MDP generative model.
+         *
+         * \sa MDP::is_generative_model
+         *
+         * is_generative_model_batch<M, G>::value will be equal to true is M implements the interface,
+         * and false otherwise.
+         *
+         * @tparam M The class to test for the interface.
+         * @tparam G The generator type which needs to be supported.
+         */
+        template <typename M, typename G = RandomEngine>
+        struct is_generative_model_batch {
+            private:
+                template <typename Z> static auto test(int) -> decltype(
+
+                        std::declval<const Z&>().sampleSRBatch(std::declval<const std::vector<size_t>&>(), std::declval<const std::vector<size_t>&>(),
+                                                               std::declval<std::vector<size_t>&>(), std::declval<std::vector<double>&>(), std::declval<G&>()),
+
+                        std::true_type()
+                );
+
+                template <typename Z> static auto test(...) -> std::false_type;
+
+            public:
+                enum { value = std::is_same<decltype(test<M>(0)),std::true_type>::value && is_generative_model<M>::value };
+        };
+
         /**
          * @brief This struct represents the required interface for a full MDP.
          *
@@ -190,6 +266,44 @@ namespace AIToolbox {
                 enum { value = is_model<M>::value && std::is_same<decltype(test<M>(0)),std::true_type>::value &&
                                std::is_base_of<Eigen::EigenBase<F>, F>::value && std::is_base_of<Eigen::EigenBase<R>, R>::value };
         };
+
+        /**
+         * @brief This struct represents the required interface for models which store the expected reward of each state action pair.
+         *
+         * This struct is used to check interfaces of classes in templates.
+         * In particular, this struct tests for the interface of an MDP model
+         * which can store its rewards as R(s,a), rather than R(s,a,s').
+         * The interface must be implemented and be public in the parameter
+         * class. The interface is the following:
+         *
+         * - const Matrix2D & getExpectedRewardFunction() const : Returns the expected reward of each state action pair, as a matrix SxA.
+         * - bool getCompactRewards() const : Returns whether the rewards are only stored as R(s,a).
+         *
+         * In addition the MDP needs to respect the interface for the Eigen MDP model.
+         *
+         * \sa MDP::is_model_eigen
+         *
+         * is_model_expected_rewards<M>::value will be equal to true is M implements the interface,
+         * and false otherwise.
+         *
+         * @tparam M The class to test for the interface.
+         */
+        template <typename M>
+        struct is_model_expected_rewards {
+            private:
+                template <typename Z> static auto test(int) -> decltype(
+
+                        static_cast<const Matrix2D & (Z::*)() const>        (&Z::getExpectedRewardFunction),
+                        static_cast<bool (Z::*)() const>                    (&Z::getCompactRewards),
+
+                        std::true_type()
+                );
+
+                template <typename> static auto test(...) -> std::false_type;
+
+            public:
+                enum { value = is_model_eigen<M>::value && std::is_same<decltype(test<M>(0)),std::true_type>::value };
+        };
     }
 }
 
@@ -2,12 +2,209 @@
 #define AI_TOOLBOX_MDP_UTILS_HEADER_FILE
 
 #include <stddef.h>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
 #include <AIToolbox/MDP/Types.hpp>
 
 namespace AIToolbox {
     namespace MDP {
         QFunction     makeQFunction    (size_t S, size_t A);
         ValueFunction makeValueFunction(size_t S);
+
+        /**
+         * @brief This function samples a generative model with the provided generator, if possible.
+         *
+         * Algorithms which sample models should call this function rather
+         * than the sampleSR member function, so that models which support
+         * external generators can be shared read-only between threads.
+         *
+         * If the model does not support sampling with an external
+         * generator, this function falls back to sampleSR(s, a), which uses
+         * the generator internal to the model.
+         *
+         * \sa is_generative_model_engine
+         *
+         * @tparam M The type of the model.
+         * @tparam G The type of the generator.
+         * @param model The model to sample.
+         * @param s The state that needs to be sampled.
+         * @param a The action that needs to be sampled.
+         * @param generator The generator to use, if the model supports it.
+         *
+         * @return A tuple containing a new state and a reward.
+         */
+        template <typename M, typename G, typename std::enable_if<is_generative_model_engine<M, G>::value, int>::type = 0>
+        std::tuple<size_t, double> sampleSR(const M & model, size_t s, size_t a, G & generator) {
+            return model.sampleSR(s, a, generator);
+        }
+
+#ifndef DOXYGEN_SKIP
+        template <typename M, typename G, typename std::enable_if<!is_generative_model_engine<M, G>::value, int>::type = 0>
+        std::tuple<size_t, double> sampleSR(const M & model, size_t s, size_t a, G &) {
+            return model.sampleSR(s, a);
+        }
+#endif
+
+        /**
+         * @brief This function samples a generative model for many state action pairs at once.
+         *
+         * If the model provides a batch sampling function, this function
+         * calls it. Otherwise, it samples each pair separately with
+         * sampleSR(const M &, size_t, size_t, G &).
+         *
+         * The output vectors are resized to the size of the input. The
+         * same vector may be passed as both the input states and the output
+         * states, in order to advance a set of particles in place.
+         *
+         * \sa is_generative_model_batch
+         *
+         * @tparam M The type of the model.
+         * @tparam G The type of the generator.
+         * @param model The model to sample.
+         * @param states The states that need to be sampled.
+         * @param actions The actions that need to be sampled, one per state.
+         * @param next The output vector of sampled new states.
+         * @param rewards The output vector of sampled rewards.
+         * @param generator The generator to use, if the model supports it.
+         */
+        template <typename M, typename G, typename std::enable_if<is_generative_model_batch<M, G>::value, int>::type = 0>
+        void sampleSRBatch(const M & model, const std::vector<size_t> & states, const std::vector<size_t> & actions,
+                           std::vector<size_t> & next, std::vector<double> & rewards, G & generator)
+        {
+            model.sampleSRBatch(states, actions, next, rewards, generator);
+        }
+
+#ifndef DOXYGEN_SKIP
+        template <typename M, typename G, typename std::enable_if<!is_generative_model_batch<M, G>::value, int>::type = 0>
+        void sampleSRBatch(const M & model, const std::vector<size_t> & states, const std::vector<size_t> & actions,
+                           std::vector<size_t> & next, std::vector<double> & rewards, G & generator)
+        {
+            const size_t n = states.size();
+            next.resize(n);
+            rewards.resize(n);
+
+            for ( size_t i = 0; i < n; ++i )
+                std::tie(next[i], rewards[i]) = sampleSR(model, states[i], actions[i], generator);
+        }
+#endif
+
+        /**
+         * @brief This function computes the expected immediate reward of each state action pair of a model.
+         *
+         * Models which store their expected rewards (see
+         * is_model_expected_rewards) return them directly. Other Eigen
+         * models multiply their transition and reward functions, and all
+         * other models are read one element at a time.
+         *
+         * @tparam M The type of the model.
+         * @param model The model to read.
+         *
+         * @return A QFunction containing the expected reward of each state action pair.
+         */
+        template <typename M, typename std::enable_if<is_model_expected_rewards<M>::value, int>::type = 0>
+        QFunction computeImmediateRewards(const M & model) {
+            return model.getExpectedRewardFunction();
+        }
+
+#ifndef DOXYGEN_SKIP
+        template <typename M, typename std::enable_if<is_model_eigen<M>::value && !is_model_expected_rewards<M>::value, int>::type = 0>
+        QFunction computeImmediateRewards(const M & model) {
+            const size_t S = model.getS(), A = model.getA();
+            QFunction ir = makeQFunction(S, A);
+
+            for ( size_t a = 0; a < A; ++a )
+                ir.col(a).noalias() = model.getTransitionFunction(a).cwiseProduct(model.getRewardFunction(a)) * Vector::Ones(S);
+
+            return ir;
+        }
+
+        template <typename M, typename std::enable_if<is_model<M>::value && !is_model_eigen<M>::value, int>::type = 0>
+        QFunction computeImmediateRewards(const M & model) {
+            const size_t S = model.getS(), A = model.getA();
+            QFunction ir = makeQFunction(S, A);
+
+            for ( size_t s = 0; s < S; ++s )
+                for ( size_t a = 0; a < A; ++a )
+                    for ( size_t s1 = 0; s1 < S; ++s1 )
+                        ir(s, a) += model.getTransitionProbability(s, a, s1) * model.getExpectedReward(s, a, s1);
+
+            return ir;
+        }
+#endif
+
+        /**
+         * @brief This function computes the expected immediate reward of a single state action pair of an Eigen model.
+         *
+         * @tparam M The type of the model.
+         * @param model The model to read.
+         * @param s The state.
+         * @param a The action.
+         *
+         * @return The expected reward of the state action pair.
+         */
+        template <typename M, typename std::enable_if<is_model_expected_rewards<M>::value, int>::type = 0>
+        double computeImmediateReward(const M & model, size_t s, size_t a) {
+            return model.getExpectedRewardFunction()(s, a);
+        }
+
+#ifndef DOXYGEN_SKIP
+        template <typename M, typename std::enable_if<is_model_eigen<M>::value && !is_model_expected_rewards<M>::value, int>::type = 0>
+        double computeImmediateReward(const M & model, size_t s, size_t a) {
+            return model.getTransitionFunction(a).row(s).dot(model.getRewardFunction(a).row(s));
+        }
+#endif
+
+        /**
+         * @brief This function returns whether a model only stores its rewards as R(s,a).
+         *
+         * @tparam M The type of the model.
+         * @param model The model to read.
+         *
+         * @return True if the model stores compact rewards, false otherwise.
+         */
+        template <typename M, typename std::enable_if<is_model_expected_rewards<M>::value, int>::type = 0>
+        bool hasCompactRewards(const M & model) {
+            return model.getCompactRewards();
+        }
+
+#ifndef DOXYGEN_SKIP
+        template <typename M, typename std::enable_if<!is_model_expected_rewards<M>::value, int>::type = 0>
+        bool hasCompactRewards(const M &) {
+            return false;
+        }
+#endif
+
+        /**
+         * @brief This function calls a function on all the non-zero entries of a row of a dense matrix.
+         *
+         * This function, together with its sparse overload, allows
+         * algorithms to walk the successors of a state in an Eigen
+         * transition function without knowing how the matrix is stored.
+         *
+         * @param m The matrix to read.
+         * @param row The row to walk.
+         * @param f The function called as f(column, value) for each non-zero entry.
+         */
+        template <typename D, typename F>
+        void forEachNonZero(const Eigen::MatrixBase<D> & m, size_t row, F f) {
+            for ( size_t col = 0; col < static_cast<size_t>(m.cols()); ++col )
+                if ( m(row, col) != 0.0 ) f(col, m(row, col));
+        }
+
+        /**
+         * @brief This function calls a function on all the non-zero entries of a row of a sparse matrix.
+         *
+         * @param m The matrix to read.
+         * @param row The row to walk.
+         * @param f The function called as f(column, value) for each non-zero entry.
+         */
+        template <typename F>
+        void forEachNonZero(const SparseMatrix2D & m, size_t row, F f) {
+            for ( SparseMatrix2D::InnerIterator it(m, row); it; ++it )
+                if ( it.value() != 0.0 ) f(static_cast<size_t>(it.col()), it.value());
+        }
     }
 }
 
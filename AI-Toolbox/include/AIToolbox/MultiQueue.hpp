@@ -0,0 +1,142 @@
+#ifndef AI_TOOLBOX_MULTI_QUEUE_HEADER_FILE
+#define AI_TOOLBOX_MULTI_QUEUE_HEADER_FILE
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <AIToolbox/IndexedHeap.hpp>
+#include <AIToolbox/RandomEngine.hpp>
+
+namespace AIToolbox {
+    /**
+     * @brief This class represents a relaxed concurrent max priority queue over the indices 0 to n-1.
+     *
+     * A MultiQueue is made of several IndexedHeap, each protected by its
+     * own lock. Each index is stored in at most one of them. Pushes go to
+     * a random heap, and pops pick two random heaps and pop from the one
+     * with the highest top priority. Threads thus rarely compete for the
+     * same lock, at the cost of not always popping the highest priority
+     * in the queue: the popped index is, with high probability, among the
+     * highest few.
+     *
+     * Each thread passes its own RandomEngine to push() and pop(), so
+     * that no random state is shared between threads.
+     *
+     * All functions but clear() and setQueues() can be called
+     * concurrently. Since each index is in at most one heap, all heaps
+     * share a single array for the positions of the indices, and each
+     * heap only grows with the indices it holds. The memory used is thus
+     * proportional to n, regardless of the number of heaps.
+     */
+    class MultiQueue {
+        public:
+            /**
+             * @brief Basic constructor.
+             *
+             * A good number of heaps is twice the number of threads
+             * which use the queue.
+             *
+             * @param n The number of indices that can be stored in the queue.
+             * @param queues The number of heaps.
+             */
+            MultiQueue(size_t n, unsigned queues);
+
+            /**
+             * @brief This function inserts an index in the queue, or raises its priority if it is already in it.
+             *
+             * If the index is already queued with a higher priority,
+             * nothing changes.
+             *
+             * @param i The index to insert.
+             * @param priority The priority of the index.
+             * @param rand The random engine of the calling thread.
+             */
+            void push(size_t i, double priority, RandomEngine & rand);
+
+            /**
+             * @brief This function removes an index with one of the highest priorities from the queue.
+             *
+             * @param i The popped index is written here.
+             * @param rand The random engine of the calling thread.
+             *
+             * @return False if the queue was empty, true otherwise.
+             */
+            bool pop(size_t * i, RandomEngine & rand);
+
+            /**
+             * @brief This function removes all indices from the queue.
+             *
+             * This function must not be called concurrently with others.
+             */
+            void clear();
+
+            /**
+             * @brief This function returns the number of indices in the queue.
+             *
+             * @return The number of indices in the queue.
+             */
+            size_t size() const;
+
+            /**
+             * @brief This function returns whether the queue is empty.
+             *
+             * @return True if the queue is empty, false otherwise.
+             */
+            bool empty() const;
+
+            /**
+             * @brief This function changes the number of heaps.
+             *
+             * The indices in the queue are kept, spread over the new
+             * heaps. This function must not be called concurrently with
+             * others.
+             *
+             * @param queues The new number of heaps. At least one heap is always used.
+             */
+            void setQueues(unsigned queues);
+
+            /**
+             * @brief This function returns the number of heaps.
+             *
+             * @return The number of heaps.
+             */
+            unsigned getQueues() const;
+
+        private:
+            struct Queue {
+                explicit Queue(size_t * positions);
+
+                std::mutex mutex;
+                IndexedHeap<> heap;
+                // A copy of the top priority, so that pop() can choose
+                // a heap without locking it.
+                std::atomic<double> top;
+            };
+
+            /**
+             * @brief This function refreshes the cached top priority of a heap.
+             *
+             * The lock of the heap must be held.
+             */
+            static void updateTop(Queue & q);
+
+            /**
+             * @brief This function pops from a heap, if it is not empty.
+             */
+            bool popFrom(size_t h, size_t * i);
+
+            std::vector<std::unique_ptr<Queue>> queues_;
+            // The heap holding each index, or none if it is not queued.
+            std::unique_ptr<std::atomic<unsigned>[]> owners_;
+            // The position of each index in the heap holding it.
+            std::unique_ptr<size_t[]> positions_;
+            std::atomic<size_t> size_;
+            size_t n_;
+            static constexpr unsigned none = static_cast<unsigned>(-1);
+    };
+}
+
+#endif
@@ -136,7 +136,7 @@ namespace AIToolbox {
                 unsigned horizon_;
                 double epsilon_;
 
-                mutable std::default_random_engine rand_;
+                mutable RandomEngine rand_;
         };
 
         template <typename M, typename std::enable_if<is_model<M>::value, int>::type>
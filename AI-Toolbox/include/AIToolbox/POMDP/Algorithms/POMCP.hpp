@@ -1,12 +1,16 @@
 #ifndef AI_TOOLBOX_POMDP_POMCP_HEADER_FILE
 #define AI_TOOLBOX_POMDP_POMCP_HEADER_FILE
 
+#include <AIToolbox/MDP/Utils.hpp>
 #include <AIToolbox/POMDP/Types.hpp>
+#include <AIToolbox/POMDP/Utils.hpp>
 #include <AIToolbox/ProbabilityUtils.hpp>
+#include <AIToolbox/SearchTree.hpp>
 #include <AIToolbox/Impl/Seeder.hpp>
 
-#include <unordered_map>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
 
 namespace AIToolbox {
     namespace POMDP {
@@ -63,29 +67,22 @@ namespace AIToolbox {
          * reinvigoration method, which would introduce noise in the particle
          * beliefs in order to keep them "fresh" (possibly using domain
          * knowledge).
+         *
+         * The tree is a SearchTree, where the children of each action are
+         * indexed by the sampled observation. Its memory, including the
+         * particle beliefs, is reused between calls to sampleAction().
          */
         template <typename M>
         class POMCP<M> {
             public:
                 using SampleBelief = std::vector<size_t>;
 
-                struct BeliefNode;
-                using BeliefNodes = std::unordered_map<size_t, BeliefNode>;
-
-                struct ActionNode {
-                    BeliefNodes children;
-                    double V = 0.0;
-                    unsigned N = 0;
-                };
-                using ActionNodes = std::vector<ActionNode>;
-
-                struct BeliefNode {
-                    BeliefNode() : N(0) {}
-                    BeliefNode(size_t s) : belief(1, s), N(0) {}
-                    ActionNodes children;
+                struct BeliefData {
                     SampleBelief belief;
-                    unsigned N;
                 };
+                using Graph = SearchTree<BeliefData>;
+                using BeliefNode = typename Graph::Node;
+                using ActionNode = typename Graph::ActionNode;
 
                 /**
                  * @brief Basic constructor.
@@ -111,6 +108,22 @@ namespace AIToolbox {
                  */
                 size_t sampleAction(const Belief& b, unsigned horizon);
 
+                /**
+                 * @brief This function resets the internal graph and samples for the provided particle belief and horizon.
+                 *
+                 * This function is like sampleAction(const Belief&, unsigned),
+                 * but the particles of the root are provided directly,
+                 * for example to start several planners from the same
+                 * particles. The particle belief must not be empty,
+                 * otherwise the function will throw an std::invalid_argument.
+                 *
+                 * @param particles The initial particle belief for the environment.
+                 * @param horizon The horizon to plan for.
+                 *
+                 * @return The best action.
+                 */
+                size_t sampleAction(const SampleBelief& particles, unsigned horizon);
+
                 /**
                  * @brief This function uses the internal graph to plan.
                  *
@@ -167,6 +180,33 @@ namespace AIToolbox {
                  */
                 void setExploration(double exp);
 
+                /**
+                 * @brief This function sets the number of particles used in each rollout.
+                 *
+                 * By default each rollout follows a single trajectory. When
+                 * more particles are used, each rollout advances all of
+                 * them in lockstep from the newly expanded node, each with
+                 * its own random actions, and returns their average
+                 * discounted reward. This reduces the variance of the
+                 * leaf estimates, and allows models which support batch
+                 * sampling to amortize the cost of each step over all
+                 * particles.
+                 *
+                 * Note that this changes the estimator: with k particles
+                 * each leaf value is the mean of k random rollouts, while
+                 * the simulation still counts as a single visit of the
+                 * nodes it went through. The steps of a single trajectory
+                 * depend on each other and cannot be batched, so with the
+                 * default of 1 the batch interface is never used, and
+                 * results are exactly the same as with models which do
+                 * not provide it.
+                 *
+                 * \sa MDP::is_generative_model_batch
+                 *
+                 * @param particles The new number of particles, at least 1.
+                 */
+                void setRolloutParticles(unsigned particles);
+
                 /**
                  * @brief This function returns the POMDP generative model being used.
                  *
@@ -177,9 +217,18 @@ namespace AIToolbox {
                 /**
                  * @brief This function returns a reference to the internal graph structure holding the results of rollouts.
                  *
+                 * The graph is a SearchTree, where nodes refer to each other by
+                 * index. This replaces the previous nested BeliefNode structure,
+                 * where each node held its action nodes and their children in
+                 * `children` members, so code walking the graph must be ported.
+                 * The root is getRoot() (index 0), the statistics of an action
+                 * of a node are getAction(node, a), and the child reached
+                 * through an action and an observation is getChild(node, a,
+                 * key), or can be found with forEachChild().
+                 *
                  * @return The internal graph.
                  */
-                const BeliefNode& getGraph() const;
+                const Graph& getGraph() const;
 
                 /**
                  * @brief This function returns the initial particle size for converted Beliefs.
@@ -202,16 +251,27 @@ namespace AIToolbox {
                  */
                 double getExploration() const;
 
+                /**
+                 * @brief This function returns the number of particles used in each rollout.
+                 *
+                 * @return The number of rollout particles.
+                 */
+                unsigned getRolloutParticles() const;
+
             private:
                 const M& model_;
                 size_t S, A, beliefSize_;
-                unsigned iterations_, maxDepth_;
+                unsigned iterations_, maxDepth_, rolloutParticles_;
                 double exploration_;
 
                 SampleBelief sampleBelief_;
-                BeliefNode graph_;
+                Graph graph_;
+
+                // Buffers for batched rollouts, to avoid reallocations.
+                std::vector<size_t> particles_, actions_;
+                std::vector<double> rewards_;
 
-                mutable std::default_random_engine rand_;
+                mutable RandomEngine rand_;
 
                 /**
                  * @brief This function starts the simulation process.
@@ -244,13 +304,13 @@ namespace AIToolbox {
                  * update particle beliefs within the tree and the value
                  * estimations for those beliefs.
                  *
-                 * @param b The tree node to simulate from.
+                 * @param node The index of the tree node to simulate from.
                  * @param s The state from which we are simulating, possibly a particle of a previous particle belief.
                  * @param horizon The depth within the tree already reached.
                  *
                  * @return The discounted reward obtained from the simulation performed from here to the end.
                  */
-                double simulate(BeliefNode & b, size_t s, unsigned horizon);
+                double simulate(size_t node, size_t s, unsigned horizon);
 
                 /**
                  * @brief This function implements the rollout policy for POMCP.
@@ -271,6 +331,9 @@ namespace AIToolbox {
                  * again, while at the same time still getting an estimate for
                  * the rest of the simulation.
                  *
+                 * If more than one rollout particle is set, the returned
+                 * value is the average over all particles.
+                 *
                  * @param s The state from which to start the rollout.
                  * @param horizon The horizon already reached while simulating inside the tree.
                  *
@@ -320,46 +383,51 @@ namespace AIToolbox {
 
         template <typename M>
         POMCP<M>::POMCP(const M& m, size_t beliefSize, unsigned iter, double exp) : model_(m), S(model_.getS()), A(model_.getA()), beliefSize_(beliefSize), iterations_(iter),
-                                                                              exploration_(exp), graph_(), rand_(Impl::Seeder::getSeed()) {}
+                                                                              rolloutParticles_(1), exploration_(exp), graph_(A), rand_(Impl::Seeder::getSeed()) {}
 
         template <typename M>
         size_t POMCP<M>::sampleAction(const Belief& b, unsigned horizon) {
             // Reset graph
-            graph_ = BeliefNode(A);
-            graph_.children.resize(A);
-            graph_.belief = makeSampledBelief(b);
+            graph_.reset();
+            graph_.expand(0);
+            graph_.getRoot().belief = makeSampledBelief(b);
 
             return runSimulation(horizon);
         }
 
         template <typename M>
-        size_t POMCP<M>::sampleAction(size_t a, size_t o, unsigned horizon) {
-            auto & obs = graph_.children[a].children;
+        size_t POMCP<M>::sampleAction(const SampleBelief& particles, unsigned horizon) {
+            if ( particles.empty() ) throw std::invalid_argument("The particle belief must not be empty");
+
+            // Reset graph
+            graph_.reset();
+            graph_.expand(0);
+            graph_.getRoot().belief = particles;
+
+            return runSimulation(horizon);
+        }
 
-            auto it = obs.find(o);
-            if ( it == obs.end() ) {
+        template <typename M>
+        size_t POMCP<M>::sampleAction(size_t a, size_t o, unsigned horizon) {
+            const size_t child = graph_.getChild(0, a, o);
+            if ( child == Graph::npos ) {
                 std::cerr << "Observation " << o << " never experienced in simulation, restarting with uniform belief..\n";
                 auto b = Belief(S); b.fill(1.0/S);
                 return sampleAction(b, horizon);
             }
 
-            // Here we need an additional step, because *it is contained by graph_.
-            // If we just move assign, graph_ is first going to delete everything it
-            // contains (included *it), and then we are going to move unallocated memory
-            // into graph_! So we move *it outside of the graph_ hierarchy, so that
-            // we can then assign safely.
-            { auto tmp = std::move(it->second); graph_ = std::move(tmp); }
+            graph_.reroot(child);
 
-            if ( ! graph_.belief.size() ) {
+            if ( ! graph_.getRoot().belief.size() ) {
                 std::cerr << "POMCP Lost track of the belief, restarting with uniform..\n";
                 auto b = Belief(S); b.fill(1.0/S);
                 return sampleAction(b, horizon);
             }
 
-            // We resize here in case we didn't have time to sample the new
+            // We expand here in case we didn't have time to sample the new
             // head node. In this case, the new head may not have children.
             // This would break the UCT call.
-            graph_.children.resize(A);
+            graph_.expand(0);
 
             return runSimulation(horizon);
         }
@@ -369,41 +437,41 @@ namespace AIToolbox {
             if ( !horizon ) return 0;
 
             maxDepth_ = horizon;
-            std::uniform_int_distribution<size_t> generator(0, graph_.belief.size()-1);
+            std::uniform_int_distribution<size_t> generator(0, graph_.getRoot().belief.size()-1);
 
             for (unsigned i = 0; i < iterations_; ++i )
-                simulate(graph_, graph_.belief.at(generator(rand_)), 0);
+                simulate(0, graph_.getRoot().belief.at(generator(rand_)), 0);
 
-            auto begin = std::begin(graph_.children);
-            return std::distance(begin, findBestA(begin, std::end(graph_.children)));
+            auto begin = graph_.getActions(0);
+            return std::distance(begin, findBestA(begin, begin + A));
         }
 
         template <typename M>
-        double POMCP<M>::simulate(BeliefNode & b, size_t s, unsigned depth) {
-            b.N++;
+        double POMCP<M>::simulate(size_t node, size_t s, unsigned depth) {
+            const unsigned count = ++graph_.getNode(node).N;
 
-            auto begin = std::begin(b.children);
-            size_t a = std::distance(begin, findBestBonusA(begin, std::end(b.children), b.N));
+            auto begin = graph_.getActions(node);
+            size_t a = std::distance(begin, findBestBonusA(begin, begin + A, count));
 
             size_t s1, o; double rew;
-            std::tie(s1, o, rew) = model_.sampleSOR(s, a);
-
-            auto & aNode = b.children[a];
+            std::tie(s1, o, rew) = sampleSOR(model_, s, a, rand_);
 
             {
                 double futureRew = 0.0;
                 // We need to append the node anyway to perform the belief
                 // update for the next timestep.
-                auto ot = aNode.children.find(o);
-                if ( ot == std::end(aNode.children) ) {
-                    aNode.children.emplace(std::piecewise_construct,
-                                           std::forward_as_tuple(o),
-                                           std::forward_as_tuple(s1));
+                const size_t child = graph_.getChild(node, a, o);
+                if ( child == Graph::npos ) {
+                    // The memory of the node may be reused, so its belief
+                    // needs to be cleared.
+                    auto & belief = graph_.getNode(graph_.addChild(node, a, o)).belief;
+                    belief.clear();
+                    belief.push_back(s1);
                     // This stops automatically if we go out of depth
                     futureRew = rollout(s1, depth + 1);
                 }
                 else {
-                    ot->second.belief.push_back(s1);
+                    graph_.getNode(child).belief.push_back(s1);
                     // We only go deeper if needed (maxDepth_ is always at least 1).
                     if ( depth + 1 < maxDepth_ && !model_.isTerminal(s1) ) {
                         // Since most memory is allocated on the leaves,
@@ -411,15 +479,17 @@ namespace AIToolbox {
                         // we are actually descending into a node. If the node
                         // already has memory this should not do anything in
                         // any case.
-                        ot->second.children.resize(A);
-                        futureRew = simulate( ot->second, s1, depth + 1 );
+                        graph_.expand(child);
+                        futureRew = simulate( child, s1, depth + 1 );
                     }
                 }
 
                 rew += model_.getDiscount() * futureRew;
             }
 
-            // Action update
+            // Action update; the tree may have grown, so we only get the
+            // action node now.
+            auto & aNode = graph_.getAction(node, a);
             aNode.N++;
             aNode.V += ( rew - aNode.V ) / static_cast<double>(aNode.N);
 
@@ -431,13 +501,30 @@ namespace AIToolbox {
             double rew = 0.0, totalRew = 0.0, gamma = 1.0;
 
             std::uniform_int_distribution<size_t> generator(0, A-1);
+            if ( rolloutParticles_ == 1 ) {
+                for ( ; depth < maxDepth_; ++depth ) {
+                    std::tie( s, rew ) = MDP::sampleSR( model_, s, generator(rand_), rand_ );
+
+                    totalRew += gamma * rew;
+                    gamma *= model_.getDiscount();
+                }
+                return totalRew;
+            }
+
+            // All particles start from the same state, and are advanced
+            // together one step at a time. Observations are not needed here.
+            particles_.assign(rolloutParticles_, s);
+            actions_.resize(rolloutParticles_);
             for ( ; depth < maxDepth_; ++depth ) {
-                std::tie( s, rew ) = model_.sampleSR( s, generator(rand_) );
+                for ( auto & a : actions_ ) a = generator(rand_);
+                MDP::sampleSRBatch( model_, particles_, actions_, particles_, rewards_, rand_ );
 
+                for ( auto r : rewards_ ) rew += r;
                 totalRew += gamma * rew;
+                rew = 0.0;
                 gamma *= model_.getDiscount();
             }
-            return totalRew;
+            return totalRew / rolloutParticles_;
         }
 
         template <typename M>
@@ -498,13 +585,19 @@ namespace AIToolbox {
             exploration_ = exp;
         }
 
+        template <typename M>
+        void POMCP<M>::setRolloutParticles(unsigned particles) {
+            if ( !particles ) throw std::invalid_argument("The number of rollout particles must be at least 1");
+            rolloutParticles_ = particles;
+        }
+
         template <typename M>
         const M& POMCP<M>::getModel() const {
             return model_;
         }
 
         template <typename M>
-        const typename POMCP<M>::BeliefNode& POMCP<M>::getGraph() const {
+        const typename POMCP<M>::Graph& POMCP<M>::getGraph() const {
             return graph_;
         }
 
@@ -522,6 +615,11 @@ namespace AIToolbox {
         double POMCP<M>::getExploration() const {
             return exploration_;
         }
+
+        template <typename M>
+        unsigned POMCP<M>::getRolloutParticles() const {
+            return rolloutParticles_;
+        }
     }
 }
 
@@ -0,0 +1,384 @@
+#ifndef AI_TOOLBOX_POMDP_ROOT_PARALLEL_POMCP_HEADER_FILE
+#define AI_TOOLBOX_POMDP_ROOT_PARALLEL_POMCP_HEADER_FILE
+
+#include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/POMDP/Types.hpp>
+#include <AIToolbox/POMDP/Algorithms/POMCP.hpp>
+#include <AIToolbox/ProbabilityUtils.hpp>
+#include <AIToolbox/Impl/Seeder.hpp>
+
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace AIToolbox {
+    namespace POMDP {
+
+#ifndef DOXYGEN_SKIP
+        // This is done to avoid bringing around the enable_if everywhere.
+        template <typename M, typename = typename std::enable_if<is_generative_model<M>::value>::type>
+        class RootParallelPOMCP;
+#endif
+
+        /**
+         * @brief This class represents an ensemble of POMCP planners running in parallel.
+         *
+         * The tree of POMCP is hard to share between threads, since every
+         * simulation appends particles to the beliefs of the nodes it
+         * traverses. Instead, this class runs several independent POMCP
+         * planners, each with its own tree and random generator, on
+         * separate threads (root parallelization).
+         *
+         * All trees start from the same particle belief. Once they are done,
+         * the statistics of the root actions are merged: the count of each
+         * action is the sum of its counts in all trees, and its value is the
+         * average of its values weighted by these counts. The action with
+         * the best merged value is returned.
+         *
+         * When the action and observation of the last timestep are provided,
+         * each tree re-roots on the corresponding branch, like
+         * POMCP::sampleAction(size_t, size_t, unsigned) does. A tree which
+         * never experienced the observation restarts from the particles of
+         * the trees which did.
+         *
+         * Since each tree is only ever used by its own thread with its own
+         * generator, the results only depend on the seeds of the trees, and
+         * not on how the threads are scheduled.
+         *
+         * Running the trees on more than one thread requires a model which
+         * can be sampled with an external generator, so that it can be
+         * shared between them.
+         *
+         * \sa POMDP::is_generative_model_engine
+         * \sa MDP::is_generative_model_engine
+         */
+        template <typename M>
+        class RootParallelPOMCP<M> {
+            public:
+                using Tree = POMCP<M>;
+                using SampleBelief = typename Tree::SampleBelief;
+
+                /**
+                 * @brief Basic constructor.
+                 *
+                 * @param m The POMDP model that the trees will operate upon.
+                 * @param beliefSize The size of the initial particle belief.
+                 * @param iterations The number of episodes each tree runs before completion.
+                 * @param exp The exploration constant of each tree.
+                 * @param trees The number of trees, each run on its own thread.
+                 */
+                RootParallelPOMCP(const M& m, size_t beliefSize, unsigned iterations, double exp, unsigned trees);
+
+                /**
+                 * @brief This function resets all trees and samples for the provided belief and horizon.
+                 *
+                 * The belief is approximated by a single particle belief,
+                 * which is then used as the root of all trees.
+                 *
+                 * @param b The initial belief for the environment.
+                 * @param horizon The horizon to plan for.
+                 *
+                 * @return The best action for the merged root statistics.
+                 */
+                size_t sampleAction(const Belief& b, unsigned horizon);
+
+                /**
+                 * @brief This function re-roots all trees on the provided action and observation and plans.
+                 *
+                 * Each tree that contains the branch for the provided action
+                 * and observation re-roots on it. Trees which do not contain
+                 * it restart from the union of the particles of that branch
+                 * in the other trees. If no tree experienced the
+                 * observation, all trees restart from a uniform belief.
+                 *
+                 * @param a The action taken in the last timestep.
+                 * @param o The observation received in the last timestep.
+                 * @param horizon The horizon to plan for.
+                 *
+                 * @return The best action for the merged root statistics.
+                 */
+                size_t sampleAction(size_t a, size_t o, unsigned horizon);
+
+                /**
+                 * @brief This function sets the new size for initial beliefs created from sampleAction().
+                 *
+                 * @param beliefSize The new particle belief size.
+                 */
+                void setBeliefSize(size_t beliefSize);
+
+                /**
+                 * @brief This function sets the number of performed rollouts in each tree.
+                 *
+                 * @param iter The new number of rollouts per tree.
+                 */
+                void setIterations(unsigned iter);
+
+                /**
+                 * @brief This function sets the new exploration constant of each tree.
+                 *
+                 * @param exp The new exploration constant.
+                 */
+                void setExploration(double exp);
+
+                /**
+                 * @brief This function sets the number of particles used in each rollout by each tree.
+                 *
+                 * \sa POMCP::setRolloutParticles
+                 *
+                 * @param particles The new number of particles, at least 1.
+                 */
+                void setRolloutParticles(unsigned particles);
+
+                /**
+                 * @brief This function returns the POMDP generative model being used.
+                 *
+                 * @return The POMDP generative model.
+                 */
+                const M& getModel() const;
+
+                /**
+                 * @brief This function returns the number of trees in the ensemble.
+                 *
+                 * @return The number of trees.
+                 */
+                unsigned getTrees() const;
+
+                /**
+                 * @brief This function returns a reference to one of the trees of the ensemble.
+                 *
+                 * @param i The index of the tree, less than getTrees().
+                 *
+                 * @return The POMCP planner owning the tree.
+                 */
+                const Tree& getTree(unsigned i) const;
+
+                /**
+                 * @brief This function returns the initial particle size for converted Beliefs.
+                 *
+                 * @return The initial particle count.
+                 */
+                size_t getBeliefSize() const;
+
+                /**
+                 * @brief This function returns the number of iterations performed by each tree to plan for an action.
+                 *
+                 * @return The number of iterations per tree.
+                 */
+                unsigned getIterations() const;
+
+                /**
+                 * @brief This function returns the currently set exploration constant.
+                 *
+                 * @return The exploration constant.
+                 */
+                double getExploration() const;
+
+                /**
+                 * @brief This function returns the number of particles used in each rollout.
+                 *
+                 * @return The number of rollout particles.
+                 */
+                unsigned getRolloutParticles() const;
+
+            private:
+                const M& model_;
+                size_t S, A, beliefSize_;
+
+                std::vector<Tree> trees_;
+                std::vector<size_t> actions_;
+
+                RandomEngine rand_;
+
+                /**
+                 * @brief This function calls the input function once per tree, each on its own thread.
+                 *
+                 * The function is called with the index of the tree. The
+                 * first tree is run on the calling thread. All threads are
+                 * joined before returning, and if any call throws, the
+                 * exception of the lowest index is rethrown on the calling
+                 * thread.
+                 *
+                 * @param f The function to call.
+                 */
+                template <typename F>
+                void forEachTree(F f);
+
+                /**
+                 * @brief This function finds the best action from the merged root statistics of all trees.
+                 *
+                 * @return The action with the highest count-weighted value.
+                 */
+                size_t findBestA() const;
+        };
+
+        template <typename M>
+        RootParallelPOMCP<M>::RootParallelPOMCP(const M& m, size_t beliefSize, unsigned iter, double exp, unsigned trees) :
+                model_(m), S(model_.getS()), A(model_.getA()), beliefSize_(beliefSize), actions_(trees), rand_(Impl::Seeder::getSeed())
+        {
+            if ( !trees ) throw std::invalid_argument("The number of trees must be at least 1");
+            if ( trees > 1 && !(is_generative_model_engine<M>::value && MDP::is_generative_model_engine<M>::value) )
+                throw std::invalid_argument("Running on multiple threads requires a model which can be sampled with an external generator");
+
+            // Each tree takes its own seed from the Seeder.
+            trees_.reserve(trees);
+            for ( unsigned i = 0; i < trees; ++i )
+                trees_.emplace_back(model_, beliefSize, iter, exp);
+        }
+
+        template <typename M>
+        size_t RootParallelPOMCP<M>::sampleAction(const Belief& b, unsigned horizon) {
+            SampleBelief particles;
+            particles.reserve(beliefSize_);
+            for ( size_t i = 0; i < beliefSize_; ++i )
+                particles.push_back(sampleProbability(S, b, rand_));
+
+            forEachTree([&](unsigned i){ actions_[i] = trees_[i].sampleAction(particles, horizon); });
+
+            return findBestA();
+        }
+
+        template <typename M>
+        size_t RootParallelPOMCP<M>::sampleAction(size_t a, size_t o, unsigned horizon) {
+            SampleBelief particles;
+            for ( const auto & tree : trees_ ) {
+                const auto & graph = tree.getGraph();
+                const size_t child = graph.getChild(0, a, o);
+                if ( child == Tree::Graph::npos ) continue;
+
+                const auto & belief = graph.getNode(child).belief;
+                particles.insert(std::end(particles), std::begin(belief), std::end(belief));
+            }
+
+            if ( particles.empty() ) {
+                std::cerr << "Observation " << o << " never experienced in simulation, restarting with uniform belief..\n";
+                auto b = Belief(S); b.fill(1.0/S);
+                return sampleAction(b, horizon);
+            }
+
+            forEachTree([&](unsigned i){
+                auto & tree = trees_[i];
+                if ( tree.getGraph().getChild(0, a, o) != Tree::Graph::npos )
+                    actions_[i] = tree.sampleAction(a, o, horizon);
+                else
+                    actions_[i] = tree.sampleAction(particles, horizon);
+            });
+
+            return findBestA();
+        }
+
+        template <typename M>
+        template <typename F>
+        void RootParallelPOMCP<M>::forEachTree(F f) {
+            std::vector<std::exception_ptr> errors(trees_.size());
+            auto run = [&f, &errors](unsigned i) {
+                try {
+                    f(i);
+                } catch ( ... ) {
+                    errors[i] = std::current_exception();
+                }
+            };
+
+            std::vector<std::thread> threads;
+            threads.reserve(trees_.size() - 1);
+            try {
+                for ( unsigned i = 1; i < trees_.size(); ++i )
+                    threads.emplace_back(run, i);
+            } catch ( ... ) {
+                // Threads which were started must be joined before their
+                // destructors run, or the program terminates.
+                for ( auto & thread : threads )
+                    thread.join();
+                throw;
+            }
+
+            run(0);
+
+            for ( auto & thread : threads )
+                thread.join();
+
+            for ( const auto & error : errors )
+                if ( error ) std::rethrow_exception(error);
+        }
+
+        template <typename M>
+        size_t RootParallelPOMCP<M>::findBestA() const {
+            // Actions never tried have a value of 0, as in POMCP.
+            size_t bestA = 0;
+            double bestV = 0.0;
+            for ( size_t a = 0; a < A; ++a ) {
+                double v = 0.0; unsigned n = 0;
+                for ( const auto & tree : trees_ ) {
+                    const auto & aNode = tree.getGraph().getAction(0, a);
+                    v += aNode.N * aNode.V;
+                    n += aNode.N;
+                }
+                if ( n ) v /= n;
+                if ( a == 0 || v > bestV ) {
+                    bestA = a;
+                    bestV = v;
+                }
+            }
+            return bestA;
+        }
+
+        template <typename M>
+        void RootParallelPOMCP<M>::setBeliefSize(size_t beliefSize) {
+            beliefSize_ = beliefSize;
+            for ( auto & tree : trees_ ) tree.setBeliefSize(beliefSize);
+        }
+
+        template <typename M>
+        void RootParallelPOMCP<M>::setIterations(unsigned iter) {
+            for ( auto & tree : trees_ ) tree.setIterations(iter);
+        }
+
+        template <typename M>
+        void RootParallelPOMCP<M>::setExploration(double exp) {
+            for ( auto & tree : trees_ ) tree.setExploration(exp);
+        }
+
+        template <typename M>
+        void RootParallelPOMCP<M>::setRolloutParticles(unsigned particles) {
+            for ( auto & tree : trees_ ) tree.setRolloutParticles(particles);
+        }
+
+        template <typename M>
+        const M& RootParallelPOMCP<M>::getModel() const {
+            return model_;
+        }
+
+        template <typename M>
+        unsigned RootParallelPOMCP<M>::getTrees() const {
+            return trees_.size();
+        }
+
+        template <typename M>
+        const typename RootParallelPOMCP<M>::Tree& RootParallelPOMCP<M>::getTree(unsigned i) const {
+            return trees_.at(i);
+        }
+
+        template <typename M>
+        size_t RootParallelPOMCP<M>::getBeliefSize() const {
+            return beliefSize_;
+        }
+
+        template <typename M>
+        unsigned RootParallelPOMCP<M>::getIterations() const {
+            return trees_[0].getIterations();
+        }
+
+        template <typename M>
+        double RootParallelPOMCP<M>::getExploration() const {
+            return trees_[0].getExploration();
+        }
+
+        template <typename M>
+        unsigned RootParallelPOMCP<M>::getRolloutParticles() const {
+            return trees_[0].getRolloutParticles();
+        }
+    }
+}
+
+#endif
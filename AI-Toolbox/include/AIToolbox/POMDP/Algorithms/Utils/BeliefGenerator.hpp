@@ -3,6 +3,7 @@
 
 #include <AIToolbox/ProbabilityUtils.hpp>
 #include <AIToolbox/POMDP/Types.hpp>
+#include <AIToolbox/POMDP/Utils.hpp>
 #include <AIToolbox/Impl/Seeder.hpp>
 
 namespace AIToolbox {
@@ -39,7 +40,7 @@ namespace AIToolbox {
                 const M& model_;
                 size_t S, A;
 
-                mutable std::default_random_engine rand_;
+                mutable RandomEngine rand_;
         };
 
         template <typename M>
@@ -118,7 +119,7 @@ namespace AIToolbox {
                         size_t s = sampleProbability(S, *it, rand_);
 
                         size_t o;
-                        std::tie(std::ignore, o, std::ignore) = model_.sampleSOR(s, a);
+                        std::tie(std::ignore, o, std::ignore) = sampleSOR(model_, s, a, rand_);
                         helper = updateBelief(model_, *it, a, o);
 
                         // Compute distance (here we compare also against elements we just added!)
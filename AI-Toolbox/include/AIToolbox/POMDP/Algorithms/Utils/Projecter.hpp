@@ -2,6 +2,7 @@
 #define AI_TOOLBOX_POMDP_PROJECTER_HEADER_FILE
 
 #include <AIToolbox/ProbabilityUtils.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
 #include <AIToolbox/POMDP/Types.hpp>
 
 namespace AIToolbox {
@@ -128,11 +129,7 @@ namespace AIToolbox {
 
         template <typename M>
         void Projecter<M>::computeImmediateRewards() {
-            immediateRewards_.fill(0.0);
-            for ( size_t a = 0; a < A; ++a )
-                for ( size_t s = 0; s < S; ++s )
-                    for ( size_t s1 = 0; s1 < S; ++s1 )
-                        immediateRewards_(a, s) += model_.getTransitionProbability(s,a,s1) * model_.getExpectedReward(s,a,s1);
+            immediateRewards_ = MDP::computeImmediateRewards(model_).transpose();
 
             // You can find out why this is divided in the incremental pruning paper =)
             // The idea is that at the end of all the cross sums it's going to add up to the correct value.
@@ -81,6 +81,7 @@ namespace AIToolbox {
                         in.observations_[a](s1, 0) = 1.0;
                 }
             }
+            in.setAliasSampling(m.getAliasSampling());
             // This guarantees that if input is invalid we still keep the old Model.
             m = in;
 
@@ -130,6 +131,7 @@ namespace AIToolbox {
                         in.observations_[a].coeffRef(s1, 0) = 1.0;
                 }
             }
+            in.setAliasSampling(m.getAliasSampling());
             // This guarantees that if input is invalid we still keep the old Model.
             m = in;
 
@@ -3,11 +3,13 @@
 
 #include <AIToolbox/Utils.hpp>
 #include <AIToolbox/MDP/Types.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
 #include <AIToolbox/POMDP/Types.hpp>
 
 #include <random>
 #include <AIToolbox/Impl/Seeder.hpp>
 #include <AIToolbox/ProbabilityUtils.hpp>
+#include <AIToolbox/AliasTable.hpp>
 
 namespace AIToolbox {
     namespace POMDP {
@@ -132,6 +134,11 @@ namespace AIToolbox {
                  * Of course this constructor is available only if the underlying Model
                  * allows to be constructed too.
                  *
+                 * If the other model exposes its observation function as
+                 * Eigen matrices (see is_model_eigen), they are copied and
+                 * validated one whole matrix at a time, rather than element
+                 * by element.
+                 *
                  * @tparam PM The type of the other model.
                  * @param model The model that needs to be copied.
                  */
@@ -179,6 +186,59 @@ namespace AIToolbox {
                  */
                 std::tuple<size_t,size_t, double> sampleSOR(size_t s,size_t a) const;
 
+                /**
+                 * @brief This function samples the POMDP for the specified state action pair, using the provided generator.
+                 *
+                 * This function is equivalent to sampleSOR(size_t, size_t),
+                 * but it uses the supplied generator both for the
+                 * transition and the observation, rather than the ones
+                 * stored in the models. As it does not modify the model in
+                 * any way, it is safe to call it from multiple threads on
+                 * the same instance, as long as each thread uses its own
+                 * generator.
+                 *
+                 * This function only exists if the underlying MDP model
+                 * supports sampleSR with the same generator, so that
+                 * POMDP::is_generative_model_engine is only true for
+                 * models which can actually be sampled this way.
+                 * \sa MDP::is_generative_model_engine
+                 *
+                 * @tparam G The type of the generator used.
+                 * @param s The state that needs to be sampled.
+                 * @param a The action that needs to be sampled.
+                 * @param generator The generator used to sample.
+                 *
+                 * @return A tuple containing a new state, observation and reward.
+                 */
+                template <typename G, typename std::enable_if<MDP::is_generative_model_engine<M, G>::value, int>::type = 0>
+                std::tuple<size_t,size_t, double> sampleSOR(size_t s,size_t a, G & generator) const;
+
+                /**
+                 * @brief This function samples the POMDP for many state action pairs at once.
+                 *
+                 * This function advances a batch of particles in lockstep.
+                 * It is equivalent to calling sampleSOR(size_t, size_t, G&)
+                 * for each element of the input, but it first advances all
+                 * states through the batch sampling of the underlying MDP
+                 * model, if available, and then samples all observations.
+                 *
+                 * The output vectors are resized to the size of the input.
+                 * The same vector may be passed as both the input states and
+                 * the output states, in order to advance the particles in
+                 * place.
+                 *
+                 * @tparam G The type of the generator used.
+                 * @param states The states that need to be sampled.
+                 * @param actions The actions that need to be sampled, one per state.
+                 * @param next The output vector of sampled new states.
+                 * @param observations The output vector of sampled observations.
+                 * @param rewards The output vector of sampled rewards.
+                 * @param generator The generator used to sample.
+                 */
+                template <typename G>
+                void sampleSORBatch(const std::vector<size_t> & states, const std::vector<size_t> & actions,
+                                    std::vector<size_t> & next, std::vector<size_t> & observations, std::vector<double> & rewards, G & generator) const;
+
                 /**
                  * @brief This function samples the POMDP for the specified state action pair.
                  *
@@ -197,6 +257,24 @@ namespace AIToolbox {
                  */
                 std::tuple<size_t, double> sampleOR(size_t s,size_t a,size_t s1) const;
 
+                /**
+                 * @brief This function samples the POMDP for the specified state action pair, using the provided generator.
+                 *
+                 * This function is equivalent to sampleOR(size_t, size_t,
+                 * size_t), but it uses the supplied generator rather than
+                 * the one stored in the model.
+                 *
+                 * @tparam G The type of the generator used.
+                 * @param s The state that needs to be sampled.
+                 * @param a The action that needs to be sampled.
+                 * @param s1 The resulting state of the s,a transition.
+                 * @param generator The generator used to sample.
+                 *
+                 * @return A tuple containing a new observation and reward.
+                 */
+                template <typename G>
+                std::tuple<size_t, double> sampleOR(size_t s,size_t a,size_t s1, G & generator) const;
+
                 /**
                  * @brief This function returns the stored observation probability for the specified state-action pair.
                  *
@@ -242,19 +320,70 @@ namespace AIToolbox {
                  */
                 const ObservationTable & getObservationFunction() const;
 
+                /**
+                 * @brief This function enables or disables alias sampling of the transition and observation functions.
+                 *
+                 * When enabled, the Model precomputes an alias table for
+                 * each action-state pair of the observation function, so
+                 * that observations can be sampled in O(1) rather than with
+                 * a linear scan of the observation row. The tables are
+                 * rebuilt every time the observation function is replaced.
+                 *
+                 * The setting is also forwarded to the underlying MDP
+                 * model, which must support it.
+                 *
+                 * @param alias Whether sampling should use alias tables.
+                 */
+                void setAliasSampling(bool alias);
+
+                /**
+                 * @brief This function returns whether alias sampling is enabled.
+                 *
+                 * @return True if sampling uses alias tables, false otherwise.
+                 */
+                bool getAliasSampling() const;
+
             private:
+                /**
+                 * @brief This function samples an observation from the observation function.
+                 *
+                 * @tparam G The type of the generator used.
+                 * @param a The action performed.
+                 * @param s1 The state reached.
+                 * @param generator The generator used to sample.
+                 *
+                 * @return The sampled observation.
+                 */
+                template <typename G>
+                size_t sampleO(size_t a, size_t s1, G & generator) const;
+
                 size_t O;
                 ObservationTable observations_;
+                bool aliasSampling_;
+                std::vector<AliasTable> observationSamplers_;
                 // We need this because we don't know if our parent already has one,
                 // and we wouldn't know how to access it!
-                mutable std::default_random_engine rand_;
+                mutable RandomEngine rand_;
+
+                /**
+                 * @brief This function copies the observation function of another model.
+                 *
+                 * @param model The model that needs to be copied.
+                 */
+                template <typename PM, typename std::enable_if<is_model_eigen<PM>::value, int>::type = 0>
+                void copyObservations(const PM & model);
+
+#ifndef DOXYGEN_SKIP
+                template <typename PM, typename std::enable_if<!is_model_eigen<PM>::value, int>::type = 0>
+                void copyObservations(const PM & model);
+#endif
 
                 friend std::istream& operator>> <M>(std::istream &is, Model<M> &);
         };
 
         template <typename M>
         template <typename... Args>
-        Model<M>::Model(size_t o, Args&&... params) : M(std::forward<Args>(params)...), O(o), observations_(this->getA(), Matrix2D(this->getS(), O)),
+        Model<M>::Model(size_t o, Args&&... params) : M(std::forward<Args>(params)...), O(o), observations_(this->getA(), Matrix2D(this->getS(), O)), aliasSampling_(false),
                                                       rand_(Impl::Seeder::getSeed())
         {
             for ( size_t a = 0; a < this->getA(); ++a ) {
@@ -265,7 +394,7 @@ namespace AIToolbox {
 
         template <typename M>
         template <typename ObFun, typename... Args, typename>
-        Model<M>::Model(size_t o, ObFun && of, Args&&... params) : M(std::forward<Args>(params)...), O(o), observations_(this->getA(), Matrix2D(this->getS(), O)),
+        Model<M>::Model(size_t o, ObFun && of, Args&&... params) : M(std::forward<Args>(params)...), O(o), observations_(this->getA(), Matrix2D(this->getS(), O)), aliasSampling_(false),
                                                                    rand_(Impl::Seeder::getSeed())
         {
             setObservationFunction(of);
@@ -273,9 +402,24 @@ namespace AIToolbox {
 
         template <typename M>
         template <typename PM, typename>
-        Model<M>::Model(const PM& model) : M(model), O(model.getO()), observations_(this->getA(), Matrix2D(this->getS(), O)),
+        Model<M>::Model(const PM& model) : M(model), O(model.getO()), observations_(this->getA(), Matrix2D(this->getS(), O)), aliasSampling_(false),
                                            rand_(Impl::Seeder::getSeed())
         {
+            copyObservations(model);
+        }
+
+        template <typename M>
+        template <typename PM, typename std::enable_if<is_model_eigen<PM>::value, int>::type>
+        void Model<M>::copyObservations(const PM & model) {
+            for ( size_t a = 0; a < this->getA(); ++a ) {
+                observations_[a] = model.getObservationFunction(a);
+                if ( ! isProbabilityMatrix(observations_[a]) ) throw std::invalid_argument("Input observation table does not contain valid probabilities.");
+            }
+        }
+
+        template <typename M>
+        template <typename PM, typename std::enable_if<!is_model_eigen<PM>::value, int>::type>
+        void Model<M>::copyObservations(const PM & model) {
             for ( size_t a = 0; a < this->getA(); ++a )
                 for ( size_t s1 = 0; s1 < this->getS(); ++s1 ) {
                     for ( size_t o = 0; o < O; ++o ) {
@@ -296,6 +440,8 @@ namespace AIToolbox {
                 for ( size_t a = 0; a < this->getA(); ++a )
                     for ( size_t o = 0; o < O; ++o )
                         observations_[a](s1, o) = of[s1][a][o];
+
+            if ( aliasSampling_ ) setAliasSampling(true);
         }
 
         template <typename M>
@@ -318,23 +464,79 @@ namespace AIToolbox {
             return observations_;
         }
 
+        template <typename M>
+        void Model<M>::setAliasSampling(bool alias) {
+            M::setAliasSampling(alias);
+
+            aliasSampling_ = alias;
+            observationSamplers_.clear();
+            if ( !aliasSampling_ ) return;
+
+            observationSamplers_.reserve(this->getA());
+            for ( size_t a = 0; a < this->getA(); ++a )
+                observationSamplers_.emplace_back(observations_[a]);
+        }
+
+        template <typename M>
+        bool Model<M>::getAliasSampling() const {
+            return aliasSampling_;
+        }
+
         template <typename M>
         std::tuple<size_t,size_t, double> Model<M>::sampleSOR(size_t s, size_t a) const {
             size_t s1, o;
             double r;
 
             std::tie(s1, r) = this->sampleSR(s, a);
-            o = sampleProbability(O, observations_[a].row(s1), rand_);
+            o = sampleO(a, s1, rand_);
+
+            return std::make_tuple(s1, o, r);
+        }
+
+        template <typename M>
+        template <typename G, typename std::enable_if<MDP::is_generative_model_engine<M, G>::value, int>::type>
+        std::tuple<size_t,size_t, double> Model<M>::sampleSOR(size_t s, size_t a, G & generator) const {
+            size_t s1, o;
+            double r;
+
+            std::tie(s1, r) = this->sampleSR(s, a, generator);
+            o = sampleO(a, s1, generator);
 
             return std::make_tuple(s1, o, r);
         }
 
+        template <typename M>
+        template <typename G>
+        void Model<M>::sampleSORBatch(const std::vector<size_t> & states, const std::vector<size_t> & actions,
+                                      std::vector<size_t> & next, std::vector<size_t> & observations, std::vector<double> & rewards, G & generator) const
+        {
+            MDP::sampleSRBatch(static_cast<const M &>(*this), states, actions, next, rewards, generator);
+
+            const size_t n = next.size();
+            observations.resize(n);
+            for ( size_t i = 0; i < n; ++i )
+                observations[i] = sampleO(actions[i], next[i], generator);
+        }
+
         template <typename M>
         std::tuple<size_t, double> Model<M>::sampleOR(size_t s, size_t a, size_t s1) const {
-            size_t o = sampleProbability(O, observations_[a].row(s1), rand_);
+            return sampleOR(s, a, s1, rand_);
+        }
+
+        template <typename M>
+        template <typename G>
+        std::tuple<size_t, double> Model<M>::sampleOR(size_t s, size_t a, size_t s1, G & generator) const {
+            size_t o = sampleO(a, s1, generator);
             double r = this->getExpectedReward(s, a, s1);
             return std::make_tuple(o, r);
         }
+
+        template <typename M>
+        template <typename G>
+        size_t Model<M>::sampleO(size_t a, size_t s1, G & generator) const {
+            return aliasSampling_ ? observationSamplers_[a].sampleRow(s1, generator) :
+                                    sampleProbability(O, observations_[a].row(s1), generator);
+        }
     }
 }
 
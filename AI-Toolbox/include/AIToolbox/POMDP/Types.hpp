@@ -97,6 +97,82 @@ namespace AIToolbox {
                 enum { value = std::is_same<decltype(test<M>(0)),std::true_type>::value };
         };
 
+        /**
+         * @brief This struct represents the interface for a generative POMDP which can use external generators.
+         *
+         * This struct is used to check interfaces of classes in templates.
+         * In particular, this struct tests whether a generative POMDP model
+         * can be sampled with a generator supplied by the caller, rather
+         * than with one stored in the model itself. Such models can be
+         * shared between threads, each using its own generator. The
+         * interface is the following:
+         *
+         * - std::tuple<size_t, size_t, double> sampleSOR(size_t s, size_t a, G & generator) const : Returns a sampled state-observation-reward tuple from (s,a) using the input generator.
+         *
+         * In addition the POMDP needs to respect the interface for the POMDP generative model.
+         *
+         * \sa POMDP::is_generative_model
+         *
+         * is_generative_model_engine<M, G>::value will be equal to true is M implements the interface,
+         * and false otherwise.
+         *
+         * @tparam M The class to test for the interface.
+         * @tparam G The generator type which needs to be supported.
+         */
+        template <typename M, typename G = RandomEngine>
+        struct is_generative_model_engine {
+            private:
+                template <typename Z> static auto test(int) -> decltype(
+
+                        static_cast<std::tuple<size_t, size_t, double>>(std::declval<const Z&>().sampleSOR(size_t(), size_t(), std::declval<G&>())),
+
+                        std::true_type()
+                );
+
+                template <typename Z> static auto test(...) -> std::false_type;
+
+            public:
+                enum { value = std::is_same<decltype(test<M>(0)),std::true_type>::value && is_generative_model<M>::value };
+        };
+
+        /**
+         * @brief This struct represents the interface for a generative POMDP which can be sampled in batches.
+         *
+         * This struct is used to check interfaces of classes in templates.
+         * In particular, this struct tests whether a generative POMDP model
+         * can advance many state-action pairs at once, stored as separate
+         * vectors. The interface is the following:
+         *
+         * - void sampleSORBatch(const std::vector<size_t> & states, const std::vector<size_t> & actions, std::vector<size_t> & next, std::vector<size_t> & observations, std::vector<double> & rewards, G & generator) const : Samples a state-observation-reward tuple for each input pair.
+         *
+         * In addition the POMDP needs to respect the interface for the POMDP generative model.
+         *
+         * \sa POMDP::is_generative_model
+         *
+         * is_generative_model_batch<M, G>::value will be equal to true is M implements the interface,
+         * and false otherwise.
+         *
+         * @tparam M The class to test for the interface.
+         * @tparam G The generator type which needs to be supported.
+         */
+        template <typename M, typename G = RandomEngine>
+        struct is_generative_model_batch {
+            private:
+                template <typename Z> static auto test(int) -> decltype(
+
+                        std::declval<const Z&>().sampleSORBatch(std::declval<const std::vector<size_t>&>(), std::declval<const std::vector<size_t>&>(),
+                                                                std::declval<std::vector<size_t>&>(), std::declval<std::vector<size_t>&>(),
+                                                                std::declval<std::vector<double>&>(), std::declval<G&>()),
+
+                        std::true_type()
+                );
+
+                template <typename Z> static auto test(...) -> std::false_type;
+
+            public:
+                enum { value = std::is_same<decltype(test<M>(0)),std::true_type>::value && is_generative_model<M>::value };
+        };
+
         /**
          * @brief This struct represents the required interface for a POMDP Model.
          *
@@ -135,6 +211,51 @@ namespace AIToolbox {
             public:
                 enum { value = std::is_same<decltype(test<T>(0)),std::true_type>::value && is_generative_model<T>::value && MDP::is_model<T>::value };
         };
+
+        /**
+         * @brief This struct represents the required interface that allows POMDP algorithms to leverage Eigen.
+         *
+         * This struct is used to check interfaces of classes in templates.
+         * In particular, this struct tests for the interface of a POMDP
+         * model which uses Eigen matrices internally.
+         * The interface must be implemented and be public in the parameter
+         * class. The interface is the following:
+         *
+         * - O getObservationFunction(size_t a) const : Returns the observation function for a given action as a matrix S'xO, where O is some Eigen matrix type.
+         *
+         * In addition the POMDP needs to respect the interface for the
+         * POMDP model and for the Eigen MDP model.
+         *
+         * \sa is_model
+         * \sa MDP::is_model_eigen
+         *
+         * is_model_eigen<M>::value will be equal to true is M implements the interface,
+         * and false otherwise.
+         *
+         * @tparam M The class to test for the interface.
+         */
+        template <typename M>
+        struct is_model_eigen {
+            private:
+                template <typename Z> static auto observationFunctionRetType(Z* z) ->
+                    typename std::remove_cv<typename std::remove_reference<decltype(z->getObservationFunction(std::declval<size_t>()))>::type>::type;
+                template <typename Z> static auto observationFunctionRetType(...) -> int;
+
+                using O = decltype(observationFunctionRetType<const M>(0));
+
+                template <typename Z> static auto test(int) -> decltype(
+
+                        static_cast<const O & (Z::*)(size_t) const>         (&Z::getObservationFunction),
+
+                        std::true_type()
+                );
+
+                template <typename> static auto test(...) -> std::false_type;
+
+            public:
+                enum { value = is_model<M>::value && MDP::is_model_eigen<M>::value && std::is_same<decltype(test<M>(0)),std::true_type>::value &&
+                               std::is_base_of<Eigen::EigenBase<O>, O>::value };
+        };
     }
 }
 
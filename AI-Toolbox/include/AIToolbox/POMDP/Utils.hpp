@@ -7,6 +7,7 @@
 
 #include <AIToolbox/ProbabilityUtils.hpp>
 #include <AIToolbox/Utils.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
 #include <AIToolbox/POMDP/Types.hpp>
 
 namespace AIToolbox {
@@ -103,13 +104,23 @@ namespace AIToolbox {
         /**
          * @brief This function computes an immediate reward based on a belief rather than a state.
          *
+         * Models which store their expected rewards R(s,a) (see
+         * MDP::is_model_expected_rewards) only need a dot product with
+         * the belief.
+         *
          * @param model The POMDP model to use.
          * @param b The belief to use.
          * @param a The action performed from the belief.
          *
          * @return The immediate reward.
          */
-        template <typename M, typename = typename std::enable_if<is_model<M>::value>::type>
+        template <typename M, typename std::enable_if<is_model<M>::value && MDP::is_model_expected_rewards<M>::value, int>::type = 0>
+        double beliefExpectedReward(const M& model, const Belief & b, size_t a) {
+            return b.dot(model.getExpectedRewardFunction().col(a));
+        }
+
+#ifndef DOXYGEN_SKIP
+        template <typename M, typename std::enable_if<is_model<M>::value && !MDP::is_model_expected_rewards<M>::value, int>::type = 0>
         double beliefExpectedReward(const M& model, const Belief & b, size_t a) {
             double rew = 0.0; size_t S = model.getS();
             for ( size_t s = 0; s < S; ++s )
@@ -118,6 +129,7 @@ namespace AIToolbox {
 
             return rew;
         }
+#endif
 
         /**
          * @brief This function computes the probability of obtaining an observation from a belief and action.
@@ -319,6 +331,85 @@ namespace AIToolbox {
             return end;
         }
 
+
+        /**
+         * @brief This function samples a generative model with the provided generator, if possible.
+         *
+         * Algorithms which sample models should call this function rather
+         * than the sampleSOR member function, so that models which support
+         * external generators can be shared read-only between threads.
+         *
+         * If the model does not support sampling with an external
+         * generator, this function falls back to sampleSOR(s, a), which
+         * uses the generator internal to the model.
+         *
+         * \sa is_generative_model_engine
+         *
+         * @tparam M The type of the model.
+         * @tparam G The type of the generator.
+         * @param model The model to sample.
+         * @param s The state that needs to be sampled.
+         * @param a The action that needs to be sampled.
+         * @param generator The generator to use, if the model supports it.
+         *
+         * @return A tuple containing a new state, observation and reward.
+         */
+        template <typename M, typename G, typename std::enable_if<is_generative_model_engine<M, G>::value, int>::type = 0>
+        std::tuple<size_t, size_t, double> sampleSOR(const M & model, size_t s, size_t a, G & generator) {
+            return model.sampleSOR(s, a, generator);
+        }
+
+#ifndef DOXYGEN_SKIP
+        template <typename M, typename G, typename std::enable_if<!is_generative_model_engine<M, G>::value, int>::type = 0>
+        std::tuple<size_t, size_t, double> sampleSOR(const M & model, size_t s, size_t a, G &) {
+            return model.sampleSOR(s, a);
+        }
+#endif
+
+        /**
+         * @brief This function samples a generative model for many state action pairs at once.
+         *
+         * If the model provides a batch sampling function, this function
+         * calls it. Otherwise, it samples each pair separately with
+         * sampleSOR(const M &, size_t, size_t, G &).
+         *
+         * The output vectors are resized to the size of the input. The
+         * same vector may be passed as both the input states and the output
+         * states, in order to advance a set of particles in place.
+         *
+         * \sa is_generative_model_batch
+         *
+         * @tparam M The type of the model.
+         * @tparam G The type of the generator.
+         * @param model The model to sample.
+         * @param states The states that need to be sampled.
+         * @param actions The actions that need to be sampled, one per state.
+         * @param next The output vector of sampled new states.
+         * @param observations The output vector of sampled observations.
+         * @param rewards The output vector of sampled rewards.
+         * @param generator The generator to use, if the model supports it.
+         */
+        template <typename M, typename G, typename std::enable_if<is_generative_model_batch<M, G>::value, int>::type = 0>
+        void sampleSORBatch(const M & model, const std::vector<size_t> & states, const std::vector<size_t> & actions,
+                            std::vector<size_t> & next, std::vector<size_t> & observations, std::vector<double> & rewards, G & generator)
+        {
+            model.sampleSORBatch(states, actions, next, observations, rewards, generator);
+        }
+
+#ifndef DOXYGEN_SKIP
+        template <typename M, typename G, typename std::enable_if<!is_generative_model_batch<M, G>::value, int>::type = 0>
+        void sampleSORBatch(const M & model, const std::vector<size_t> & states, const std::vector<size_t> & actions,
+                            std::vector<size_t> & next, std::vector<size_t> & observations, std::vector<double> & rewards, G & generator)
+        {
+            const size_t n = states.size();
+            next.resize(n);
+            observations.resize(n);
+            rewards.resize(n);
+
+            for ( size_t i = 0; i < n; ++i )
+                std::tie(next[i], observations[i], rewards[i]) = sampleSOR(model, states[i], actions[i], generator);
+        }
+#endif
     }
 }
 
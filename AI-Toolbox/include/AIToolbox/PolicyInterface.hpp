@@ -76,7 +76,7 @@ namespace AIToolbox {
             size_t S, A;
 
             // This is mutable because sampling doesn't really change the policy
-            mutable std::default_random_engine rand_;
+            mutable RandomEngine rand_;
     };
 
     template <typename State>
@@ -47,6 +47,50 @@ namespace AIToolbox {
         return true;
     }
 
+    /**
+     * @brief This function checks whether each row of an Eigen matrix is a correct probability vector.
+     *
+     * This is equivalent to calling isProbability() on each row, but
+     * the range checks and the row sums are computed on the whole
+     * matrix at once.
+     *
+     * @tparam D The type of the input matrix.
+     * @param m The dense matrix to check.
+     *
+     * @return True if all rows of the matrix are probability vectors, false otherwise.
+     */
+    template <typename D>
+    bool isProbabilityMatrix(const Eigen::MatrixBase<D> & m) {
+        if ( m.size() == 0 ) return true;
+        if ( m.minCoeff() < 0.0 || m.maxCoeff() > 1.0 ) return false;
+
+        const Vector sums = m.rowwise().sum();
+        for ( decltype(sums.size()) i = 0; i < sums.size(); ++i )
+            if ( checkDifferentSmall(sums(i), 1.0) )
+                return false;
+
+        return true;
+    }
+
+#ifndef DOXYGEN_SKIP
+    // Sparse matrices are checked by only looking at their nonzero elements.
+    template <typename D>
+    bool isProbabilityMatrix(const Eigen::SparseMatrixBase<D> & m) {
+        Vector sums = Vector::Zero(m.rows());
+        for ( decltype(m.outerSize()) k = 0; k < m.outerSize(); ++k ) {
+            for ( typename D::InnerIterator it(m.derived(), k); it; ++it ) {
+                if ( it.value() < 0.0 || it.value() > 1.0 ) return false;
+                sums(it.row()) += it.value();
+            }
+        }
+        for ( decltype(sums.size()) i = 0; i < sums.size(); ++i )
+            if ( checkDifferentSmall(sums(i), 1.0) )
+                return false;
+
+        return true;
+    }
+#endif
+
     /**
      * @brief This function samples an index from a probability vector.
      *
@@ -72,7 +116,7 @@ namespace AIToolbox {
      */
     template <typename T, typename G>
     size_t sampleProbability(size_t d, const T& in, G& generator) {
-        static std::uniform_real_distribution<double> sampleDistribution(0.0, 1.0);
+        std::uniform_real_distribution<double> sampleDistribution(0.0, 1.0);
         double p = sampleDistribution(generator);
 
         for ( size_t i = 0; i < d; ++i ) {
@@ -106,7 +150,7 @@ namespace AIToolbox {
      */
     template <typename G>
     size_t sampleProbability(size_t d, const SparseMatrix2D::RowXpr& in, G& generator) {
-        static std::uniform_real_distribution<double> sampleDistribution(0.0, 1.0);
+        std::uniform_real_distribution<double> sampleDistribution(0.0, 1.0);
         double p = sampleDistribution(generator);
 
         for ( SparseMatrix2D::RowXpr::InnerIterator i(in, 0); ; ++i ) {
@@ -140,7 +184,7 @@ namespace AIToolbox {
      */
     template <typename G>
     size_t sampleProbability(size_t d, const SparseMatrix2D::ConstRowXpr& in, G& generator) {
-        static std::uniform_real_distribution<double> sampleDistribution(0.0, 1.0);
+        std::uniform_real_distribution<double> sampleDistribution(0.0, 1.0);
         double p = sampleDistribution(generator);
 
         for ( SparseMatrix2D::ConstRowXpr::InnerIterator i(in, 0); ; ++i ) {
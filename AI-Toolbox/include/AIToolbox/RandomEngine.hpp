@@ -0,0 +1,131 @@
+#ifndef AI_TOOLBOX_RANDOM_ENGINE_HEADER_FILE
+#define AI_TOOLBOX_RANDOM_ENGINE_HEADER_FILE
+
+#include <cstdint>
+#include <array>
+
+namespace AIToolbox {
+    /**
+     * @brief This class is the random engine used throughout the library.
+     *
+     * This is an implementation of xoshiro256**, by Blackman and Vigna. It
+     * is much faster than std::default_random_engine, it produces 64 bits
+     * per call (so that a double can be generated from a single call), and
+     * it has a period of 2^256 - 1.
+     *
+     * The engine also supports a jump() operation, which advances the
+     * state by 2^128 steps. This allows to split a single engine into many
+     * non-overlapping streams, one per thread or per object.
+     *
+     * The class satisfies the UniformRandomBitGenerator requirements, so it
+     * can be used with all standard distributions.
+     */
+    class RandomEngine {
+        public:
+            using result_type = std::uint64_t;
+
+            /**
+             * @brief Basic constructor.
+             *
+             * \sa seed()
+             *
+             * @param seed The seed of the engine.
+             */
+            explicit RandomEngine(result_type seed = 0);
+
+            /**
+             * @brief This function reseeds the engine.
+             *
+             * The 256 bits of state are obtained by expanding the seed
+             * with splitmix64, so that similar seeds (like consecutive
+             * integers) still result in uncorrelated streams.
+             *
+             * @param seed The new seed of the engine.
+             */
+            void seed(result_type seed);
+
+            /**
+             * @brief This function returns the next random number.
+             *
+             * @return A uniformly distributed 64 bit number.
+             */
+            result_type operator()();
+
+            /**
+             * @brief This function advances the engine by the specified number of steps.
+             *
+             * @param z The number of steps to skip.
+             */
+            void discard(unsigned long long z);
+
+            /**
+             * @brief This function advances the engine by 2^128 steps.
+             *
+             * This is equivalent to 2^128 calls to operator(), and can be
+             * used to generate up to 2^128 non-overlapping subsequences.
+             */
+            void jump();
+
+            /**
+             * @brief This function splits a new independent stream from this engine.
+             *
+             * The returned engine starts from the current state of this
+             * one, while this engine jumps 2^128 steps ahead. Calling this
+             * function repeatedly produces non-overlapping streams, in a
+             * way which only depends on the initial seed and on the
+             * number of calls.
+             *
+             * @return A new engine.
+             */
+            RandomEngine split();
+
+            static constexpr result_type min() { return 0; }
+            static constexpr result_type max() { return ~static_cast<result_type>(0); }
+
+            bool operator==(const RandomEngine & other) const;
+            bool operator!=(const RandomEngine & other) const;
+
+        private:
+            static result_type rotl(result_type x, int k);
+
+            std::array<result_type, 4> s_;
+    };
+
+    inline RandomEngine::result_type RandomEngine::rotl(result_type x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    inline RandomEngine::result_type RandomEngine::operator()() {
+        const result_type result = rotl(s_[1] * 5, 7) * 9;
+        const result_type t = s_[1] << 17;
+
+        s_[2] ^= s_[0];
+        s_[3] ^= s_[1];
+        s_[1] ^= s_[2];
+        s_[0] ^= s_[3];
+
+        s_[2] ^= t;
+        s_[3] = rotl(s_[3], 45);
+
+        return result;
+    }
+
+    /**
+     * @brief This function mixes a 64 bit number into another, uncorrelated one.
+     *
+     * This is the output function of splitmix64. It is a bijection, and it
+     * is used to derive seeds and states from arbitrary integers.
+     *
+     * @param x The number to mix.
+     *
+     * @return The mixed number.
+     */
+    inline std::uint64_t mixBits(std::uint64_t x) {
+        x += 0x9e3779b97f4a7c15ull;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+}
+
+#endif
@@ -0,0 +1,446 @@
+#ifndef AI_TOOLBOX_SEARCH_TREE_HEADER_FILE
+#define AI_TOOLBOX_SEARCH_TREE_HEADER_FILE
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace AIToolbox {
+    /**
+     * @brief This class represents the search tree built by Monte Carlo planners like MCTS and POMCP.
+     *
+     * The tree alternates between nodes, where an action must be chosen,
+     * and action nodes, which hold the statistics of each action and lead
+     * to child nodes depending on a key (the sampled state or
+     * observation).
+     *
+     * All nodes are stored in flat arenas and refer to each other through
+     * indices, so that growing the tree does not allocate memory for each
+     * node. The A action nodes of a node are contiguous, and the children
+     * of each action node are found through a small open addressing hash
+     * table, also stored in an arena.
+     *
+     * Resetting the tree takes constant time, and keeps all memory around
+     * to be reused. Making a node the new root copies its subtree into new
+     * arenas and frees the old ones, so that the tree stays compact while
+     * being reused between planning steps, and the memory of the dropped
+     * branches does not add to that of the new tree as it grows.
+     *
+     * Since the arenas can grow, references to nodes and action nodes are
+     * invalidated by expand(), addChild(), reset() and reroot(); indices
+     * are only invalidated by reset() and reroot().
+     *
+     * The data of a node is NOT reset when the memory of an old node is
+     * reused, so that its containers can keep their capacity. Callers
+     * must initialize it for each node returned by addChild(), and for the
+     * root after reset().
+     *
+     * @tparam Data Additional data stored in each node, which the node derives from.
+     */
+    template <typename Data>
+    class SearchTree {
+        public:
+            static constexpr size_t npos = static_cast<size_t>(-1);
+
+            /**
+             * @brief This class represents the statistics of an action from a node.
+             */
+            class ActionNode {
+                public:
+                    double V = 0.0;
+                    unsigned N = 0;
+
+                private:
+                    friend class SearchTree;
+
+                    // The open addressing table of the children.
+                    size_t slots_ = npos;
+                    uint32_t capacity_ = 0, size_ = 0;
+            };
+
+            /**
+             * @brief This class represents a node of the tree, where an action must be chosen.
+             */
+            class Node : public Data {
+                public:
+                    unsigned N = 0;
+
+                private:
+                    friend class SearchTree;
+
+                    // The first of the A action nodes of this node.
+                    size_t actions_ = npos;
+            };
+
+            /**
+             * @brief Basic constructor.
+             *
+             * The tree starts with a root which has not been expanded.
+             *
+             * @param A The number of actions of each node.
+             */
+            SearchTree(size_t A);
+
+            /**
+             * @brief This function drops all nodes and creates a new root which has not been expanded.
+             *
+             * This function does not free any memory.
+             */
+            void reset();
+
+            /**
+             * @brief This function makes a node the new root of the tree, dropping everything not in its subtree.
+             *
+             * This function runs in time linear in the size of the subtree,
+             * and frees the memory of the old tree.
+             *
+             * @param n The index of the new root.
+             */
+            void reroot(size_t n);
+
+            /**
+             * @brief This function creates the action nodes of a node, if it does not have them already.
+             *
+             * @param n The index of the node.
+             */
+            void expand(size_t n);
+
+            /**
+             * @brief This function returns whether a node has its action nodes.
+             *
+             * @param n The index of the node.
+             *
+             * @return True if the node has been expanded, false otherwise.
+             */
+            bool isExpanded(size_t n) const;
+
+            /**
+             * @brief This function returns the child of an action node with the specified key.
+             *
+             * @param n The index of the node.
+             * @param a The action of the node.
+             * @param key The key of the child.
+             *
+             * @return The index of the child, or npos if there is no such child.
+             */
+            size_t getChild(size_t n, size_t a, size_t key) const;
+
+            /**
+             * @brief This function adds a new child to an action node.
+             *
+             * The node must be expanded, and it must not already have a
+             * child with the same key for this action.
+             *
+             * @param n The index of the node.
+             * @param a The action of the node.
+             * @param key The key of the new child.
+             *
+             * @return The index of the new child.
+             */
+            size_t addChild(size_t n, size_t a, size_t key);
+
+            /**
+             * @brief This function calls a function for every child of an action node.
+             *
+             * The function is called as f(key, child), in no particular
+             * order, and must not modify the tree.
+             *
+             * @param n The index of the node.
+             * @param a The action of the node.
+             * @param f The function to call.
+             */
+            template <typename F>
+            void forEachChild(size_t n, size_t a, F f) const;
+
+            /**
+             * @brief This function returns the number of children of an action node.
+             *
+             * @param n The index of the node.
+             * @param a The action of the node.
+             *
+             * @return The number of children.
+             */
+            size_t countChildren(size_t n, size_t a) const;
+
+            /**
+             * @brief This function returns a node of the tree.
+             *
+             * The root is always the node at index 0.
+             *
+             * @param n The index of the node.
+             *
+             * @return The node.
+             */
+            Node & getNode(size_t n);
+            const Node & getNode(size_t n) const;
+
+            /**
+             * @brief This function returns the root of the tree.
+             *
+             * @return The node at index 0.
+             */
+            Node & getRoot();
+            const Node & getRoot() const;
+
+            /**
+             * @brief This function returns the A contiguous action nodes of an expanded node.
+             *
+             * @param n The index of the node.
+             *
+             * @return A pointer to the action node of the first action.
+             */
+            ActionNode * getActions(size_t n);
+            const ActionNode * getActions(size_t n) const;
+
+            /**
+             * @brief This function returns an action node of an expanded node.
+             *
+             * @param n The index of the node.
+             * @param a The action requested.
+             *
+             * @return The action node.
+             */
+            ActionNode & getAction(size_t n, size_t a);
+            const ActionNode & getAction(size_t n, size_t a) const;
+
+            /**
+             * @brief This function returns the number of nodes in the tree.
+             *
+             * @return The number of nodes.
+             */
+            size_t size() const;
+
+            /**
+             * @brief This function returns the number of actions of each node.
+             *
+             * @return The number of actions.
+             */
+            size_t getA() const;
+
+        private:
+            struct Slot {
+                size_t key;
+                size_t node;
+            };
+
+            struct Storage {
+                // Nodes past size are kept to reuse their data.
+                std::vector<Node> nodes;
+                size_t size = 0;
+                std::vector<ActionNode> actions;
+                std::vector<Slot> slots;
+            };
+
+            static size_t newNode(Storage & storage);
+            static void allocateSlots(Storage & storage, ActionNode & an, uint32_t capacity);
+            static void insert(Storage & storage, const ActionNode & an, size_t key, size_t node);
+            static size_t hash(size_t key);
+
+            size_t A;
+            Storage tree_;
+            // The old indices of the nodes being copied by reroot().
+            std::vector<size_t> order_;
+    };
+
+    template <typename Data>
+    constexpr size_t SearchTree<Data>::npos;
+
+    template <typename Data>
+    SearchTree<Data>::SearchTree(size_t a) : A(a) {
+        reset();
+    }
+
+    template <typename Data>
+    void SearchTree<Data>::reset() {
+        tree_.size = 0;
+        tree_.actions.clear();
+        tree_.slots.clear();
+        newNode(tree_);
+    }
+
+    template <typename Data>
+    void SearchTree<Data>::reroot(size_t n) {
+        if ( n == 0 ) return;
+
+        Storage to;
+
+        // Nodes are copied breadth first, so that the i-th node copied
+        // gets index i.
+        order_.clear();
+        order_.push_back(n);
+        newNode(to);
+        for ( size_t i = 0; i < order_.size(); ++i ) {
+            Node & src = tree_.nodes[order_[i]];
+            {
+                Node & dst = to.nodes[i];
+                dst.N = src.N;
+                using std::swap;
+                swap(static_cast<Data&>(dst), static_cast<Data&>(src));
+            }
+            if ( src.actions_ == npos ) continue;
+
+            const size_t actions = to.actions.size();
+            to.nodes[i].actions_ = actions;
+            to.actions.resize(actions + A);
+            for ( size_t a = 0; a < A; ++a ) {
+                const ActionNode & sa = tree_.actions[src.actions_ + a];
+                ActionNode & da = to.actions[actions + a];
+                da.V = sa.V;
+                da.N = sa.N;
+                if ( !sa.size_ ) continue;
+
+                // The copy gets the smallest table which fits its children.
+                uint32_t capacity = 4;
+                while ( sa.size_ * 4 > capacity * 3 ) capacity *= 2;
+                allocateSlots(to, da, capacity);
+
+                for ( size_t j = sa.slots_; j < sa.slots_ + sa.capacity_; ++j ) {
+                    const Slot slot = tree_.slots[j];
+                    if ( slot.key == npos ) continue;
+                    order_.push_back(slot.node);
+                    insert(to, da, slot.key, newNode(to));
+                }
+                da.size_ = sa.size_;
+            }
+        }
+        std::swap(tree_, to);
+    }
+
+    template <typename Data>
+    void SearchTree<Data>::expand(size_t n) {
+        if ( tree_.nodes[n].actions_ != npos ) return;
+        tree_.nodes[n].actions_ = tree_.actions.size();
+        tree_.actions.resize(tree_.actions.size() + A);
+    }
+
+    template <typename Data>
+    bool SearchTree<Data>::isExpanded(size_t n) const {
+        return tree_.nodes[n].actions_ != npos;
+    }
+
+    template <typename Data>
+    size_t SearchTree<Data>::getChild(size_t n, size_t a, size_t key) const {
+        if ( !isExpanded(n) ) return npos;
+        const ActionNode & an = getAction(n, a);
+        if ( !an.capacity_ ) return npos;
+
+        const size_t mask = an.capacity_ - 1;
+        for ( size_t i = hash(key) & mask; ; i = (i + 1) & mask ) {
+            const Slot & slot = tree_.slots[an.slots_ + i];
+            if ( slot.key == key ) return slot.node;
+            if ( slot.key == npos ) return npos;
+        }
+    }
+
+    template <typename Data>
+    size_t SearchTree<Data>::addChild(size_t n, size_t a, size_t key) {
+        ActionNode & an = getAction(n, a);
+        if ( (an.size_ + 1) * 4 > an.capacity_ * 3 ) {
+            // The old table is left in the arena until the next reroot().
+            const size_t old = an.slots_, capacity = an.capacity_;
+            allocateSlots(tree_, an, capacity ? 2 * capacity : 4);
+            for ( size_t j = old; j < old + capacity; ++j ) {
+                const Slot slot = tree_.slots[j];
+                if ( slot.key != npos ) insert(tree_, an, slot.key, slot.node);
+            }
+        }
+        const size_t child = newNode(tree_);
+        insert(tree_, an, key, child);
+        ++an.size_;
+        return child;
+    }
+
+    template <typename Data>
+    template <typename F>
+    void SearchTree<Data>::forEachChild(size_t n, size_t a, F f) const {
+        if ( !isExpanded(n) ) return;
+        const ActionNode & an = getAction(n, a);
+        for ( size_t j = an.slots_; j < an.slots_ + an.capacity_; ++j ) {
+            const Slot & slot = tree_.slots[j];
+            if ( slot.key != npos ) f(slot.key, slot.node);
+        }
+    }
+
+    template <typename Data>
+    size_t SearchTree<Data>::countChildren(size_t n, size_t a) const {
+        if ( !isExpanded(n) ) return 0;
+        return getAction(n, a).size_;
+    }
+
+    template <typename Data>
+    typename SearchTree<Data>::Node & SearchTree<Data>::getNode(size_t n) { return tree_.nodes[n]; }
+
+    template <typename Data>
+    const typename SearchTree<Data>::Node & SearchTree<Data>::getNode(size_t n) const { return tree_.nodes[n]; }
+
+    template <typename Data>
+    typename SearchTree<Data>::Node & SearchTree<Data>::getRoot() { return tree_.nodes[0]; }
+
+    template <typename Data>
+    const typename SearchTree<Data>::Node & SearchTree<Data>::getRoot() const { return tree_.nodes[0]; }
+
+    template <typename Data>
+    typename SearchTree<Data>::ActionNode * SearchTree<Data>::getActions(size_t n) {
+        return tree_.actions.data() + tree_.nodes[n].actions_;
+    }
+
+    template <typename Data>
+    const typename SearchTree<Data>::ActionNode * SearchTree<Data>::getActions(size_t n) const {
+        return tree_.actions.data() + tree_.nodes[n].actions_;
+    }
+
+    template <typename Data>
+    typename SearchTree<Data>::ActionNode & SearchTree<Data>::getAction(size_t n, size_t a) {
+        return tree_.actions[tree_.nodes[n].actions_ + a];
+    }
+
+    template <typename Data>
+    const typename SearchTree<Data>::ActionNode & SearchTree<Data>::getAction(size_t n, size_t a) const {
+        return tree_.actions[tree_.nodes[n].actions_ + a];
+    }
+
+    template <typename Data>
+    size_t SearchTree<Data>::size() const { return tree_.size; }
+
+    template <typename Data>
+    size_t SearchTree<Data>::getA() const { return A; }
+
+    template <typename Data>
+    size_t SearchTree<Data>::newNode(Storage & storage) {
+        if ( storage.size == storage.nodes.size() ) {
+            storage.nodes.emplace_back();
+        } else {
+            Node & node = storage.nodes[storage.size];
+            node.N = 0;
+            node.actions_ = npos;
+        }
+        return storage.size++;
+    }
+
+    template <typename Data>
+    void SearchTree<Data>::allocateSlots(Storage & storage, ActionNode & an, uint32_t capacity) {
+        an.slots_ = storage.slots.size();
+        an.capacity_ = capacity;
+        storage.slots.resize(storage.slots.size() + capacity, Slot{npos, npos});
+    }
+
+    template <typename Data>
+    void SearchTree<Data>::insert(Storage & storage, const ActionNode & an, size_t key, size_t node) {
+        const size_t mask = an.capacity_ - 1;
+        size_t i = hash(key) & mask;
+        while ( storage.slots[an.slots_ + i].key != npos )
+            i = (i + 1) & mask;
+        storage.slots[an.slots_ + i] = Slot{key, node};
+    }
+
+    template <typename Data>
+    size_t SearchTree<Data>::hash(size_t key) {
+        // Fibonacci hashing, folded so that the low bits depend on all
+        // bits of the key.
+        const uint64_t h = static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+}
+
+#endif
@@ -10,13 +10,29 @@
 #include <Eigen/SparseCore>
 
 namespace AIToolbox {
-    using Table3D = boost::multi_array<double, 3>;
-    using Table2D = boost::multi_array<double, 2>;
+    /**
+     * @brief This is the floating point type used to store all model and solver data.
+     *
+     * By default all tables, matrices and vectors store doubles. When the
+     * library is compiled with AI_TOOLBOX_FLOAT defined (see the
+     * AI_TOOLBOX_FLOAT CMake option), they store floats instead, which
+     * halves the memory used by large models and the memory traffic of
+     * the solvers. The whole library, and everything linked against it,
+     * must be compiled with the same setting.
+     */
+#ifdef AI_TOOLBOX_FLOAT
+    using Scalar = float;
+#else
+    using Scalar = double;
+#endif
+
+    using Table3D = boost::multi_array<Scalar, 3>;
+    using Table2D = boost::multi_array<Scalar, 2>;
 
-    using Matrix2D = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor | Eigen::AutoAlign>;
-    using SparseMatrix2D = Eigen::SparseMatrix<double, Eigen::RowMajor>;
+    using Matrix2D = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor | Eigen::AutoAlign>;
+    using SparseMatrix2D = Eigen::SparseMatrix<Scalar, Eigen::RowMajor>;
 
-    using Vector   = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+    using Vector   = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
 
     using Matrix3D = std::vector<Matrix2D>;
     using SparseMatrix3D = std::vector<SparseMatrix2D>;
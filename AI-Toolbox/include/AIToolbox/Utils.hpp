@@ -41,13 +41,16 @@ namespace AIToolbox {
      * If the numbers are not near [0,1], the result is not guaranteed to be
      * what may be expected. The order of the parameters is not important.
      *
+     * The tolerance depends on the precision of AIToolbox::Scalar, since
+     * the numbers compared are generally computed from stored data.
+     *
      * @param a The first number to compare.
      * @param b The second number to compare.
      *
      * @return True if the two numbers are close enough, false otherwise.
      */
     inline bool checkEqualSmall(double a, double b) {
-        return ( std::fabs(a - b) <= 5 * std::numeric_limits<double>::epsilon() );
+        return ( std::fabs(a - b) <= 5 * std::numeric_limits<Scalar>::epsilon() );
     }
 
     /**
@@ -65,6 +68,31 @@ namespace AIToolbox {
         return !checkEqualSmall(a,b);
     }
 
+    /**
+     * @brief This function copies an Eigen matrix into a SparseMatrix2D.
+     *
+     * Elements which are almost zero (see checkEqualSmall()) are not
+     * stored.
+     *
+     * @tparam D The type of the input matrix.
+     * @param in The dense input matrix.
+     * @param out The output matrix, which is resized as needed.
+     */
+    template <typename D>
+    void copySparseMatrix2D(const Eigen::MatrixBase<D> & in, SparseMatrix2D & out) {
+        out = in.sparseView();
+        out.prune([](const Eigen::Index &, const Eigen::Index &, const Scalar & v) { return checkDifferentSmall(0.0, v); });
+    }
+
+#ifndef DOXYGEN_SKIP
+    // Sparse inputs are copied by iterating only over their nonzero elements.
+    template <typename D>
+    void copySparseMatrix2D(const Eigen::SparseMatrixBase<D> & in, SparseMatrix2D & out) {
+        out = in.derived();
+        out.prune([](const Eigen::Index &, const Eigen::Index &, const Scalar & v) { return checkDifferentSmall(0.0, v); });
+    }
+#endif
+
     /**
      * @brief This function checks if two doubles are reasonably equal.
      *
@@ -77,7 +105,7 @@ namespace AIToolbox {
      */
     inline bool checkEqualGeneral(double a, double b) {
         if ( checkEqualSmall(a,b) ) return true;
-        return ( std::fabs(a - b) / std::min(std::fabs(a), std::fabs(b)) < std::numeric_limits<double>::epsilon() );
+        return ( std::fabs(a - b) / std::min(std::fabs(a), std::fabs(b)) < std::numeric_limits<Scalar>::epsilon() );
     }
 
     /**
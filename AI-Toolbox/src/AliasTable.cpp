@@ -0,0 +1,73 @@
+#include <AIToolbox/AliasTable.hpp>
+
+namespace AIToolbox {
+    AliasTable::AliasTable() : rowStart_(1, 0) {}
+
+    AliasTable::AliasTable(const Matrix2D & m) : rowStart_(1, 0) {
+        rowStart_.reserve(m.rows() + 1);
+        for ( decltype(m.rows()) r = 0; r < m.rows(); ++r ) {
+            for ( decltype(m.cols()) c = 0; c < m.cols(); ++c ) {
+                if ( m(r, c) <= 0.0 ) continue;
+                outcomes_.push_back(c);
+                prob_.push_back(m(r, c));
+            }
+            closeRow();
+        }
+    }
+
+    AliasTable::AliasTable(const SparseMatrix2D & m) : rowStart_(1, 0) {
+        rowStart_.reserve(m.rows() + 1);
+        prob_.reserve(m.nonZeros());
+        outcomes_.reserve(m.nonZeros());
+        for ( decltype(m.outerSize()) r = 0; r < m.outerSize(); ++r ) {
+            for ( SparseMatrix2D::InnerIterator it(m, r); it; ++it ) {
+                if ( it.value() <= 0.0 ) continue;
+                outcomes_.push_back(it.col());
+                prob_.push_back(it.value());
+            }
+            closeRow();
+        }
+    }
+
+    void AliasTable::closeRow() {
+        const size_t start = rowStart_.back();
+        const size_t end = prob_.size();
+        const size_t n = end - start;
+
+        alias_.resize(end);
+        rowStart_.push_back(end);
+        if ( !n ) return;
+
+        double sum = 0.0;
+        for ( size_t i = start; i < end; ++i ) sum += prob_[i];
+
+        // Scale so that the average bucket has weight 1, and split the
+        // buckets in under and overfull ones (Vose's method).
+        std::vector<size_t> small, large;
+        for ( size_t i = start; i < end; ++i ) {
+            prob_[i] *= n / sum;
+            alias_[i] = i;
+            if ( prob_[i] < 1.0 ) small.push_back(i);
+            else                  large.push_back(i);
+        }
+
+        while ( !small.empty() && !large.empty() ) {
+            const size_t l = small.back(); small.pop_back();
+            const size_t g = large.back();
+
+            alias_[l] = g;
+            prob_[g] -= 1.0 - prob_[l];
+            if ( prob_[g] < 1.0 ) {
+                large.pop_back();
+                small.push_back(g);
+            }
+        }
+        // Whatever is left is full up to rounding errors.
+        for ( auto i : large ) prob_[i] = 1.0;
+        for ( auto i : small ) prob_[i] = 1.0;
+    }
+
+    size_t AliasTable::getRows() const {
+        return rowStart_.size() - 1;
+    }
+}
@@ -0,0 +1,50 @@
+#include <AIToolbox/FenwickTree.hpp>
+
+namespace AIToolbox {
+    FenwickTree::FenwickTree(size_t n) : n_(n), topBit_(1), tree_(n + 1, 0ul) {
+        while ( topBit_ <= n_ / 2 ) topBit_ <<= 1;
+    }
+
+    void FenwickTree::add(size_t i, long delta) {
+        for ( ++i; i <= n_; i += i & (~i + 1) )
+            tree_[i] += delta;
+    }
+
+    void FenwickTree::set(size_t i, unsigned long value) {
+        add(i, static_cast<long>(value) - static_cast<long>(get(i)));
+    }
+
+    unsigned long FenwickTree::get(size_t i) const {
+        // The node contains the sum of a range ending in i; we remove all
+        // other elements of that range by walking down its children.
+        ++i;
+        unsigned long retval = tree_[i];
+        const size_t stop = i - (i & (~i + 1));
+        for ( --i; i > stop; i -= i & (~i + 1) )
+            retval -= tree_[i];
+        return retval;
+    }
+
+    unsigned long FenwickTree::getTotal() const {
+        unsigned long retval = 0;
+        for ( size_t i = n_; i > 0; i -= i & (~i + 1) )
+            retval += tree_[i];
+        return retval;
+    }
+
+    size_t FenwickTree::find(unsigned long target) const {
+        // Binary descent: at each step we skip a whole subtree if its sum
+        // is not larger than what we are still looking for.
+        size_t pos = 0;
+        for ( size_t step = topBit_; step > 0; step >>= 1 ) {
+            const size_t next = pos + step;
+            if ( next <= n_ && tree_[next] <= target ) {
+                pos = next;
+                target -= tree_[next];
+            }
+        }
+        return pos;
+    }
+
+    size_t FenwickTree::size() const { return n_; }
+}
@@ -0,0 +1,22 @@
+#include <AIToolbox/Impl/Barrier.hpp>
+
+namespace AIToolbox {
+    namespace Impl {
+        Barrier::Barrier(unsigned count) : count_(count), waiting_(0), generation_(0) {}
+
+        void Barrier::wait() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            const auto generation = generation_;
+
+            if ( ++waiting_ == count_ ) {
+                waiting_ = 0;
+                ++generation_;
+                cv_.notify_all();
+                return;
+            }
+            // The generation protects both from spurious wakeups and from
+            // threads which have already moved on to the next wait().
+            cv_.wait(lock, [this, generation]{ return generation != generation_; });
+        }
+    }
+}
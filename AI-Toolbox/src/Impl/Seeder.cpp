@@ -1,17 +1,40 @@
 #include <AIToolbox/Impl/Seeder.hpp>
 
+#include <atomic>
 #include <chrono>
-#include <limits>
 
 namespace AIToolbox {
     namespace Impl {
-        Seeder::Seeder() : generator_(std::chrono::system_clock::now().time_since_epoch().count()) {}
+        namespace {
+            // Salt separating getStream() from getSeed().
+            constexpr std::uint64_t streamSalt = 0x5bd1e9955bd1e995ull;
 
-        unsigned Seeder::getSeed() {
-            static Seeder instance;
-            static std::uniform_int_distribution<unsigned> dist(0, std::numeric_limits<unsigned>::max());
+            std::atomic<std::uint64_t> & rootSeed() {
+                static std::atomic<std::uint64_t> seed(std::chrono::system_clock::now().time_since_epoch().count());
+                return seed;
+            }
 
-            return dist(instance.generator_);
+            std::atomic<std::uint64_t> & counter() {
+                static std::atomic<std::uint64_t> c(0);
+                return c;
+            }
+        }
+
+        std::uint64_t Seeder::getSeed() {
+            return mixBits(rootSeed().load() ^ mixBits(counter().fetch_add(1)));
+        }
+
+        RandomEngine Seeder::getStream(std::uint64_t id) {
+            return RandomEngine(mixBits(rootSeed().load() ^ mixBits(id ^ streamSalt)));
+        }
+
+        void Seeder::setRootSeed(std::uint64_t seed) {
+            rootSeed() = seed;
+            counter() = 0;
+        }
+
+        std::uint64_t Seeder::getRootSeed() {
+            return rootSeed().load();
         }
     }
 }
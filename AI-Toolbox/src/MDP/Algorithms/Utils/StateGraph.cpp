@@ -0,0 +1,137 @@
+#include <AIToolbox/MDP/Algorithms/Utils/StateGraph.hpp>
+
+#include <algorithm>
+
+namespace AIToolbox {
+    namespace MDP {
+        void StateGraph::computePredecessors() {
+            predecessorsStart_.assign(S + 1, 0);
+            predecessors_.resize(successors_.size());
+
+            // Counting sort of the edges by destination.
+            for ( auto s1 : successors_ )
+                ++predecessorsStart_[s1 + 1];
+            for ( size_t s = 0; s < S; ++s )
+                predecessorsStart_[s + 1] += predecessorsStart_[s];
+
+            std::vector<size_t> pos(std::begin(predecessorsStart_), std::end(predecessorsStart_) - 1);
+            for ( size_t s = 0; s < S; ++s )
+                for ( size_t i = successorsStart_[s]; i < successorsStart_[s + 1]; ++i )
+                    predecessors_[pos[successors_[i]]++] = s;
+        }
+
+        StateGraph::Components StateGraph::getComponents() const {
+            // Iterative version of Tarjan's algorithm, since recursion
+            // would overflow the stack on large models.
+            const size_t unvisited = S;
+            std::vector<size_t> index(S, unvisited), low(S);
+            std::vector<bool> onStack(S, false);
+            std::vector<size_t> stack;
+            std::vector<std::pair<size_t, size_t>> calls;
+            size_t counter = 0;
+
+            Components components;
+            for ( size_t root = 0; root < S; ++root ) {
+                if ( index[root] != unvisited ) continue;
+
+                auto visit = [&](size_t s) {
+                    index[s] = low[s] = counter++;
+                    stack.push_back(s);
+                    onStack[s] = true;
+                    calls.emplace_back(s, successorsStart_[s]);
+                };
+                visit(root);
+
+                while ( calls.size() ) {
+                    const size_t s = calls.back().first;
+                    size_t & next = calls.back().second;
+
+                    if ( next < successorsStart_[s + 1] ) {
+                        const size_t s1 = successors_[next++];
+                        if ( index[s1] == unvisited )
+                            visit(s1);
+                        else if ( onStack[s1] )
+                            low[s] = std::min(low[s], index[s1]);
+                        continue;
+                    }
+
+                    // All successors have been visited; if s is the root
+                    // of a component, everything above it on the stack is
+                    // in its component.
+                    if ( low[s] == index[s] ) {
+                        components.emplace_back();
+                        auto & component = components.back();
+                        size_t s1;
+                        do {
+                            s1 = stack.back();
+                            stack.pop_back();
+                            onStack[s1] = false;
+                            component.push_back(s1);
+                        } while ( s1 != s );
+                    }
+                    calls.pop_back();
+                    if ( calls.size() )
+                        low[calls.back().first] = std::min(low[calls.back().first], low[s]);
+                }
+            }
+            return components;
+        }
+
+        void StateGraph::sortComponent(std::vector<size_t> * pc) const {
+            auto & component = *pc;
+            if ( component.size() < 2 ) return;
+
+            // We mark the states of the component, and find its exits.
+            std::vector<bool> inComponent(S, false), queued(S, false);
+            for ( auto s : component ) inComponent[s] = true;
+
+            std::vector<size_t> queue;
+            queue.reserve(component.size());
+            for ( auto s : component ) {
+                for ( size_t i = successorsStart_[s]; i < successorsStart_[s + 1]; ++i ) {
+                    if ( !inComponent[successors_[i]] ) {
+                        queue.push_back(s);
+                        queued[s] = true;
+                        break;
+                    }
+                }
+            }
+            // Closed components have no preferred direction.
+            if ( queue.empty() ) return;
+
+            // Breadth first search backwards from the exits.
+            for ( size_t head = 0; head < queue.size(); ++head ) {
+                const size_t s = queue[head];
+                for ( size_t i = predecessorsStart_[s]; i < predecessorsStart_[s + 1]; ++i ) {
+                    const size_t p = predecessors_[i];
+                    if ( inComponent[p] && !queued[p] ) {
+                        queued[p] = true;
+                        queue.push_back(p);
+                    }
+                }
+            }
+            component = std::move(queue);
+        }
+
+        std::vector<size_t> StateGraph::getReverseTopologicalOrder() const {
+            std::vector<size_t> order;
+            order.reserve(S);
+
+            for ( auto & component : getComponents() ) {
+                sortComponent(&component);
+                order.insert(std::end(order), std::begin(component), std::end(component));
+            }
+            return order;
+        }
+
+        size_t StateGraph::getS() const { return S; }
+
+        std::pair<const size_t *, const size_t *> StateGraph::getSuccessors(size_t s) const {
+            return std::make_pair(successors_.data() + successorsStart_[s], successors_.data() + successorsStart_[s + 1]);
+        }
+
+        std::pair<const size_t *, const size_t *> StateGraph::getPredecessors(size_t s) const {
+            return std::make_pair(predecessors_.data() + predecessorsStart_[s], predecessors_.data() + predecessorsStart_[s + 1]);
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#include <AIToolbox/MDP/Algorithms/Utils/TransitionIndex.hpp>
+
+namespace AIToolbox {
+    namespace MDP {
+        void TransitionIndex::compact() {
+            std::vector<size_t> start(S * A + 1, 0), successors;
+            successors.reserve(successors_.size() + newTransitions_);
+
+            for ( size_t p = 0; p < S * A; ++p ) {
+                successors.insert(std::end(successors), std::begin(successors_) + successorsStart_[p], std::begin(successors_) + successorsStart_[p + 1]);
+                const auto extra = newSuccessors_.find(p);
+                if ( extra != std::end(newSuccessors_) )
+                    successors.insert(std::end(successors), std::begin(extra->second), std::end(extra->second));
+                start[p + 1] = successors.size();
+            }
+            successorsStart_ = std::move(start);
+            successors_ = std::move(successors);
+
+            newSuccessors_.clear();
+            for ( auto & p : newPredecessors_ ) p.clear();
+            newTransitions_ = 0;
+
+            computePredecessors();
+        }
+
+        void TransitionIndex::computePredecessors() {
+            predecessorsStart_.assign(S + 1, 0);
+            predecessors_.resize(successors_.size());
+
+            // Counting sort of the transitions by destination.
+            for ( auto s1 : successors_ )
+                ++predecessorsStart_[s1 + 1];
+            for ( size_t s = 0; s < S; ++s )
+                predecessorsStart_[s + 1] += predecessorsStart_[s];
+
+            std::vector<size_t> pos(std::begin(predecessorsStart_), std::end(predecessorsStart_) - 1);
+            for ( size_t p = 0; p < S * A; ++p )
+                for ( size_t i = successorsStart_[p]; i < successorsStart_[p + 1]; ++i )
+                    predecessors_[pos[successors_[i]]++] = p;
+        }
+
+        size_t TransitionIndex::getTransitions() const {
+            return successors_.size() + newTransitions_;
+        }
+    }
+}
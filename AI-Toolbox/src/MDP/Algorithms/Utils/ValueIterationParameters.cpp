@@ -0,0 +1,47 @@
+#include <AIToolbox/MDP/Algorithms/Utils/ValueIterationParameters.hpp>
+
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include <AIToolbox/MDP/Utils.hpp>
+
+namespace AIToolbox {
+    namespace MDP {
+        ValueIterationParameters::ValueIterationParameters(unsigned horizon, double epsilon, ValueFunction v) :
+            horizon_(horizon), vParameter_(std::move(v))
+        {
+            setEpsilon(epsilon);
+        }
+
+        void ValueIterationParameters::setEpsilon(double e) {
+            if ( e < 0.0 ) throw std::invalid_argument("Epsilon must be >= 0");
+            epsilon_ = e;
+        }
+
+        void ValueIterationParameters::setHorizon(unsigned h) {
+            horizon_ = h;
+        }
+
+        void ValueIterationParameters::setValueFunction(ValueFunction v) {
+            vParameter_ = std::move(v);
+        }
+
+        double ValueIterationParameters::getEpsilon() const { return epsilon_; }
+
+        unsigned ValueIterationParameters::getHorizon() const { return horizon_; }
+
+        const ValueFunction & ValueIterationParameters::getValueFunction() const { return vParameter_; }
+
+        ValueFunction makeStartingValueFunction(const ValueFunction & v, size_t S, const char * name) {
+            // Verify that parameter value function is compatible.
+            const size_t size = std::get<VALUES>(v).size();
+            if ( size == S ) return v;
+
+            if ( size != 0 )
+                std::cerr << "AIToolbox: Size of starting value function in " << name << " is incorrect, ignoring...\n";
+            // Defaulting
+            return makeValueFunction(S);
+        }
+    }
+}
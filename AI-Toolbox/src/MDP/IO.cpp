@@ -91,6 +91,9 @@ namespace AIToolbox {
                         in.transitions_[a](s, s) = 1.0;
                 }
             }
+            in.computeExpectedRewards();
+            in.setCompactRewards(m.getCompactRewards());
+            in.setAliasSampling(m.getAliasSampling());
             // This guarantees that if input is invalid we still keep the old Model.
             std::swap(m, in);
 
@@ -129,6 +132,9 @@ namespace AIToolbox {
                         in.transitions_[a].coeffRef(s, s) = 1.0;
                 }
             }
+            in.computeExpectedRewards();
+            in.setCompactRewards(m.getCompactRewards());
+            in.setAliasSampling(m.getAliasSampling());
             // This guarantees that if input is invalid we still keep the old Model.
             std::swap(m, in);
 
@@ -3,7 +3,8 @@
 namespace AIToolbox {
     namespace MDP {
         Model::Model(size_t s, size_t a, double discount) : S(s), A(a), discount_(discount), transitions_(A, Matrix2D(S, S)), rewards_(A, Matrix2D(S, S)),
-                                                       rand_(Impl::Seeder::getSeed())
+                                                       expectedRewards_(Matrix2D::Zero(S, A)), compactRewards_(false),
+                                                       aliasSampling_(false), rand_(Impl::Seeder::getSeed())
         {
             // Make transition table true probability
             for ( size_t a = 0; a < A; ++a ) {
@@ -13,9 +14,7 @@ namespace AIToolbox {
         }
 
         std::tuple<size_t, double> Model::sampleSR(size_t s, size_t a) const {
-            size_t s1 = sampleProbability(S, transitions_[a].row(s), rand_);
-
-            return std::make_tuple(s1, rewards_[a](s, s1));
+            return sampleSR(s, a, rand_);
         }
 
         double Model::getTransitionProbability(size_t s, size_t a, size_t s1) const {
@@ -23,7 +22,7 @@ namespace AIToolbox {
         }
 
         double Model::getExpectedReward(size_t s, size_t a, size_t s1) const {
-            return rewards_[a](s, s1);
+            return compactRewards_ ? expectedRewards_(s, a) : rewards_[a](s, s1);
         }
 
         void Model::setDiscount(double d) {
@@ -31,6 +30,42 @@ namespace AIToolbox {
             discount_ = d;
         }
         
+        void Model::setAliasSampling(bool alias) {
+            aliasSampling_ = alias;
+            transitionSamplers_.clear();
+            if ( !aliasSampling_ ) return;
+
+            transitionSamplers_.reserve(A);
+            for ( size_t a = 0; a < A; ++a )
+                transitionSamplers_.emplace_back(transitions_[a]);
+        }
+
+        bool Model::getAliasSampling() const { return aliasSampling_; }
+
+        void Model::setCompactRewards(bool compact) {
+            if ( compact == compactRewards_ ) return;
+            compactRewards_ = compact;
+
+            if ( compactRewards_ ) {
+                // The expected rewards are always up to date, so we
+                // just need to free the full reward matrices.
+                for ( auto & r : rewards_ )
+                    Matrix2D().swap(r);
+            }
+            else {
+                for ( size_t a = 0; a < A; ++a )
+                    rewards_[a] = expectedRewards_.col(a).replicate(1, S);
+            }
+        }
+
+        bool Model::getCompactRewards() const { return compactRewards_; }
+
+        void Model::computeExpectedRewards() {
+            if ( compactRewards_ ) return;
+            for ( size_t a = 0; a < A; ++a )
+                expectedRewards_.col(a).noalias() = transitions_[a].cwiseProduct(rewards_[a]) * Vector::Ones(S);
+        }
+
         void Model::setStates(std::vector<std::string> states) {
 	  states_ = states;
 	}
@@ -59,5 +94,7 @@ namespace AIToolbox {
 
         const Matrix2D & Model::getTransitionFunction(size_t a) const { return transitions_[a]; }
         const Matrix2D & Model::getRewardFunction(size_t a)     const { return rewards_[a]; }
+
+        const Matrix2D & Model::getExpectedRewardFunction() const { return expectedRewards_; }
     }
 }
@@ -0,0 +1,145 @@
+#include <AIToolbox/MDP/Policies/FiniteHorizonPolicy.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+namespace AIToolbox {
+    namespace MDP {
+        FiniteHorizonPolicy::FiniteHorizonPolicy(size_t s, size_t a) :
+            PolicyInterface<size_t>(s, a), bits_(1)
+        {
+            while ( bits_ < 64 && (Word(1) << bits_) < A ) ++bits_;
+            perWord_ = 64 / bits_;
+            wordsPerStep_ = (S + perWord_ - 1) / perWord_;
+            mask_ = bits_ == 64 ? ~Word(0) : (Word(1) << bits_) - 1;
+        }
+
+        void FiniteHorizonPolicy::pushStep(const Actions & actions) {
+            if ( actions.size() != S ) throw std::invalid_argument("Actions must have size S");
+            for ( auto a : actions )
+                if ( a >= A ) throw std::invalid_argument("Action is out of range");
+
+            const size_t begin = words_.size();
+            words_.resize(begin + wordsPerStep_, 0);
+            for ( size_t s = 0; s < S; ++s )
+                words_[begin + s / perWord_] |= Word(actions[s]) << ((s % perWord_) * bits_);
+
+            // If nothing changed from the previous horizon, we reuse its actions.
+            if ( steps_.size() && std::equal(std::begin(words_) + begin, std::end(words_), std::begin(words_) + steps_.back()) ) {
+                words_.resize(begin);
+                steps_.push_back(steps_.back());
+            }
+            else
+                steps_.push_back(begin);
+        }
+
+        size_t FiniteHorizonPolicy::getAction(size_t s, unsigned horizon) const {
+            if ( !horizon || horizon > steps_.size() ) throw std::invalid_argument("The horizon must be between 1 and the number of horizons in the policy");
+
+            const Word w = words_[steps_[horizon - 1] + s / perWord_];
+            return (w >> ((s % perWord_) * bits_)) & mask_;
+        }
+
+        size_t FiniteHorizonPolicy::sampleAction(const size_t & s) const {
+            // Without any horizon we act randomly, like an empty Policy.
+            if ( steps_.empty() ) {
+                std::uniform_int_distribution<size_t> dist(0, A-1);
+                return dist(rand_);
+            }
+            return getAction(s, steps_.size());
+        }
+
+        size_t FiniteHorizonPolicy::sampleAction(const size_t & s, unsigned horizon) const {
+            return getAction(s, horizon);
+        }
+
+        double FiniteHorizonPolicy::getActionProbability(const size_t & s, size_t a) const {
+            if ( steps_.empty() ) return 1.0 / A;
+            return getActionProbability(s, a, steps_.size());
+        }
+
+        double FiniteHorizonPolicy::getActionProbability(const size_t & s, size_t a, unsigned horizon) const {
+            return static_cast<double>( getAction(s, horizon) == a );
+        }
+
+        Actions FiniteHorizonPolicy::getStep(unsigned horizon) const {
+            Actions actions(S);
+            for ( size_t s = 0; s < S; ++s )
+                actions[s] = getAction(s, horizon);
+            return actions;
+        }
+
+        size_t FiniteHorizonPolicy::getH() const {
+            return steps_.size();
+        }
+
+        size_t FiniteHorizonPolicy::getStoredSteps() const {
+            return wordsPerStep_ ? words_.size() / wordsPerStep_ : 0;
+        }
+
+        FiniteHorizonPolicyWriter::FiniteHorizonPolicyWriter(std::ostream & os, unsigned horizon) : os_(os) {
+            os_ << horizon << '\n';
+        }
+
+        void FiniteHorizonPolicyWriter::operator()(unsigned horizon, const Actions & actions) {
+            os_ << horizon << '\t';
+            if ( horizon > 1 && actions == last_ ) {
+                os_ << 0 << '\n';
+                return;
+            }
+            os_ << actions.size();
+            for ( auto a : actions )
+                os_ << '\t' << a;
+            os_ << '\n';
+            last_ = actions;
+        }
+
+        std::ostream& operator<<(std::ostream &os, const FiniteHorizonPolicy & p) {
+            const size_t H = p.getH();
+            FiniteHorizonPolicyWriter writer(os, H);
+            for ( size_t h = 1; h <= H; ++h )
+                writer(h, p.getStep(h));
+            return os;
+        }
+
+        std::istream& operator>>(std::istream &is, FiniteHorizonPolicy & p) {
+            const size_t S = p.getS(), A = p.getA();
+
+            FiniteHorizonPolicy in(S, A);
+
+            unsigned H, hcheck;
+            size_t n;
+            Actions actions(S);
+
+            auto fail = [&is](const char * message) -> std::istream& {
+                std::cerr << "AIToolbox: " << message << '\n';
+                is.setstate(std::ios::failbit);
+                return is;
+            };
+
+            if ( !(is >> H) ) return fail("Could not read policy data.");
+            for ( unsigned h = 1; h <= H; ++h ) {
+                if ( !(is >> hcheck >> n) )
+                    return fail("Could not read policy data.");
+                if ( hcheck != h )
+                    return fail("Input policy data is not sorted by horizon.");
+                if ( n != S && (n != 0 || h == 1) )
+                    return fail("Input policy data has the wrong number of actions.");
+                for ( size_t s = 0; s < n; ++s ) {
+                    if ( !(is >> actions[s]) )
+                        return fail("Could not read policy data.");
+                    if ( actions[s] >= A )
+                        return fail("Input policy data contains out of range actions.");
+                }
+                in.pushStep(actions);
+            }
+            // This guarantees that if input is invalid we still keep the old Policy.
+            std::swap(p.words_, in.words_);
+            std::swap(p.steps_, in.steps_);
+
+            return is;
+        }
+    }
+}
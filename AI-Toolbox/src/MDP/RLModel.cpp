@@ -6,7 +6,7 @@
 namespace AIToolbox {
     namespace MDP {
         RLModel::RLModel( const Experience & exp, double discount, bool toSync ) : S(exp.getS()), A(exp.getA()), experience_(exp), transitions_(A, Matrix2D(S, S)), rewards_(A, Matrix2D(S, S)),
-                                                       rand_(Impl::Seeder::getSeed())
+                                                       samplers_(S * A, FenwickTree(S)), rand_(Impl::Seeder::getSeed())
         {
             setDiscount(discount);
             for ( size_t a = 0; a < A; ++a )
@@ -57,6 +57,7 @@ namespace AIToolbox {
                 }
                 transitions_[a](s, s1) = static_cast<double>(visits) * visitSumReciprocal;
             }
+            samplers_[s * A + a].assign(experience_.getVisitTable()[s][a]);
         }
 
         void RLModel::sync(size_t s, size_t a, size_t s1) {
@@ -68,7 +69,10 @@ namespace AIToolbox {
             // those by forcing a true update using real data.
             if ( visitSum < 2ul || !(visitSum % 10000ul) ) return sync(s, a);
 
-            double newVisits = static_cast<double>(experience_.getVisits(s, a, s1));
+            unsigned long visits = experience_.getVisits(s, a, s1);
+            samplers_[s * A + a].set(s1, visits);
+
+            double newVisits = static_cast<double>(visits);
 
             // Update reward for this transition (all others stay the same).
             rewards_[a](s, s1) = experience_.getReward(s, a, s1) / newVisits;
@@ -84,9 +88,7 @@ namespace AIToolbox {
         }
 
         std::tuple<size_t, double> RLModel::sampleSR(size_t s, size_t a) const {
-            size_t s1 = sampleProbability(S, transitions_[a].row(s), rand_);
-
-            return std::make_tuple(s1, rewards_[a](s, s1));
+            return sampleSR(s, a, rand_);
         }
 
         double RLModel::getTransitionProbability(size_t s, size_t a, size_t s1) const {
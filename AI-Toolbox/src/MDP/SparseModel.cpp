@@ -3,7 +3,8 @@
 namespace AIToolbox {
     namespace MDP {
         SparseModel::SparseModel(size_t s, size_t a, double discount) : S(s), A(a), discount_(discount), transitions_(A, SparseMatrix2D(S, S)), rewards_(A, SparseMatrix2D(S, S)),
-                                                                        rand_(Impl::Seeder::getSeed())
+                                                                        expectedRewards_(Matrix2D::Zero(S, A)), compactRewards_(false),
+                                                                        aliasSampling_(false), rand_(Impl::Seeder::getSeed())
         {
             // Make transition table true probability
             for ( size_t a = 0; a < A; ++a )
@@ -12,9 +13,7 @@ namespace AIToolbox {
         }
 
         std::tuple<size_t, double> SparseModel::sampleSR(size_t s, size_t a) const {
-            size_t s1 = sampleProbability(S, transitions_[a].row(s), rand_);
-
-            return std::make_tuple(s1, getExpectedReward(s, a, s1));
+            return sampleSR(s, a, rand_);
         }
 
         double SparseModel::getTransitionProbability(size_t s, size_t a, size_t s1) const {
@@ -22,7 +21,7 @@ namespace AIToolbox {
         }
 
         double SparseModel::getExpectedReward(size_t s, size_t a, size_t s1) const {
-            return rewards_[a].coeff(s, s1);
+            return compactRewards_ ? expectedRewards_(s, a) : rewards_[a].coeff(s, s1);
         }
 
         void SparseModel::setDiscount(double d) {
@@ -30,6 +29,46 @@ namespace AIToolbox {
             discount_ = d;
         }
 
+        void SparseModel::setAliasSampling(bool alias) {
+            aliasSampling_ = alias;
+            transitionSamplers_.clear();
+            if ( !aliasSampling_ ) return;
+
+            transitionSamplers_.reserve(A);
+            for ( size_t a = 0; a < A; ++a )
+                transitionSamplers_.emplace_back(transitions_[a]);
+        }
+
+        bool SparseModel::getAliasSampling() const { return aliasSampling_; }
+
+        void SparseModel::setCompactRewards(bool compact) {
+            if ( compact == compactRewards_ ) return;
+            compactRewards_ = compact;
+
+            if ( compactRewards_ ) {
+                for ( auto & r : rewards_ )
+                    SparseMatrix2D().swap(r);
+            }
+            else {
+                // Rewards are only needed where transitions are possible.
+                for ( size_t a = 0; a < A; ++a ) {
+                    rewards_[a] = transitions_[a];
+                    for ( size_t s = 0; s < S; ++s )
+                        for ( SparseMatrix2D::InnerIterator it(rewards_[a], s); it; ++it )
+                            it.valueRef() = expectedRewards_(s, a);
+                    rewards_[a].prune([](SparseMatrix2D::Index, SparseMatrix2D::Index, Scalar v) { return checkDifferentSmall(0.0, v); });
+                }
+            }
+        }
+
+        bool SparseModel::getCompactRewards() const { return compactRewards_; }
+
+        void SparseModel::computeExpectedRewards() {
+            if ( compactRewards_ ) return;
+            for ( size_t a = 0; a < A; ++a )
+                expectedRewards_.col(a).noalias() = transitions_[a].cwiseProduct(rewards_[a]) * Vector::Ones(S);
+        }
+
         bool SparseModel::isTerminal(size_t s) const {
             bool answer = true;
             for ( size_t a = 0; a < A; ++a ) {
@@ -50,5 +89,7 @@ namespace AIToolbox {
 
         const SparseMatrix2D & SparseModel::getTransitionFunction(size_t a) const { return transitions_[a]; }
         const SparseMatrix2D & SparseModel::getRewardFunction(size_t a)     const { return rewards_[a]; }
+
+        const Matrix2D & SparseModel::getExpectedRewardFunction() const { return expectedRewards_; }
     }
 }
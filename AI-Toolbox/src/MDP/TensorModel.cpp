@@ -0,0 +1,98 @@
+#include <AIToolbox/MDP/TensorModel.hpp>
+
+namespace AIToolbox {
+    namespace MDP {
+        TensorModel::TensorModel(size_t s, size_t a, double discount, TensorLayout layout) :
+                S(s), A(a), discount_(discount), layout_(layout), transitions_(Vector::Zero(S * A * S)), rewards_(Vector::Zero(S * A * S)),
+                rand_(Impl::Seeder::getSeed())
+        {
+            makeViews();
+            // Make transition table true probability
+            for ( size_t a = 0; a < A; ++a )
+                for ( size_t s = 0; s < S; ++s )
+                    transitions_[index(s, a, s)] = 1.0;
+        }
+
+        TensorModel::TensorModel(const TensorModel & other) :
+                S(other.S), A(other.A), discount_(other.discount_), layout_(other.layout_),
+                transitions_(other.transitions_), rewards_(other.rewards_), rand_(Impl::Seeder::getSeed())
+        {
+            makeViews();
+        }
+
+        TensorModel & TensorModel::operator=(const TensorModel & other) {
+            if ( this == &other ) return *this;
+
+            S = other.S; A = other.A;
+            discount_ = other.discount_;
+            layout_ = other.layout_;
+            transitions_ = other.transitions_;
+            rewards_ = other.rewards_;
+            makeViews();
+
+            return *this;
+        }
+
+        void TensorModel::makeViews() {
+            // Rows of an action matrix are S apart in ACTION_MAJOR layout,
+            // and A*S apart in STATE_MAJOR layout.
+            const size_t stride = layout_ == STATE_MAJOR ? A * S : S;
+
+            transitionViews_.clear();
+            rewardViews_.clear();
+            transitionViews_.reserve(A);
+            rewardViews_.reserve(A);
+            for ( size_t a = 0; a < A; ++a ) {
+                const size_t begin = index(0, a, 0);
+                transitionViews_.emplace_back(transitions_.data() + begin, S, S, Eigen::OuterStride<>(stride));
+                rewardViews_.emplace_back(rewards_.data() + begin, S, S, Eigen::OuterStride<>(stride));
+            }
+        }
+
+        TensorModel::MutableView TensorModel::actionView(Vector & buffer, size_t a) {
+            return MutableView(buffer.data() + index(0, a, 0), S, S, Eigen::OuterStride<>(layout_ == STATE_MAJOR ? A * S : S));
+        }
+
+        std::tuple<size_t, double> TensorModel::sampleSR(size_t s, size_t a) const {
+            return sampleSR(s, a, rand_);
+        }
+
+        double TensorModel::getTransitionProbability(size_t s, size_t a, size_t s1) const {
+            return transitions_[index(s, a, s1)];
+        }
+
+        double TensorModel::getExpectedReward(size_t s, size_t a, size_t s1) const {
+            return rewards_[index(s, a, s1)];
+        }
+
+        void TensorModel::setDiscount(double d) {
+            if ( d <= 0.0 || d > 1.0 ) throw std::invalid_argument("Discount parameter must be in (0,1]");
+            discount_ = d;
+        }
+
+        bool TensorModel::isTerminal(size_t s) const {
+            // With STATE_MAJOR layout these are all in the same block.
+            const auto t = getStateTransitions(s);
+            for ( size_t a = 0; a < A; ++a )
+                if ( !checkEqualSmall(1.0, t(a, s)) )
+                    return false;
+            return true;
+        }
+
+        size_t TensorModel::getS() const { return S; }
+        size_t TensorModel::getA() const { return A; }
+        double TensorModel::getDiscount() const { return discount_; }
+        TensorLayout TensorModel::getLayout() const { return layout_; }
+
+        const TensorModel::MatrixView & TensorModel::getTransitionFunction(size_t a) const { return transitionViews_[a]; }
+        const TensorModel::MatrixView & TensorModel::getRewardFunction(size_t a)     const { return rewardViews_[a]; }
+
+        TensorModel::MatrixView TensorModel::getStateTransitions(size_t s) const {
+            return MatrixView(transitions_.data() + index(s, 0, 0), A, S, Eigen::OuterStride<>(layout_ == STATE_MAJOR ? S : S * S));
+        }
+
+        TensorModel::MatrixView TensorModel::getStateRewards(size_t s) const {
+            return MatrixView(rewards_.data() + index(s, 0, 0), A, S, Eigen::OuterStride<>(layout_ == STATE_MAJOR ? S : S * S));
+        }
+    }
+}
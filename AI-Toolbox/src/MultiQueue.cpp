@@ -0,0 +1,126 @@
+#include <AIToolbox/MultiQueue.hpp>
+
+#include <limits>
+#include <utility>
+
+namespace AIToolbox {
+    constexpr unsigned MultiQueue::none;
+
+    MultiQueue::Queue::Queue(size_t * positions) : heap(positions), top(-std::numeric_limits<double>::infinity()) {}
+
+    MultiQueue::MultiQueue(size_t n, unsigned queues) : owners_(new std::atomic<unsigned>[n]), positions_(new size_t[n]), size_(0), n_(n) {
+        for ( size_t i = 0; i < n; ++i ) {
+            owners_[i].store(none, std::memory_order_relaxed);
+            positions_[i] = IndexedHeap<>::npos;
+        }
+        setQueues(queues);
+    }
+
+    void MultiQueue::push(size_t i, double priority, RandomEngine & rand) {
+        while ( true ) {
+            unsigned h = owners_[i].load();
+            if ( h == none ) {
+                h = rand() % queues_.size();
+                Queue & q = *queues_[h];
+                std::lock_guard<std::mutex> lock(q.mutex);
+
+                // Someone else may have queued the index in the meantime.
+                unsigned expected = none;
+                if ( !owners_[i].compare_exchange_strong(expected, h) ) continue;
+
+                q.heap.push(i, priority);
+                ++size_;
+                updateTop(q);
+                return;
+            }
+            Queue & q = *queues_[h];
+            std::lock_guard<std::mutex> lock(q.mutex);
+
+            // The index may have been popped before we took the lock.
+            if ( owners_[i].load() != h ) continue;
+
+            if ( q.heap.getPriority(i) < priority ) {
+                q.heap.push(i, priority);
+                updateTop(q);
+            }
+            return;
+        }
+    }
+
+    bool MultiQueue::pop(size_t * i, RandomEngine & rand) {
+        const size_t queues = queues_.size();
+        while ( size_.load() ) {
+            size_t h = rand() % queues;
+            const size_t h2 = rand() % queues;
+            if ( queues_[h2]->top.load() > queues_[h]->top.load() ) h = h2;
+
+            if ( popFrom(h, i) ) return true;
+
+            // The chosen heaps looked empty; we look for an index in the
+            // others, as there might be only a few left.
+            for ( size_t k = 1; k < queues; ++k )
+                if ( popFrom((h + k) % queues, i) ) return true;
+        }
+        return false;
+    }
+
+    bool MultiQueue::popFrom(size_t h, size_t * i) {
+        Queue & q = *queues_[h];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if ( q.heap.empty() ) return false;
+
+        *i = q.heap.top();
+        q.heap.pop();
+        owners_[*i].store(none);
+        --size_;
+        updateTop(q);
+        return true;
+    }
+
+    void MultiQueue::updateTop(Queue & q) {
+        q.top.store(q.heap.empty() ? -std::numeric_limits<double>::infinity() : q.heap.topPriority());
+    }
+
+    void MultiQueue::clear() {
+        for ( auto & q : queues_ ) {
+            q->heap.clear();
+            updateTop(*q);
+        }
+        for ( size_t i = 0; i < n_; ++i )
+            owners_[i].store(none, std::memory_order_relaxed);
+        size_ = 0;
+    }
+
+    void MultiQueue::setQueues(unsigned queues) {
+        if ( queues == 0 ) queues = 1;
+
+        // We empty the old heaps, and spread their indices over the new
+        // ones in turn.
+        std::vector<std::pair<size_t, double>> queued;
+        queued.reserve(size_.load());
+        for ( auto & q : queues_ ) {
+            while ( !q->heap.empty() ) {
+                queued.emplace_back(q->heap.top(), q->heap.topPriority());
+                q->heap.pop();
+            }
+        }
+
+        queues_.clear();
+        queues_.reserve(queues);
+        for ( unsigned h = 0; h < queues; ++h )
+            queues_.emplace_back(new Queue(positions_.get()));
+
+        for ( size_t k = 0; k < queued.size(); ++k ) {
+            const unsigned h = k % queues;
+            queues_[h]->heap.push(queued[k].first, queued[k].second);
+            owners_[queued[k].first].store(h, std::memory_order_relaxed);
+        }
+        for ( auto & q : queues_ )
+            updateTop(*q);
+    }
+
+    unsigned MultiQueue::getQueues() const { return queues_.size(); }
+
+    size_t MultiQueue::size() const { return size_.load(); }
+    bool MultiQueue::empty() const { return size() == 0; }
+}
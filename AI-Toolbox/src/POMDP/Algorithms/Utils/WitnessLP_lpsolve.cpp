@@ -1,5 +1,7 @@
 #include <AIToolbox/POMDP/Algorithms/Utils/WitnessLP_lpsolve.hpp>
 
+#include <AIToolbox/Utils.hpp>
+
 #include <lpsolve/lp_lib.h>
 
 namespace AIToolbox {
@@ -102,11 +104,18 @@ namespace AIToolbox {
             // of the supplied ValueFunction is greater than ALL others. Thus we just need
             // to verify that the variable we have minimized is actually less than 0.
             bool isSolved = !( result > 1 || value <= 0.0 );
+#ifdef AI_TOOLBOX_FLOAT
+            // With float storage, values that are zero within float
+            // precision are just rounding noise in the input vectors, and
+            // are not witnesses. Double builds keep the exact check.
+            isSolved = isSolved && !checkEqualSmall(value, 0.0);
+#endif
 
             POMDP::Belief solution;
 
+            // lp_solve always works with REAL, which may differ from our Scalar.
             if ( isSolved )
-                solution = Eigen::Map<POMDP::Belief>(vp, S);
+                solution = Eigen::Map<Eigen::Matrix<REAL, Eigen::Dynamic, 1>>(vp, S).cast<Scalar>();
 
             popRow();
             return std::make_pair(isSolved, solution);
@@ -0,0 +1,44 @@
+#include <AIToolbox/RandomEngine.hpp>
+
+namespace AIToolbox {
+    RandomEngine::RandomEngine(result_type seed) {
+        this->seed(seed);
+    }
+
+    void RandomEngine::seed(result_type seed) {
+        // splitmix64 never outputs four zeroes in a row, so the state is
+        // always valid.
+        for ( auto & s : s_ ) {
+            s = mixBits(seed);
+            seed += 0x9e3779b97f4a7c15ull;
+        }
+    }
+
+    void RandomEngine::discard(unsigned long long z) {
+        while ( z-- ) (*this)();
+    }
+
+    void RandomEngine::jump() {
+        static const result_type JUMP[] = { 0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull, 0x39abdc4529b1661cull };
+
+        std::array<result_type, 4> s = {{ 0, 0, 0, 0 }};
+        for ( auto j : JUMP ) {
+            for ( int b = 0; b < 64; ++b ) {
+                if ( j & (result_type(1) << b) )
+                    for ( int i = 0; i < 4; ++i )
+                        s[i] ^= s_[i];
+                (*this)();
+            }
+        }
+        s_ = s;
+    }
+
+    RandomEngine RandomEngine::split() {
+        RandomEngine retval(*this);
+        jump();
+        return retval;
+    }
+
+    bool RandomEngine::operator==(const RandomEngine & other) const { return s_ == other.s_; }
+    bool RandomEngine::operator!=(const RandomEngine & other) const { return !(*this == other); }
+}
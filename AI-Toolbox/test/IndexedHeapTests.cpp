@@ -0,0 +1,48 @@
+#define BOOST_TEST_MODULE IndexedHeap
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/IndexedHeap.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE( indexed_heap ) {
+    const size_t N = 50;
+
+    AIToolbox::IndexedHeap<3> heap(N);
+    std::vector<double> reference(N, -1.0);
+
+    std::mt19937 rand(3);
+    std::uniform_int_distribution<size_t> index(0, N - 1);
+    std::uniform_real_distribution<double> priority(0.0, 1.0);
+
+    for ( unsigned i = 0; i < 20000; ++i ) {
+        if ( i % 3 && heap.size() ) {
+            const auto best = std::max_element(std::begin(reference), std::end(reference));
+            BOOST_CHECK_EQUAL( heap.topPriority(), *best );
+            BOOST_CHECK_EQUAL( heap.top(), static_cast<size_t>(best - std::begin(reference)) );
+            heap.pop();
+            *best = -1.0;
+        } else {
+            // Priorities can both increase and decrease.
+            const size_t j = index(rand);
+            const double p = priority(rand);
+            heap.push(j, p);
+            reference[j] = p;
+        }
+        const size_t queued = std::count_if(std::begin(reference), std::end(reference), [](double p){ return p >= 0.0; });
+        BOOST_CHECK_EQUAL( heap.size(), queued );
+    }
+    for ( size_t j = 0; j < N; ++j ) {
+        BOOST_CHECK_EQUAL( heap.contains(j), reference[j] >= 0.0 );
+        if ( heap.contains(j) ) BOOST_CHECK_EQUAL( heap.getPriority(j), reference[j] );
+    }
+
+    heap.clear();
+    BOOST_CHECK( heap.empty() );
+    for ( size_t j = 0; j < N; ++j )
+        BOOST_CHECK( !heap.contains(j) );
+}
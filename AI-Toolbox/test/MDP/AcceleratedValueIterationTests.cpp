@@ -0,0 +1,117 @@
+#define BOOST_TEST_MODULE MDP_AcceleratedValueIteration
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/MDP/Algorithms/AcceleratedValueIteration.hpp>
+#include <AIToolbox/MDP/Algorithms/ValueIteration.hpp>
+#include <AIToolbox/MDP/SparseModel.hpp>
+
+#include "CornerProblem.hpp"
+
+// A model where each action of each state leads to two far away states,
+// so that it mixes quickly.
+AIToolbox::MDP::Model makeMixingModel(size_t S, double discount) {
+    const size_t A = 3;
+    AIToolbox::Table3D transitions(boost::extents[S][A][S]);
+    AIToolbox::Table3D rewards(boost::extents[S][A][S]);
+    for ( size_t s = 0; s < S; ++s ) {
+        for ( size_t a = 0; a < A; ++a ) {
+            const size_t s1 = (s * 7 + a * 11 + 3) % S, s2 = (s * 13 + a * 5 + 1) % S;
+            const double r = static_cast<double>((s * 3 + a * 7) % 10) / 10.0;
+            transitions[s][a][s1] += 0.7;
+            transitions[s][a][s2] += 0.3;
+            rewards[s][a][s1] = r;
+            rewards[s][a][s2] = r;
+        }
+    }
+    return AIToolbox::MDP::Model(S, A, transitions, rewards, discount);
+}
+
+BOOST_AUTO_TEST_CASE( plainIsValueIteration ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+
+    Model model = makeCornerProblem(grid);
+    SparseModel sparseModel(model);
+
+    // Without relaxation and memory this is ValueIteration.
+    ValueIteration<Model> vi(1000000, 0.001);
+    AcceleratedValueIteration<Model> dense(1000000, 0.001, 1.0, 0);
+    AcceleratedValueIteration<SparseModel> sparse(1000000, 0.001, 1.0, 0);
+
+    auto vs = vi(model);
+    auto ds = dense(model);
+    auto ss = sparse(sparseModel);
+    BOOST_CHECK( std::get<0>(ds) );
+    BOOST_CHECK( std::get<0>(ss) );
+    BOOST_CHECK_EQUAL( dense.getRejections(), 0u );
+    BOOST_CHECK_EQUAL( dense.getIterations(), sparse.getIterations() );
+
+    const auto & vvalues = std::get<VALUES>(std::get<1>(vs));
+    const auto & dvalues = std::get<VALUES>(std::get<1>(ds));
+    const auto & svalues = std::get<VALUES>(std::get<1>(ss));
+    for ( size_t s = 0; s < model.getS(); ++s ) {
+        BOOST_CHECK_SMALL( dvalues(s) - vvalues(s), AIToolbox::Scalar(0.000001) );
+        BOOST_CHECK_SMALL( svalues(s) - vvalues(s), AIToolbox::Scalar(0.000001) );
+        BOOST_CHECK_EQUAL( std::get<ACTIONS>(std::get<1>(ds))[s], std::get<ACTIONS>(std::get<1>(vs))[s] );
+    }
+
+    // The horizon bounds the number of backups.
+    AcceleratedValueIteration<Model> shortSolver(3, 0.001, 1.0, 0);
+    BOOST_CHECK( !std::get<0>(shortSolver(model)) );
+    BOOST_CHECK_EQUAL( shortSolver.getIterations(), 3u );
+}
+
+BOOST_AUTO_TEST_CASE( andersonShortensTail ) {
+    using namespace AIToolbox::MDP;
+
+    Model model = makeMixingModel(60, 0.99);
+
+    AcceleratedValueIteration<Model> plain(1000000, 0.00001, 1.0, 0);
+    AcceleratedValueIteration<Model> anderson(1000000, 0.00001, 1.0, 5);
+    BOOST_CHECK_EQUAL( anderson.getMemory(), 5u );
+
+    auto ps = plain(model);
+    auto as = anderson(model);
+    BOOST_CHECK( std::get<0>(ps) );
+    BOOST_CHECK( std::get<0>(as) );
+
+    BOOST_CHECK( 3 * anderson.getIterations() < plain.getIterations() );
+
+    // Both are within epsilon * discount / (1 - discount) of the optimum.
+    const auto & pvalues = std::get<VALUES>(std::get<1>(ps));
+    const auto & avalues = std::get<VALUES>(std::get<1>(as));
+    for ( size_t s = 0; s < model.getS(); ++s ) {
+        BOOST_CHECK_SMALL( avalues(s) - pvalues(s), AIToolbox::Scalar(0.002) );
+        BOOST_CHECK_EQUAL( std::get<ACTIONS>(std::get<1>(as))[s], std::get<ACTIONS>(std::get<1>(ps))[s] );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( fallsBack ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    Model model = makeCornerProblem(grid);
+
+    ValueIteration<Model> vi(1000000, 0.00001);
+    auto vs = vi(model);
+    const auto & vvalues = std::get<VALUES>(std::get<1>(vs));
+
+    // Strong over-relaxation overshoots, so some of its steps need to be
+    // discarded, but the result must still be correct.
+    AcceleratedValueIteration<Model> solver(1000000, 0.00001, 1.9, 0);
+    BOOST_CHECK_EQUAL( solver.getRelaxation(), 1.9 );
+    auto ss = solver(model);
+    BOOST_CHECK( std::get<0>(ss) );
+    BOOST_CHECK( solver.getRejections() > 0 );
+
+    const auto & svalues = std::get<VALUES>(std::get<1>(ss));
+    for ( size_t s = 0; s < model.getS(); ++s )
+        BOOST_CHECK_SMALL( svalues(s) - vvalues(s), AIToolbox::Scalar(0.001) );
+
+    BOOST_CHECK_THROW( solver.setRelaxation(0.0), std::invalid_argument );
+    BOOST_CHECK_THROW( solver.setRelaxation(2.0), std::invalid_argument );
+    BOOST_CHECK_THROW( solver.setEpsilon(-1.0), std::invalid_argument );
+}
@@ -0,0 +1,99 @@
+#define BOOST_TEST_MODULE MDP_BatchValueIteration
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/MDP/Algorithms/BatchValueIteration.hpp>
+#include <AIToolbox/MDP/Algorithms/ValueIteration.hpp>
+#include <AIToolbox/MDP/SparseModel.hpp>
+
+#include "CornerProblem.hpp"
+
+BOOST_AUTO_TEST_CASE( agreesWithValueIteration ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+
+    const Model model = makeCornerProblem(grid);
+    const size_t S = model.getS(), A = model.getA();
+    SparseModel sparseModel(model);
+
+    // We create variants with different rewards and discounts, and solve
+    // each of them separately with ValueIteration.
+    std::vector<QFunction> rewards;
+    std::vector<double> discounts;
+    std::vector<std::tuple<bool, ValueFunction, QFunction>> expected;
+    for ( unsigned k = 0; k < 5; ++k ) {
+        AIToolbox::Table3D transitions(boost::extents[S][A][S]);
+        AIToolbox::Table3D r(boost::extents[S][A][S]);
+        for ( size_t s = 0; s < S; ++s )
+            for ( size_t a = 0; a < A; ++a )
+                for ( size_t s1 = 0; s1 < S; ++s1 ) {
+                    transitions[s][a][s1] = model.getTransitionProbability(s, a, s1);
+                    r[s][a][s1] = model.getExpectedReward(s, a, s1) * (k + 1) + (s1 == 5 ? k : 0.0);
+                }
+        Model variant(S, A, transitions, r, 0.5 + 0.1 * k);
+
+        rewards.push_back(computeImmediateRewards(variant));
+        discounts.push_back(variant.getDiscount());
+
+        ValueIteration<Model> vi(1000000, 0.001);
+        expected.push_back(vi(variant));
+    }
+
+    BatchValueIteration<Model> dense(1000000, 0.001);
+    BatchValueIteration<SparseModel> sparse(1000000, 0.001);
+    auto ds = dense(model, rewards, discounts);
+    auto ss = sparse(sparseModel, rewards, discounts);
+    BOOST_CHECK_EQUAL( ds.size(), rewards.size() );
+    BOOST_CHECK_EQUAL( ss.size(), rewards.size() );
+
+    for ( size_t k = 0; k < rewards.size(); ++k ) {
+        BOOST_CHECK( std::get<0>(ds[k]) );
+        BOOST_CHECK( std::get<0>(ss[k]) );
+        const auto & vvalues = std::get<VALUES>(std::get<1>(expected[k]));
+        const auto & dvalues = std::get<VALUES>(std::get<1>(ds[k]));
+        const auto & svalues = std::get<VALUES>(std::get<1>(ss[k]));
+        for ( size_t s = 0; s < S; ++s ) {
+            BOOST_CHECK_CLOSE( vvalues(s), dvalues(s), 0.0001 );
+            BOOST_CHECK_CLOSE( vvalues(s), svalues(s), 0.0001 );
+        }
+        BOOST_CHECK( std::get<ACTIONS>(std::get<1>(expected[k])) == std::get<ACTIONS>(std::get<1>(ds[k])) );
+        for ( size_t s = 0; s < S; ++s )
+            for ( size_t a = 0; a < A; ++a )
+                BOOST_CHECK_CLOSE( std::get<2>(expected[k])(s, a), std::get<2>(ds[k])(s, a), 0.0001 );
+    }
+
+    // Lower discounts converge sooner.
+    const auto & iterations = dense.getIterations();
+    BOOST_CHECK( std::is_sorted(std::begin(iterations), std::end(iterations)) );
+    BOOST_CHECK( iterations.front() < iterations.back() );
+}
+
+BOOST_AUTO_TEST_CASE( convergenceReport ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    const Model model = makeCornerProblem(grid);
+    const auto ir = computeImmediateRewards(model);
+
+    // With a few iterations, only the low discount variant converges.
+    BatchValueIteration<Model> solver(5, 0.001);
+    auto solutions = solver(model, { ir, ir }, { 0.1, 1.0 });
+    BOOST_CHECK( std::get<0>(solutions[0]) );
+    BOOST_CHECK( !std::get<0>(solutions[1]) );
+    BOOST_CHECK( solver.getIterations()[0] < 5u );
+    BOOST_CHECK_EQUAL( solver.getIterations()[1], 5u );
+
+    // Starting from a solution, its variant converges at once.
+    solver.setValueFunction(std::get<1>(solutions[0]));
+    solutions = solver(model, { ir }, { 0.1 });
+    BOOST_CHECK( std::get<0>(solutions[0]) );
+    BOOST_CHECK_EQUAL( solver.getIterations()[0], 1u );
+
+    BOOST_CHECK_THROW( solver.setEpsilon(-1.0), std::invalid_argument );
+
+    BOOST_CHECK_THROW( solver(model, { ir }, { 0.5, 0.5 }), std::invalid_argument );
+    BOOST_CHECK_THROW( solver(model, { ir }, { 0.0 }), std::invalid_argument );
+    BOOST_CHECK_THROW( solver(model, { QFunction(2, 2) }, { 0.5 }), std::invalid_argument );
+}
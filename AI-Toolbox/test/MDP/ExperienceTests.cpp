@@ -32,7 +32,8 @@ BOOST_AUTO_TEST_CASE( recording ) {
     AIToolbox::MDP::Experience exp(S, A);
 
     const int s = 3, s1 = 4, a = 5;
-    const double rew = 7.4, negrew = -4.2, zerorew = 0.0;
+    // Rewards are stored as Scalar, so we compare against Scalar values.
+    const AIToolbox::Scalar rew = 7.4, negrew = -4.2, zerorew = 0.0;
 
     BOOST_CHECK_EQUAL(exp.getVisits(s,a,s1), 0);
 
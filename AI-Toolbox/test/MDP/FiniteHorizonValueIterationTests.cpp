@@ -0,0 +1,147 @@
+#define BOOST_TEST_MODULE MDP_FiniteHorizonValueIteration
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+
+#include <AIToolbox/MDP/Algorithms/FiniteHorizonValueIteration.hpp>
+#include <AIToolbox/MDP/Algorithms/ValueIteration.hpp>
+#include <AIToolbox/MDP/Policies/FiniteHorizonPolicy.hpp>
+#include <AIToolbox/MDP/SparseModel.hpp>
+
+#include "CornerProblem.hpp"
+
+BOOST_AUTO_TEST_CASE( deadline ) {
+    using namespace AIToolbox::MDP;
+
+    // In state 0 the agent can collect a reward of 1, or move to state 1
+    // where it collects a reward of 3 at each timestep. Moving is worth
+    // it only if there is at least another timestep left.
+    AIToolbox::Table3D transitions(boost::extents[2][2][2]);
+    AIToolbox::Table3D rewards(boost::extents[2][2][2]);
+    transitions[0][0][0] = 1.0; rewards[0][0][0] = 1.0;
+    transitions[0][1][1] = 1.0;
+    for ( size_t a = 0; a < 2; ++a ) {
+        transitions[1][a][1] = 1.0;
+        rewards[1][a][1] = 3.0;
+    }
+    Model model(2, 2, transitions, rewards, 1.0);
+
+    FiniteHorizonValueIteration<Model> solver(10);
+    auto solution = solver(model);
+    const auto & policy = std::get<0>(solution);
+
+    BOOST_CHECK_EQUAL( policy.getH(), 10u );
+    BOOST_CHECK_EQUAL( policy.getStoredSteps(), 2u );
+    BOOST_CHECK_EQUAL( policy.getAction(0, 1), 0u );
+    for ( unsigned h = 2; h <= 10; ++h )
+        BOOST_CHECK_EQUAL( policy.getAction(0, h), 1u );
+    BOOST_CHECK_EQUAL( policy.sampleAction(0), 1u );
+    BOOST_CHECK_EQUAL( policy.getActionProbability(0, 0, 1), 1.0 );
+    BOOST_CHECK_EQUAL( policy.getActionProbability(0, 0), 0.0 );
+
+    BOOST_CHECK_EQUAL( std::get<VALUES>(std::get<1>(solution))(0), 27.0 );
+    BOOST_CHECK_EQUAL( std::get<VALUES>(std::get<1>(solution))(1), 30.0 );
+}
+
+BOOST_AUTO_TEST_CASE( matchesValueIteration ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+
+    Model model = makeCornerProblem(grid);
+    SparseModel sparseModel(model);
+
+    const unsigned H = 8;
+    FiniteHorizonValueIteration<Model> solver(H);
+    FiniteHorizonValueIteration<SparseModel> sparseSolver(H);
+
+    auto solution = solver(model);
+    auto sparseSolution = sparseSolver(sparseModel);
+    const auto & policy = std::get<0>(solution);
+
+    // Each horizon has the values and actions that ValueIteration
+    // computes when it is run for that many iterations.
+    for ( unsigned h = 1; h <= H; ++h ) {
+        ValueIteration<Model> vi(h, 0.0);
+        auto vf = std::get<1>(vi(model));
+        const auto & actions = std::get<ACTIONS>(vf);
+        for ( size_t s = 0; s < model.getS(); ++s ) {
+            BOOST_CHECK_EQUAL( policy.getAction(s, h), actions[s] );
+            BOOST_CHECK_EQUAL( std::get<0>(sparseSolution).getAction(s, h), actions[s] );
+        }
+        if ( h == H ) {
+            for ( size_t s = 0; s < model.getS(); ++s ) {
+                BOOST_CHECK_SMALL( std::get<VALUES>(std::get<1>(solution))(s) - std::get<VALUES>(vf)(s), AIToolbox::Scalar(0.000001) );
+                BOOST_CHECK_SMALL( std::get<VALUES>(std::get<1>(sparseSolution))(s) - std::get<VALUES>(vf)(s), AIToolbox::Scalar(0.000001) );
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( streaming ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    Model model = makeCornerProblem(grid);
+    const size_t S = model.getS(), A = model.getA();
+
+    // The policy becomes stationary, so after the first few horizons
+    // nothing else is stored.
+    const unsigned H = 200;
+    FiniteHorizonValueIteration<Model> solver(H);
+    auto policy = std::get<0>(solver(model));
+    BOOST_CHECK( policy.getStoredSteps() < 20u );
+
+    // Writing each horizon as it is computed gives the same file as
+    // writing the whole policy.
+    std::stringstream streamed, written;
+    FiniteHorizonPolicyWriter writer(streamed, H);
+    solver(model, std::ref(writer));
+    written << policy;
+    BOOST_CHECK_EQUAL( streamed.str(), written.str() );
+
+    FiniteHorizonPolicy read(S, A);
+    BOOST_CHECK( streamed >> read );
+    BOOST_CHECK_EQUAL( read.getH(), H );
+    BOOST_CHECK_EQUAL( read.getStoredSteps(), policy.getStoredSteps() );
+    for ( unsigned h = 1; h <= H; ++h )
+        for ( size_t s = 0; s < S; ++s )
+            BOOST_CHECK_EQUAL( read.getAction(s, h), policy.getAction(s, h) );
+
+    // A broken file does not change the policy.
+    std::stringstream broken("2\n1\t0\n");
+    BOOST_CHECK( !(broken >> read) );
+    BOOST_CHECK_EQUAL( read.getH(), H );
+
+    BOOST_CHECK_THROW( read.pushStep(Actions(S + 1)), std::invalid_argument );
+    BOOST_CHECK_THROW( read.pushStep(Actions(S, A)), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( horizonBounds ) {
+    using namespace AIToolbox::MDP;
+
+    const size_t S = 3, A = 4;
+
+    // Without horizons the policy acts randomly.
+    FiniteHorizonPolicy policy(S, A);
+    BOOST_CHECK_EQUAL( policy.getH(), 0u );
+    for ( size_t s = 0; s < S; ++s ) {
+        BOOST_CHECK( policy.sampleAction(s) < A );
+        for ( size_t a = 0; a < A; ++a )
+            BOOST_CHECK_EQUAL( policy.getActionProbability(s, a), 1.0 / A );
+    }
+    BOOST_CHECK_THROW( policy.sampleAction(0, 0), std::invalid_argument );
+    BOOST_CHECK_THROW( policy.sampleAction(0, 1), std::invalid_argument );
+
+    // Explicit horizons must be between 1 and getH().
+    policy.pushStep(Actions{1, 2, 3});
+    BOOST_CHECK_EQUAL( policy.sampleAction(2), 3u );
+    BOOST_CHECK_EQUAL( policy.sampleAction(2, 1), 3u );
+    BOOST_CHECK_EQUAL( policy.getActionProbability(1, 2, 1), 1.0 );
+    BOOST_CHECK_THROW( policy.sampleAction(0, 0), std::invalid_argument );
+    BOOST_CHECK_THROW( policy.sampleAction(0, 2), std::invalid_argument );
+    BOOST_CHECK_THROW( policy.getActionProbability(0, 1, 2), std::invalid_argument );
+    BOOST_CHECK_THROW( policy.getStep(0), std::invalid_argument );
+}
@@ -0,0 +1,105 @@
+#define BOOST_TEST_MODULE MDP_GaussSeidelValueIteration
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/MDP/Algorithms/GaussSeidelValueIteration.hpp>
+#include <AIToolbox/MDP/Algorithms/ValueIteration.hpp>
+#include <AIToolbox/MDP/SparseModel.hpp>
+
+#include "CornerProblem.hpp"
+
+#include <cmath>
+
+BOOST_AUTO_TEST_CASE( agreesWithValueIteration ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+
+    Model model = makeCornerProblem(grid);
+    SparseModel sparseModel(model);
+
+    ValueIteration<Model> vi(1000000, 0.0001);
+    auto vs = vi(model);
+    const auto & vvalues = std::get<VALUES>(std::get<1>(vs));
+
+    for ( auto ordering : { NATURAL, REVERSE, REVERSE_TOPOLOGICAL, RESIDUAL } ) {
+        GaussSeidelValueIteration<Model> dense(1000000, 0.0001, ordering);
+        GaussSeidelValueIteration<SparseModel> sparse(1000000, 0.0001, ordering);
+        BOOST_CHECK_EQUAL( dense.getOrdering(), ordering );
+
+        auto ds = dense(model);
+        auto ss = sparse(sparseModel);
+        BOOST_CHECK( std::get<0>(ds) );
+        BOOST_CHECK( std::get<0>(ss) );
+
+        const auto & dvalues = std::get<VALUES>(std::get<1>(ds));
+        const auto & svalues = std::get<VALUES>(std::get<1>(ss));
+        for ( size_t s = 0; s < model.getS(); ++s ) {
+            BOOST_CHECK_SMALL( dvalues(s) - vvalues(s), AIToolbox::Scalar(0.01) );
+            BOOST_CHECK_SMALL( svalues(s) - vvalues(s), AIToolbox::Scalar(0.01) );
+        }
+    }
+}
+
+// A corridor where the agent can move left or right, and reaching the
+// last state, which is absorbing, gives a reward of 1.
+AIToolbox::MDP::Model makeCorridor(size_t S) {
+    AIToolbox::Table3D transitions(boost::extents[S][2][S]);
+    AIToolbox::Table3D rewards(boost::extents[S][2][S]);
+
+    for ( size_t s = 0; s < S - 1; ++s ) {
+        transitions[s][0][s + 1] = 1.0;
+        transitions[s][1][s > 0 ? s - 1 : s] = 1.0;
+    }
+    rewards[S - 2][0][S - 1] = 1.0;
+    transitions[S - 1][0][S - 1] = 1.0;
+    transitions[S - 1][1][S - 1] = 1.0;
+
+    return AIToolbox::MDP::Model(S, 2, transitions, rewards, 0.9);
+}
+
+BOOST_AUTO_TEST_CASE( fewerSweeps ) {
+    using namespace AIToolbox::MDP;
+
+    auto model = makeCorridor(20);
+    const double epsilon = 0.001;
+
+    // Updating states from the goal backwards converges in a single sweep,
+    // plus one to check convergence.
+    for ( auto ordering : { REVERSE, REVERSE_TOPOLOGICAL } ) {
+        GaussSeidelValueIteration<Model> gs(1000000, epsilon, ordering);
+        auto solution = gs(model);
+        BOOST_CHECK( std::get<0>(solution) );
+        BOOST_CHECK_EQUAL( gs.getSweeps(), 2u );
+
+        const auto & values = std::get<VALUES>(std::get<1>(solution));
+        for ( size_t s = 0; s < model.getS() - 1; ++s )
+            BOOST_CHECK_CLOSE( values(s), std::pow(0.9, model.getS() - 2 - s), 0.0001 );
+    }
+
+    // Plain ValueIteration must not be able to converge in the same number
+    // of sweeps.
+    ValueIteration<Model> vi(2, epsilon);
+    BOOST_CHECK( !std::get<0>(vi(model)) );
+
+    // Going the other way propagates information one state per sweep,
+    // exactly as ValueIteration does.
+    GaussSeidelValueIteration<Model> natural(1000000, epsilon, NATURAL);
+    BOOST_CHECK( std::get<0>(natural(model)) );
+    BOOST_CHECK( natural.getSweeps() > 2u );
+}
+
+BOOST_AUTO_TEST_CASE( parameters ) {
+    using namespace AIToolbox::MDP;
+
+    BOOST_CHECK_THROW( GaussSeidelValueIteration<Model>(10, -1.0), std::invalid_argument );
+
+    GaussSeidelValueIteration<Model> gs(10, 0.0);
+    GridWorld grid(4, 4);
+    auto model = makeCornerProblem(grid);
+
+    // An epsilon of zero forces all sweeps.
+    gs(model);
+    BOOST_CHECK_EQUAL( gs.getSweeps(), 10u );
+}
@@ -0,0 +1,100 @@
+#define BOOST_TEST_MODULE MDP_IncrementalValueIteration
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/MDP/Algorithms/IncrementalValueIteration.hpp>
+#include <AIToolbox/MDP/Algorithms/ValueIteration.hpp>
+#include <AIToolbox/MDP/Experience.hpp>
+#include <AIToolbox/MDP/RLModel.hpp>
+
+// A corridor where the agent can move right or left, and reaching the
+// last state, which is absorbing, gives a reward of 1.
+void recordCorridor(AIToolbox::MDP::Experience & exp) {
+    const size_t S = exp.getS();
+    for ( size_t s = 0; s < S - 1; ++s ) {
+        exp.record(s, 0, s + 1, s + 1 == S - 1 ? 1.0 : 0.0);
+        exp.record(s, 1, s > 0 ? s - 1 : s, 0.0);
+    }
+    exp.record(S - 1, 0, S - 1, 0.0);
+    exp.record(S - 1, 1, S - 1, 0.0);
+}
+
+void checkAgainstValueIteration(const AIToolbox::MDP::RLModel & model, const AIToolbox::MDP::ValueFunction & v) {
+    using namespace AIToolbox::MDP;
+
+    ValueIteration<RLModel> vi(1000000, 0.000001);
+    auto solution = vi(model);
+    const auto & values = std::get<VALUES>(std::get<1>(solution));
+    const auto & actions = std::get<ACTIONS>(std::get<1>(solution));
+    for ( size_t s = 0; s < model.getS(); ++s ) {
+        BOOST_CHECK_SMALL( std::get<VALUES>(v)(s) - values(s), AIToolbox::Scalar(0.001) );
+        BOOST_CHECK_EQUAL( std::get<ACTIONS>(v)[s], actions[s] );
+    }
+}
+
+size_t updateCorridor(size_t S) {
+    using namespace AIToolbox::MDP;
+
+    const size_t k = S - 20;
+    Experience exp(S, 2);
+    recordCorridor(exp);
+    RLModel model(exp, 0.9, true);
+
+    ValueIteration<RLModel> vi(1000000, 0.000001);
+    auto solution = vi(model);
+    IncrementalValueIteration<RLModel> solver(model, 0.000001, std::get<1>(solution));
+
+    // Going left from state k now mostly leads to the goal. The change
+    // fades with the distance from k.
+    for ( unsigned i = 0; i < 9; ++i )
+        exp.record(k, 1, S - 1, 1.0);
+    model.sync(k, 1);
+
+    BOOST_CHECK( solver({{k, 1}}) );
+    BOOST_CHECK_EQUAL( solver.getQueueLength(), 0u );
+    BOOST_CHECK_EQUAL( std::get<ACTIONS>(solver.getValueFunction())[k], 1u );
+    checkAgainstValueIteration(model, solver.getValueFunction());
+    const size_t backups = solver.getBackups();
+
+    // Staying in the goal now gives a reward, which changes all values,
+    // including the one of state k through its new transition.
+    for ( unsigned i = 0; i < 10; ++i )
+        exp.record(S - 1, 0, S - 1, 0.1);
+    model.sync(S - 1, 0);
+
+    BOOST_CHECK( solver({{S - 1, 0}}) );
+    checkAgainstValueIteration(model, solver.getValueFunction());
+
+    return backups;
+}
+
+BOOST_AUTO_TEST_CASE( propagatesLocalChanges ) {
+    // The work done depends on the change, not on the size of the model.
+    const size_t small = updateCorridor(500), large = updateCorridor(2000);
+    BOOST_CHECK_EQUAL( small, large );
+    BOOST_CHECK( small < 500 * 5 );
+}
+
+BOOST_AUTO_TEST_CASE( maxBackups ) {
+    using namespace AIToolbox::MDP;
+
+    const size_t S = 20;
+    Experience exp(S, 2);
+    recordCorridor(exp);
+    RLModel model(exp, 0.9, true);
+
+    // Starting from zero, the goal reward needs to travel the whole corridor.
+    IncrementalValueIteration<RLModel> solver(model, 0.000001);
+    solver.setMaxBackups(5);
+    BOOST_CHECK( !solver({{S - 2, 0}}) );
+    BOOST_CHECK( solver.getQueueLength() > 0 );
+    BOOST_CHECK( solver.getBackups() < S );
+
+    solver.setMaxBackups(0);
+    BOOST_CHECK( solver({}) );
+    checkAgainstValueIteration(model, solver.getValueFunction());
+
+    BOOST_CHECK_THROW( solver.setEpsilon(0.0), std::invalid_argument );
+    BOOST_CHECK_THROW( solver({{S, 0}}), std::invalid_argument );
+}
@@ -5,8 +5,10 @@
 
 #include <AIToolbox/MDP/Algorithms/MCTS.hpp>
 #include <AIToolbox/MDP/Model.hpp>
+#include <AIToolbox/Impl/Seeder.hpp>
 
 #include "CornerProblem.hpp"
+#include "CliffProblem.hpp"
 
 BOOST_AUTO_TEST_CASE( escapeToCorners ) {
     using namespace AIToolbox::MDP;
@@ -75,6 +77,78 @@ BOOST_AUTO_TEST_CASE( escapeToCorners ) {
     BOOST_CHECK_EQUAL( solver.sampleAction(14,10), RIGHT);
 }
 
+BOOST_AUTO_TEST_CASE( batchedRollouts ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4,4);
+
+    auto model = makeCornerProblem(grid);
+    model.setAliasSampling(true);
+
+    MCTS<decltype(model)> solver(model, 2000, 5.0);
+    BOOST_CHECK_EQUAL( solver.getRolloutParticles(), 1u );
+
+    solver.setRolloutParticles(8);
+    BOOST_CHECK_EQUAL( solver.getRolloutParticles(), 8u );
+    BOOST_CHECK_THROW( solver.setRolloutParticles(0), std::invalid_argument );
+
+    // Averaging over more particles makes leaf estimates more accurate,
+    // so fewer iterations are needed to find the same actions.
+    BOOST_CHECK_EQUAL( solver.sampleAction(1,10), LEFT);
+    BOOST_CHECK_EQUAL( solver.sampleAction(2,10), LEFT);
+    BOOST_CHECK_EQUAL( solver.sampleAction(4,10), UP);
+    BOOST_CHECK_EQUAL( solver.sampleAction(8,10), UP);
+    BOOST_CHECK_EQUAL( solver.sampleAction(7, 10), DOWN);
+    BOOST_CHECK_EQUAL( solver.sampleAction(11,10), DOWN);
+    BOOST_CHECK_EQUAL( solver.sampleAction(13,10), RIGHT);
+    BOOST_CHECK_EQUAL( solver.sampleAction(14,10), RIGHT);
+}
+
+// Exposes only the single-sample interface of the wrapped model.
+template <typename M>
+class ScalarOnly {
+    public:
+        ScalarOnly(const M & m) : m_(m) {}
+
+        size_t getS() const { return m_.getS(); }
+        size_t getA() const { return m_.getA(); }
+        double getDiscount() const { return m_.getDiscount(); }
+        bool isTerminal(size_t s) const { return m_.isTerminal(s); }
+        std::tuple<size_t, double> sampleSR(size_t s, size_t a) const { return m_.sampleSR(s, a); }
+        template <typename G>
+        std::tuple<size_t, double> sampleSR(size_t s, size_t a, G & g) const { return m_.sampleSR(s, a, g); }
+
+    private:
+        const M & m_;
+};
+
+BOOST_AUTO_TEST_CASE( singleParticleRollouts ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4,4);
+
+    auto model = makeCornerProblem(grid);
+    model.setAliasSampling(true);
+    const ScalarOnly<decltype(model)> scalar(model);
+
+    static_assert(is_generative_model_batch<decltype(model)>::value, "Model should support batch sampling");
+    static_assert(!is_generative_model_batch<decltype(scalar)>::value, "ScalarOnly should not support batch sampling");
+
+    // With a single particle, the rollouts of a model which supports
+    // batch sampling are exactly the ones of a model which does not.
+    AIToolbox::Impl::Seeder::setRootSeed(3);
+    MCTS<decltype(model)> batched(model, 2000, 5.0);
+    AIToolbox::Impl::Seeder::setRootSeed(3);
+    MCTS<decltype(scalar)> plain(scalar, 2000, 5.0);
+
+    BOOST_CHECK_EQUAL( batched.sampleAction(7, 10), plain.sampleAction(7, 10) );
+    for ( size_t a = 0; a < model.getA(); ++a ) {
+        BOOST_CHECK_EQUAL( batched.getGraph().getAction(0, a).N, plain.getGraph().getAction(0, a).N );
+        BOOST_CHECK_EQUAL( batched.getGraph().getAction(0, a).V, plain.getGraph().getAction(0, a).V );
+    }
+    BOOST_CHECK_EQUAL( batched.getGraph().size(), plain.getGraph().size() );
+}
+
 BOOST_AUTO_TEST_CASE( sampleOneTime ) {
     using namespace AIToolbox::MDP;
 
@@ -96,9 +170,108 @@ BOOST_AUTO_TEST_CASE( sampleOneTime ) {
 
     auto & graph_ = solver.getGraph();
     // We find the leaf we just produced
-    auto it = graph_.children[0].children.begin();
-    auto s1 = it->first;
+    size_t s1 = 0;
+    graph_.forEachChild(0, 0, [&s1](size_t s, size_t){ s1 = s; });
 
     // We make a,o the new head
     solver.sampleAction( 0, s1, horizon - 1);
 }
+
+BOOST_AUTO_TEST_CASE( multipleThreads ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4,4);
+
+    auto model = makeCornerProblem(grid);
+
+    MCTS<decltype(model)> solver(model, 10000, 5.0);
+    BOOST_CHECK_EQUAL( solver.getThreads(), 1u );
+    BOOST_CHECK_THROW( solver.setThreads(0), std::invalid_argument );
+    BOOST_CHECK_THROW( solver.setVirtualLoss(-1.0), std::invalid_argument );
+
+    solver.setThreads(4);
+    BOOST_CHECK_EQUAL( solver.getThreads(), 4u );
+
+    BOOST_CHECK_EQUAL( solver.sampleAction(1,10), LEFT);
+    BOOST_CHECK_EQUAL( solver.sampleAction(2,10), LEFT);
+    BOOST_CHECK_EQUAL( solver.sampleAction(4,10), UP);
+    BOOST_CHECK_EQUAL( solver.sampleAction(8,10), UP);
+    BOOST_CHECK_EQUAL( solver.sampleAction(7, 10), DOWN);
+    BOOST_CHECK_EQUAL( solver.sampleAction(11,10), DOWN);
+    BOOST_CHECK_EQUAL( solver.sampleAction(13,10), RIGHT);
+    BOOST_CHECK_EQUAL( solver.sampleAction(14,10), RIGHT);
+
+    // All simulations are accounted for in the tree, also when it is
+    // reused.
+    const auto & graph = solver.getGraph();
+    BOOST_CHECK_EQUAL( graph.getRoot().N, 10000u );
+
+    unsigned visits = 0;
+    for ( size_t a = 0; a < model.getA(); ++a )
+        visits += graph.getAction(0, a).N;
+    BOOST_CHECK_EQUAL( visits, 10000u );
+
+    size_t s1 = 0;
+    graph.forEachChild(0, RIGHT, [&s1](size_t s, size_t){ s1 = s; });
+    const unsigned kept = graph.getNode(graph.getChild(0, RIGHT, s1)).N;
+    solver.sampleAction(RIGHT, s1, 9);
+    BOOST_CHECK_EQUAL( solver.getGraph().getRoot().N, kept + 10000u );
+}
+
+// Throws when sampled from a specific state.
+template <typename M>
+class ThrowingModel {
+    public:
+        ThrowingModel(const M & m, size_t s) : m_(m), s_(s) {}
+
+        size_t getS() const { return m_.getS(); }
+        size_t getA() const { return m_.getA(); }
+        double getDiscount() const { return m_.getDiscount(); }
+        bool isTerminal(size_t s) const { return m_.isTerminal(s); }
+        std::tuple<size_t, double> sampleSR(size_t s, size_t a) const { check(s); return m_.sampleSR(s, a); }
+        template <typename G>
+        std::tuple<size_t, double> sampleSR(size_t s, size_t a, G & g) const { check(s); return m_.sampleSR(s, a, g); }
+
+    private:
+        void check(size_t s) const { if ( s == s_ ) throw std::runtime_error("Sampled the forbidden state"); }
+
+        const M & m_;
+        size_t s_;
+};
+
+BOOST_AUTO_TEST_CASE( multipleThreadsException ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4,4);
+
+    auto model = makeCornerProblem(grid);
+    const ThrowingModel<decltype(model)> throwing(model, 5);
+
+    // An exception in any of the threads reaches the caller.
+    MCTS<decltype(throwing)> solver(throwing, 1000, 5.0);
+    solver.setThreads(4);
+    BOOST_CHECK_THROW( solver.sampleAction(5, 10), std::runtime_error );
+    BOOST_CHECK_THROW( solver.sampleAction(1, 10), std::runtime_error );
+}
+
+BOOST_AUTO_TEST_CASE( singleThreadDeterminism ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(12, 3);
+
+    auto model = makeCliffProblem(grid);
+    const size_t start = model.getS() - 2;
+
+    // With the same seed, a single thread always builds the same tree.
+    AIToolbox::Impl::Seeder::setRootSeed(7);
+    MCTS<decltype(model)> first(model, 2000, 50.0);
+    AIToolbox::Impl::Seeder::setRootSeed(7);
+    MCTS<decltype(model)> second(model, 2000, 50.0);
+
+    BOOST_CHECK_EQUAL( first.sampleAction(start, 15), second.sampleAction(start, 15) );
+    for ( size_t a = 0; a < model.getA(); ++a ) {
+        BOOST_CHECK_EQUAL( first.getGraph().getAction(0, a).N, second.getGraph().getAction(0, a).N );
+        BOOST_CHECK_EQUAL( first.getGraph().getAction(0, a).V, second.getGraph().getAction(0, a).V );
+    }
+    BOOST_CHECK_EQUAL( first.getGraph().size(), second.getGraph().size() );
+}
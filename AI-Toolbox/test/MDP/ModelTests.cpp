@@ -5,6 +5,8 @@
 
 #include <AIToolbox/MDP/IO.hpp>
 #include <AIToolbox/MDP/Model.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
+#include <AIToolbox/MDP/Algorithms/ValueIteration.hpp>
 
 #include "CornerProblem.hpp"
 
@@ -50,6 +52,161 @@ BOOST_AUTO_TEST_CASE( copy_construction ) {
     }
 }
 
+BOOST_AUTO_TEST_CASE( alias_sampling ) {
+    using namespace AIToolbox::MDP;
+    const size_t S = 4, A = 2;
+
+    AIToolbox::Table3D transitions(boost::extents[S][A][S]);
+    AIToolbox::Table3D rewards(boost::extents[S][A][S]);
+
+    for ( size_t s = 0; s < S; ++s ) {
+        transitions[s][0][s] = 1.0;
+        transitions[s][1][0] = 0.1;
+        transitions[s][1][1] = 0.2;
+        transitions[s][1][3] = 0.7;
+    }
+
+    Model m(S, A, transitions, rewards);
+    BOOST_CHECK( !m.getAliasSampling() );
+
+    m.setAliasSampling(true);
+    BOOST_CHECK( m.getAliasSampling() );
+
+    const unsigned trials = 100000;
+    std::vector<unsigned> counts(S, 0);
+    for ( unsigned i = 0; i < trials; ++i ) {
+        BOOST_CHECK_EQUAL( std::get<0>(m.sampleSR(2, 0)), 2u );
+        ++counts[std::get<0>(m.sampleSR(2, 1))];
+    }
+
+    BOOST_CHECK_EQUAL( counts[2], 0u );
+    BOOST_CHECK_CLOSE( counts[0] / double(trials), 0.1, 5.0 );
+    BOOST_CHECK_CLOSE( counts[1] / double(trials), 0.2, 5.0 );
+    BOOST_CHECK_CLOSE( counts[3] / double(trials), 0.7, 5.0 );
+
+    // Tables must follow changes in the transition function.
+    for ( size_t s = 0; s < S; ++s ) {
+        transitions[s][1][0] = 0.0;
+        transitions[s][1][1] = 0.0;
+        transitions[s][1][3] = 0.0;
+        transitions[s][1][2] = 1.0;
+    }
+    m.setTransitionFunction(transitions);
+    for ( unsigned i = 0; i < 1000; ++i )
+        BOOST_CHECK_EQUAL( std::get<0>(m.sampleSR(0, 1)), 2u );
+}
+
+BOOST_AUTO_TEST_CASE( compact_rewards ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    Model model = makeCornerProblem(grid);
+    const size_t S = model.getS(), A = model.getA();
+
+    ValueIteration<Model> solver(1000000, 0.001);
+    const auto full = std::get<1>(solver(model));
+    const AIToolbox::Matrix2D ir = computeImmediateRewards(model);
+
+    BOOST_CHECK( !model.getCompactRewards() );
+    BOOST_CHECK( model.getExpectedRewardFunction().isApprox(ir) );
+
+    model.setCompactRewards(true);
+    BOOST_CHECK( model.getCompactRewards() );
+    BOOST_CHECK_EQUAL( model.getRewardFunction(0).size(), 0 );
+    BOOST_CHECK( computeImmediateRewards(model).isApprox(ir) );
+    for ( size_t s = 0; s < S; ++s )
+        for ( size_t a = 0; a < A; ++a ) {
+            BOOST_CHECK_EQUAL( model.getExpectedReward(s, a, 0), ir(s, a) );
+            BOOST_CHECK_EQUAL( computeImmediateReward(model, s, a), ir(s, a) );
+        }
+
+    const auto compact = std::get<1>(solver(model));
+    for ( size_t s = 0; s < S; ++s ) {
+        BOOST_CHECK_SMALL( std::get<VALUES>(full)(s) - std::get<VALUES>(compact)(s), AIToolbox::Scalar(0.000001) );
+        BOOST_CHECK_EQUAL( std::get<ACTIONS>(full)[s], std::get<ACTIONS>(compact)[s] );
+    }
+
+    // Copies of a compact model stay compact.
+    Model copy(model);
+    BOOST_CHECK( copy.getCompactRewards() );
+    BOOST_CHECK( copy.getExpectedRewardFunction() == model.getExpectedRewardFunction() );
+
+    // Expanding the rewards gives R(s,a) to all transitions.
+    model.setCompactRewards(false);
+    BOOST_CHECK( !model.getCompactRewards() );
+    BOOST_CHECK( computeImmediateRewards(model).isApprox(ir) );
+    for ( size_t s1 = 0; s1 < S; ++s1 )
+        BOOST_CHECK_EQUAL( model.getExpectedReward(3, 1, s1), ir(3, 1) );
+
+    BOOST_CHECK_THROW( model.setExpectedRewardFunction(AIToolbox::Matrix2D(S, A + 1)), std::invalid_argument );
+
+    AIToolbox::Table2D r(boost::extents[S][A]);
+    r[2][1] = 5.0;
+    model.setExpectedRewardFunction(r);
+    BOOST_CHECK( model.getCompactRewards() );
+    BOOST_CHECK_EQUAL( std::get<1>(model.sampleSR(2, 1)), 5.0 );
+    BOOST_CHECK_EQUAL( std::get<1>(model.sampleSR(2, 0)), 0.0 );
+}
+
+BOOST_AUTO_TEST_CASE( engine_sampling ) {
+    using namespace AIToolbox;
+
+    static_assert(MDP::is_generative_model_engine<MDP::Model>::value, "Model should support external generators");
+
+    GridWorld grid(4, 4);
+    auto model = makeCornerProblem(grid);
+
+    // The same generator state must produce the same samples, no matter
+    // how the internal generator of the model is used in between.
+    RandomEngine e1(12345), e2(12345);
+    for ( size_t i = 0; i < 1000; ++i ) {
+        const size_t s = i % model.getS(), a = i % model.getA();
+        auto r1 = model.sampleSR(s, a, e1);
+        model.sampleSR(s, a);
+        auto r2 = MDP::sampleSR(model, s, a, e2);
+        BOOST_CHECK( r1 == r2 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( batch_sampling ) {
+    using namespace AIToolbox;
+
+    static_assert(MDP::is_generative_model_batch<MDP::Model>::value, "Model should support batch sampling");
+
+    GridWorld grid(4, 4);
+    auto model = makeCornerProblem(grid);
+    const size_t n = 1000;
+
+    std::vector<size_t> states(n), actions(n);
+    for ( size_t i = 0; i < n; ++i ) {
+        states[i] = i % model.getS();
+        actions[i] = i % model.getA();
+    }
+
+    for ( bool alias : { false, true } ) {
+        model.setAliasSampling(alias);
+
+        RandomEngine e1(12345), e2(12345);
+        std::vector<size_t> next; std::vector<double> rewards;
+        MDP::sampleSRBatch(model, states, actions, next, rewards, e1);
+        BOOST_CHECK_EQUAL( next.size(), n );
+        BOOST_CHECK_EQUAL( rewards.size(), n );
+
+        for ( size_t i = 0; i < n; ++i ) {
+            BOOST_CHECK( model.getTransitionProbability(states[i], actions[i], next[i]) > 0.0 );
+            BOOST_CHECK_EQUAL( rewards[i], model.getExpectedReward(states[i], actions[i], next[i]) );
+            // Without alias tables, batches are the same as separate samples.
+            if ( !alias ) BOOST_CHECK( std::make_tuple(next[i], rewards[i]) == model.sampleSR(states[i], actions[i], e2) );
+        }
+
+        // Particles can be advanced in place, reproducibly.
+        RandomEngine e3(12345);
+        auto particles = states;
+        model.sampleSRBatch(particles, actions, particles, rewards, e3);
+        BOOST_CHECK( particles == next );
+    }
+}
+
 int generator() {
     static int counter = 0;
     return ++counter;
@@ -0,0 +1,148 @@
+#define BOOST_TEST_MODULE MDP_ParallelPrioritizedSweeping
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/MDP/Algorithms/ParallelPrioritizedSweeping.hpp>
+#include <AIToolbox/MDP/Algorithms/ValueIteration.hpp>
+#include <AIToolbox/MDP/Experience.hpp>
+#include <AIToolbox/MDP/RLModel.hpp>
+
+#include <random>
+
+#include "CornerProblem.hpp"
+
+BOOST_AUTO_TEST_CASE( planning ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    auto model = makeCornerProblem(grid);
+    const size_t S = model.getS(), A = model.getA();
+
+    ValueIteration<decltype(model)> vi(1000000, 0.0000001);
+    const auto solution = std::get<1>(vi(model));
+
+    for ( unsigned threads : { 1, 4 } ) {
+        ParallelPrioritizedSweeping<decltype(model)> solver(model, 0.0, 1000, threads);
+        BOOST_CHECK_EQUAL( solver.getThreads(), threads );
+
+        for ( unsigned i = 0; i < 500; ++i ) {
+            for ( size_t s = 0; s < S; ++s )
+                for ( size_t a = 0; a < A; ++a )
+                    solver.stepUpdateQ(s, a);
+            solver.batchUpdateQ();
+        }
+
+        const auto & values = std::get<VALUES>(solver.getValueFunction());
+        for ( size_t s = 0; s < S; ++s ) {
+            BOOST_CHECK_SMALL( values(s) - std::get<VALUES>(solution)(s), AIToolbox::Scalar(0.0001) );
+            BOOST_CHECK_EQUAL( std::get<ACTIONS>(solver.getValueFunction())[s], std::get<ACTIONS>(solution)[s] );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( set_qfunction ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    auto model = makeCornerProblem(grid);
+    const size_t S = model.getS(), A = model.getA();
+
+    ValueIteration<decltype(model)> vi(1000000, 0.0000001);
+    const auto result = vi(model);
+    const auto & solution = std::get<1>(result);
+
+    ParallelPrioritizedSweeping<decltype(model)> solver(model, 0.0, 1000, 2);
+    solver.setQFunction(std::get<2>(result));
+
+    // The values follow the new QFunction.
+    const auto & values = std::get<VALUES>(solver.getValueFunction());
+    for ( size_t s = 0; s < S; ++s ) {
+        BOOST_CHECK_SMALL( values(s) - std::get<VALUES>(solution)(s), AIToolbox::Scalar(0.0001) );
+        BOOST_CHECK_EQUAL( std::get<ACTIONS>(solver.getValueFunction())[s], std::get<ACTIONS>(solution)[s] );
+    }
+
+    // Updates start from the new values, so they stay at the solution.
+    for ( size_t s = 0; s < S; ++s )
+        for ( size_t a = 0; a < A; ++a )
+            solver.stepUpdateQ(s, a);
+
+    for ( size_t s = 0; s < S; ++s )
+        BOOST_CHECK_SMALL( values(s) - std::get<VALUES>(solution)(s), AIToolbox::Scalar(0.0001) );
+}
+
+BOOST_AUTO_TEST_CASE( singleThreadDeterminism ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    auto model = makeCornerProblem(grid);
+    const size_t S = model.getS(), A = model.getA();
+
+    // With the same seed and a single thread, the queue pops the states in
+    // the same order, so partial updates give the same QFunction.
+    AIToolbox::Impl::Seeder::setRootSeed(7);
+    ParallelPrioritizedSweeping<decltype(model)> first(model, 0.0, 10, 1);
+    AIToolbox::Impl::Seeder::setRootSeed(7);
+    ParallelPrioritizedSweeping<decltype(model)> second(model, 0.0, 10, 1);
+
+    for ( unsigned i = 0; i < 5; ++i ) {
+        for ( size_t s = 0; s < S; ++s ) {
+            for ( size_t a = 0; a < A; ++a ) {
+                first.stepUpdateQ(s, a);
+                second.stepUpdateQ(s, a);
+            }
+        }
+        first.batchUpdateQ();
+        second.batchUpdateQ();
+        BOOST_CHECK( first.getQFunction() == second.getQFunction() );
+        BOOST_CHECK_EQUAL( first.getQueueLength(), second.getQueueLength() );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( learning ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    auto world = makeCornerProblem(grid);
+    const size_t S = world.getS(), A = world.getA();
+
+    Experience exp(S, A);
+    RLModel model(exp, world.getDiscount(), false);
+    ParallelPrioritizedSweeping<RLModel> solver(model, 0.0, 100, 3);
+
+    std::mt19937 rand(1);
+    std::uniform_int_distribution<size_t> state(0, S - 1), action(0, A - 1);
+    for ( unsigned i = 0; i < 5000; ++i ) {
+        const size_t s = state(rand), a = action(rand);
+        size_t s1; double r;
+        std::tie(s1, r) = world.sampleSR(s, a);
+        exp.record(s, a, s1, r);
+        model.sync(s, a, s1);
+        solver.stepUpdateQ(s, a);
+        solver.batchUpdateQ();
+    }
+    // A few more sweeps so that the values settle.
+    for ( unsigned i = 0; i < 500; ++i ) {
+        for ( size_t s = 0; s < S; ++s )
+            for ( size_t a = 0; a < A; ++a )
+                solver.stepUpdateQ(s, a);
+        solver.batchUpdateQ();
+    }
+
+    ValueIteration<RLModel> vi(1000000, 0.0000001);
+    const auto solution = std::get<1>(vi(model));
+
+    const auto & values = std::get<VALUES>(solver.getValueFunction());
+    for ( size_t s = 0; s < S; ++s )
+        BOOST_CHECK_SMALL( values(s) - std::get<VALUES>(solution)(s), AIToolbox::Scalar(0.0001) );
+
+    // Changing the number of threads keeps the queued states.
+    solver.stepUpdateQ(0, 0);
+    const auto length = solver.getQueueLength();
+    solver.setThreads(5);
+    BOOST_CHECK_EQUAL( solver.getThreads(), 5u );
+    BOOST_CHECK_EQUAL( solver.getQueueLength(), length );
+    solver.batchUpdateQ();
+
+    BOOST_CHECK_THROW( solver.setThreads(0), std::invalid_argument );
+}
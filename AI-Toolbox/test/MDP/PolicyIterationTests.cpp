@@ -0,0 +1,206 @@
+#define BOOST_TEST_MODULE MDP_PolicyIteration
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/MDP/Algorithms/PolicyIteration.hpp>
+#include <AIToolbox/MDP/Algorithms/ValueIteration.hpp>
+#include <AIToolbox/MDP/SparseModel.hpp>
+#include <AIToolbox/MDP/Experience.hpp>
+#include <AIToolbox/MDP/RLModel.hpp>
+
+#include "CornerProblem.hpp"
+#include "CliffProblem.hpp"
+
+BOOST_AUTO_TEST_CASE( agreesWithValueIteration ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+
+    Model model = makeCornerProblem(grid);
+    SparseModel sparseModel(model);
+
+    ValueIteration<Model> vi(1000000, 0.00001);
+    auto vs = vi(model);
+    const auto & vvalues = std::get<VALUES>(std::get<1>(vs));
+
+    for ( unsigned k : { 0u, 1u, 5u } ) {
+        PolicyIteration<Model> dense(1000000, 0.00001, k);
+        PolicyIteration<SparseModel> sparse(1000000, 0.00001, k);
+        BOOST_CHECK_EQUAL( dense.getEvaluationSweeps(), k );
+
+        auto ds = dense(model);
+        auto ss = sparse(sparseModel);
+        BOOST_CHECK( std::get<0>(ds) );
+        BOOST_CHECK( std::get<0>(ss) );
+
+        const auto & dvalues = std::get<VALUES>(std::get<1>(ds));
+        const auto & svalues = std::get<VALUES>(std::get<1>(ss));
+        for ( size_t s = 0; s < model.getS(); ++s ) {
+            BOOST_CHECK_SMALL( dvalues(s) - vvalues(s), AIToolbox::Scalar(0.001) );
+            BOOST_CHECK_SMALL( svalues(s) - vvalues(s), AIToolbox::Scalar(0.001) );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( highDiscount ) {
+    using namespace AIToolbox::MDP;
+
+    // A corridor where the agent can move right or left, and reaching the
+    // last state, which is absorbing, gives a reward of 1. The model is
+    // learned from experience, so that we solve an RLModel.
+    const size_t S = 40;
+    const double discount = 0.995;
+    Experience exp(S, 2);
+    for ( size_t s = 0; s < S - 1; ++s ) {
+        exp.record(s, 0, s + 1, s + 1 == S - 1 ? 1.0 : 0.0);
+        exp.record(s, 1, s > 0 ? s - 1 : s, 0.0);
+    }
+    exp.record(S - 1, 0, S - 1, 0.0);
+    exp.record(S - 1, 1, S - 1, 0.0);
+    RLModel model(exp, discount, true);
+
+    PolicyIteration<RLModel> solver(1000000, 0.0);
+    auto solution = solver(model);
+    BOOST_CHECK( std::get<0>(solution) );
+
+    // Exact evaluation finds the optimal policy, and its exact values.
+    const auto & values = std::get<VALUES>(std::get<1>(solution));
+    const auto & actions = std::get<ACTIONS>(std::get<1>(solution));
+    for ( size_t s = 0; s < S - 1; ++s ) {
+        BOOST_CHECK_EQUAL( actions[s], 0u );
+#ifdef AI_TOOLBOX_FLOAT
+        // The float discount is not exactly 0.995, and the error grows
+        // along the corridor.
+        BOOST_CHECK_CLOSE( values(s), std::pow(discount, S - 2 - s), 0.001 );
+#else
+        BOOST_CHECK_CLOSE( values(s), std::pow(discount, S - 2 - s), 0.0001 );
+#endif
+    }
+
+    // ValueIteration needs at least a sweep per state to get there. Here
+    // the first greedy policy already leads every state to the goal (ties
+    // pick the first action), so a single exact evaluation is enough.
+    BOOST_CHECK( solver.getIterations() <= 3 );
+    ValueIteration<RLModel> vi(S - 2, 0.001);
+    BOOST_CHECK( !std::get<0>(vi(model)) );
+}
+
+BOOST_AUTO_TEST_CASE( failedEvaluation ) {
+    using namespace AIToolbox::MDP;
+
+    // In state 0, action 0 loops forever with a reward of -1, while action
+    // 1 pays -5 to reach an absorbing state. With a discount of 1 the
+    // system of the looping policy is singular, so its exact evaluation
+    // fails, and the solver must not stop on that policy.
+    AIToolbox::Table3D transitions(boost::extents[2][2][2]);
+    AIToolbox::Table3D rewards(boost::extents[2][2][2]);
+    transitions[0][0][0] = 1.0;
+    transitions[0][1][1] = 1.0;
+    transitions[1][0][1] = 1.0;
+    transitions[1][1][1] = 1.0;
+    rewards[0][0][0] = -1.0;
+    rewards[0][1][1] = -5.0;
+
+    Model model(2, 2, transitions, rewards, 1.0);
+
+    PolicyIteration<Model> solver(1000, 0.001, 0);
+    auto solution = solver(model);
+    BOOST_CHECK( std::get<0>(solution) );
+
+    const auto & values = std::get<VALUES>(std::get<1>(solution));
+    const auto & actions = std::get<ACTIONS>(std::get<1>(solution));
+    BOOST_CHECK_EQUAL( actions[0], 1u );
+    BOOST_CHECK_SMALL( values(0) + AIToolbox::Scalar(5.0), AIToolbox::Scalar(0.001) );
+    BOOST_CHECK_SMALL( values(1), AIToolbox::Scalar(0.001) );
+}
+
+BOOST_AUTO_TEST_CASE( parameters ) {
+    using namespace AIToolbox::MDP;
+
+    BOOST_CHECK_THROW( PolicyIteration<Model>(10, -1.0), std::invalid_argument );
+
+    GridWorld grid(4, 4);
+    auto model = makeCornerProblem(grid);
+
+    // An epsilon of zero forces all improvement steps with approximate
+    // evaluation.
+    PolicyIteration<Model> solver(10, 0.0, 3);
+    BOOST_CHECK( !std::get<0>(solver(model)) );
+    BOOST_CHECK_EQUAL( solver.getIterations(), 10u );
+}
+
+BOOST_AUTO_TEST_CASE( matchesDoubleBuild ) {
+    using namespace AIToolbox::MDP;
+
+    // Values computed by ValueIteration in the default double build, and
+    // the actions where the best one is unique, as PolicyIteration may
+    // break ties differently. A float build (AI_TOOLBOX_FLOAT) must find
+    // the same policy, and values within float precision.
+    const AIToolbox::Scalar cornerValues[] = {
+         0.0,          -0.9756097561, -1.832242712, -2.584408224,
+        -0.9756097561, -1.832242712,  -2.584408224, -1.832242712,
+        -1.832242712,  -2.584408224,  -1.832242712, -0.9756097561,
+        -2.584408224,  -1.832242712,  -0.9756097561, 0.0,
+    };
+    const size_t cornerActions[] = {
+        0, 3, 3, 2,
+        0, 0, 0, 2,
+        0, 0, 1, 2,
+        0, 1, 1, 0,
+    };
+    const bool cornerUnique[] = {
+        false, true,  true,  false,
+        true,  false, false, true,
+        true,  false, false, true,
+        false, true,  true,  false,
+    };
+    // The last two are the start and the goal.
+    const AIToolbox::Scalar cliffValues[] = {
+        -13, -12, -11, -10, -9, -8, -7, -6, -5, -4, -3, -2,
+        -12, -11, -10,  -9, -8, -7, -6, -5, -4, -3, -2, -1,
+        -11, -10,  -9,  -8, -7, -6, -5, -4, -3, -2, -1,  0,
+        -12, 0,
+    };
+    const size_t cliffActions[] = {
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2,
+        0, 0,
+    };
+    const bool cliffUnique[] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 0,
+    };
+
+    GridWorld cornerGrid(4, 4);
+    auto corner = makeCornerProblem(cornerGrid);
+    corner.setDiscount(0.9);
+
+    PolicyIteration<Model> pi(1000000, 0.0000001, 0);
+    const auto cs = std::get<1>(pi(corner));
+    for ( size_t s = 0; s < corner.getS(); ++s ) {
+        BOOST_CHECK_SMALL( std::get<VALUES>(cs)(s) - cornerValues[s], AIToolbox::Scalar(0.0001) );
+        if ( cornerUnique[s] )
+            BOOST_CHECK_EQUAL( std::get<ACTIONS>(cs)[s], cornerActions[s] );
+    }
+
+    // The cliff problem is undiscounted with an absorbing goal, so the
+    // exact evaluations fail and the solver stops on the epsilon
+    // criterion instead. We use a larger epsilon, as in a float build
+    // epsilons below the float tolerance are treated as zero.
+    GridWorld cliffGrid(12, 3);
+    const auto cliff = makeCliffProblem(cliffGrid);
+
+    pi.setEpsilon(0.00001);
+    const auto solution = pi(cliff);
+    BOOST_CHECK( std::get<0>(solution) );
+    const auto & ks = std::get<1>(solution);
+    for ( size_t s = 0; s < cliff.getS(); ++s ) {
+        BOOST_CHECK_SMALL( std::get<VALUES>(ks)(s) - cliffValues[s], AIToolbox::Scalar(0.0001) );
+        if ( cliffUnique[s] )
+            BOOST_CHECK_EQUAL( std::get<ACTIONS>(ks)[s], cliffActions[s] );
+    }
+}
@@ -0,0 +1,162 @@
+#define BOOST_TEST_MODULE MDP_PrioritizedSweeping
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/MDP/Algorithms/PrioritizedSweeping.hpp>
+#include <AIToolbox/MDP/Algorithms/ValueIteration.hpp>
+#include <AIToolbox/MDP/Algorithms/Utils/TransitionIndex.hpp>
+#include <AIToolbox/MDP/Experience.hpp>
+#include <AIToolbox/MDP/RLModel.hpp>
+#include <AIToolbox/MDP/SparseModel.hpp>
+
+#include <algorithm>
+#include <random>
+#include <set>
+
+#include "CornerProblem.hpp"
+
+using Pairs = std::set<std::pair<size_t, size_t>>;
+
+// Transitions which become impossible are not removed from the index, so
+// learned models are only checked for missing transitions.
+template <typename M>
+void checkIndex(const AIToolbox::MDP::TransitionIndex & index, const M & model, bool exact = true) {
+    const size_t S = model.getS(), A = model.getA();
+    std::vector<Pairs> predecessors(S);
+
+    for ( size_t s = 0; s < S; ++s ) {
+        for ( size_t a = 0; a < A; ++a ) {
+            std::set<size_t> successors;
+            index.forEachSuccessor(s, a, [&](size_t s1) {
+                BOOST_CHECK( successors.insert(s1).second );
+            });
+            for ( size_t s1 = 0; s1 < S; ++s1 ) {
+                const bool possible = model.getTransitionProbability(s, a, s1) != 0.0;
+                if ( exact || possible )
+                    BOOST_CHECK_EQUAL( successors.count(s1), possible );
+                if ( possible ) predecessors[s1].emplace(s, a);
+            }
+        }
+    }
+    for ( size_t s1 = 0; s1 < S; ++s1 ) {
+        Pairs found;
+        index.forEachPredecessor(s1, [&](size_t s, size_t a) {
+            BOOST_CHECK( found.emplace(s, a).second );
+        });
+        if ( exact )
+            BOOST_CHECK( found == predecessors[s1] );
+        else
+            BOOST_CHECK( std::includes(std::begin(found), std::end(found), std::begin(predecessors[s1]), std::end(predecessors[s1])) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( transition_index ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    auto model = makeCornerProblem(grid);
+    SparseModel sparse(model);
+
+    TransitionIndex dense(model);
+    checkIndex(dense, model);
+    checkIndex(TransitionIndex(sparse), sparse);
+
+    // Nothing changed, so nothing is added.
+    BOOST_CHECK_EQUAL( dense.updatePair(model, 3, 1), 0u );
+}
+
+BOOST_AUTO_TEST_CASE( incremental_index ) {
+    using namespace AIToolbox::MDP;
+    const size_t S = 30, A = 3;
+
+    Experience exp(S, A);
+    RLModel model(exp, 0.9, false);
+    TransitionIndex index(model);
+    const size_t initial = index.getTransitions();
+
+    // Enough new transitions are added to trigger several compactions.
+    std::mt19937 rand(42);
+    std::uniform_int_distribution<size_t> state(0, S - 1), action(0, A - 1);
+    for ( unsigned i = 0; i < 2000; ++i ) {
+        const size_t s = state(rand), a = action(rand), s1 = state(rand);
+        exp.record(s, a, s1, 1.0);
+        model.sync(s, a, s1);
+        index.updatePair(model, s, a);
+    }
+    BOOST_CHECK( index.getTransitions() > 2 * initial );
+    checkIndex(index, model, false);
+}
+
+BOOST_AUTO_TEST_CASE( planning ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    auto model = makeCornerProblem(grid);
+    const size_t S = model.getS(), A = model.getA();
+
+    ValueIteration<decltype(model)> vi(1000000, 0.0000001);
+    const auto solution = std::get<1>(vi(model));
+
+    PrioritizedSweeping<decltype(model)> solver(model, 0.0, 1000);
+    for ( unsigned i = 0; i < 500; ++i ) {
+        for ( size_t s = 0; s < S; ++s )
+            for ( size_t a = 0; a < A; ++a )
+                solver.stepUpdateQ(s, a);
+        solver.batchUpdateQ();
+    }
+
+    const auto & values = std::get<VALUES>(solver.getValueFunction());
+    for ( size_t s = 0; s < S; ++s ) {
+        BOOST_CHECK_SMALL( values(s) - std::get<VALUES>(solution)(s), AIToolbox::Scalar(0.0001) );
+        BOOST_CHECK_EQUAL( std::get<ACTIONS>(solver.getValueFunction())[s], std::get<ACTIONS>(solution)[s] );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( learning ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    auto world = makeCornerProblem(grid);
+    const size_t S = world.getS(), A = world.getA();
+
+    Experience exp(S, A);
+    RLModel model(exp, world.getDiscount(), false);
+    PrioritizedSweeping<RLModel> solver(model, 0.0, 100);
+
+    // Transitions are discovered while learning, and the index must
+    // follow them.
+    std::mt19937 rand(1);
+    std::uniform_int_distribution<size_t> state(0, S - 1), action(0, A - 1);
+    for ( unsigned i = 0; i < 20000; ++i ) {
+        const size_t s = state(rand), a = action(rand);
+        size_t s1; double r;
+        std::tie(s1, r) = world.sampleSR(s, a);
+        exp.record(s, a, s1, r);
+        model.sync(s, a, s1);
+        solver.stepUpdateQ(s, a);
+        solver.batchUpdateQ();
+    }
+    // A few more sweeps so that the values settle.
+    for ( unsigned i = 0; i < 500; ++i ) {
+        for ( size_t s = 0; s < S; ++s )
+            for ( size_t a = 0; a < A; ++a )
+                solver.stepUpdateQ(s, a);
+        solver.batchUpdateQ();
+    }
+
+    ValueIteration<RLModel> vi(1000000, 0.0000001);
+    const auto solution = std::get<1>(vi(model));
+
+    const auto & values = std::get<VALUES>(solver.getValueFunction());
+    for ( size_t s = 0; s < S; ++s )
+        BOOST_CHECK_SMALL( values(s) - std::get<VALUES>(solution)(s), AIToolbox::Scalar(0.0001) );
+
+    // Rebuilding the index does not change anything.
+    solver.rebuildIndex();
+    const auto before = solver.getQFunction();
+    for ( size_t s = 0; s < S; ++s )
+        for ( size_t a = 0; a < A; ++a )
+            solver.stepUpdateQ(s, a);
+    BOOST_CHECK( solver.getQFunction().isApprox(before, 0.001) );
+}
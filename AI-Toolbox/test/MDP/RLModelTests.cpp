@@ -43,8 +43,8 @@ BOOST_AUTO_TEST_CASE( syncing ) {
         BOOST_CHECK_EQUAL( model.getExpectedReward(0,0,1), 0.0 );
 
         model.sync(0,0);
-        BOOST_CHECK_EQUAL( model.getTransitionProbability(0,0,1), 1.0/3.0 );
-        BOOST_CHECK_EQUAL( model.getTransitionProbability(0,0,2), 1.0/3.0 );
+        BOOST_CHECK_EQUAL( model.getTransitionProbability(0,0,1), AIToolbox::Scalar(1.0/3.0) );
+        BOOST_CHECK_EQUAL( model.getTransitionProbability(0,0,2), AIToolbox::Scalar(1.0/3.0) );
         BOOST_CHECK_EQUAL( model.getTransitionProbability(0,0,4), 0.0 );
 
         BOOST_CHECK_EQUAL( model.getExpectedReward(0,0,1), 10.0 );
@@ -67,8 +67,8 @@ BOOST_AUTO_TEST_CASE( syncing ) {
 
         AIToolbox::MDP::RLModel model2(exp, 1.0, true);
 
-        BOOST_CHECK_EQUAL( model.getTransitionProbability (0,0,1), 1.0/3.0 );
-        BOOST_CHECK_EQUAL( model2.getTransitionProbability(0,0,1), 1.0/3.0 );
+        BOOST_CHECK_EQUAL( model.getTransitionProbability (0,0,1), AIToolbox::Scalar(1.0/3.0) );
+        BOOST_CHECK_EQUAL( model2.getTransitionProbability(0,0,1), AIToolbox::Scalar(1.0/3.0) );
 
         BOOST_CHECK_EQUAL( model.getTransitionProbability (4,0,5), 1.0 );
         BOOST_CHECK_EQUAL( model2.getTransitionProbability(4,0,5), 1.0 );
@@ -115,6 +115,37 @@ BOOST_AUTO_TEST_CASE( sampling ) {
     BOOST_CHECK_MESSAGE( k > 2000 && k < 4000, "This test may fail from time to time as it is based on sampling. k should be ~3333. k is " << k ); // Hopefully
 }
 
+BOOST_AUTO_TEST_CASE( incremental_sampling ) {
+    const size_t S = 100, A = 2;
+
+    AIToolbox::MDP::Experience exp(S,A);
+    AIToolbox::MDP::RLModel model(exp, 1.0, false);
+
+    static_assert(AIToolbox::MDP::is_generative_model_engine<AIToolbox::MDP::RLModel>::value, "RLModel should support external generators");
+
+    // Never synced pairs are self-absorbing
+    for ( int i = 0; i < 100; ++i )
+        BOOST_CHECK_EQUAL( std::get<0>(model.sampleSR(7,1)), 7u );
+
+    // Spread visits over the whole row, one transition at a time, like
+    // an agent would do while acting.
+    for ( size_t i = 0; i < 5000; ++i ) {
+        size_t s1 = (i * 37) % S;
+        if ( i % 2 ) s1 = 42;
+        exp.record(3,0,s1,1.0);
+        model.sync(3,0,s1);
+    }
+
+    unsigned k = 0;
+    for ( int i = 0; i < 10000; ++i ) {
+        size_t s1 = std::get<0>(model.sampleSR(3,0));
+        BOOST_CHECK( exp.getVisits(3,0,s1) > 0 );
+        if ( s1 == 42 ) ++k;
+    }
+    const double p = model.getTransitionProbability(3,0,42);
+    BOOST_CHECK_MESSAGE( k > (p - 0.05) * 10000 && k < (p + 0.05) * 10000, "This test may fail from time to time as it is based on sampling. k should be ~" << p * 10000 << ". k is " << k ); // Hopefully
+}
+
 /*
 BOOST_AUTO_TEST_CASE( IO ) {
     const int S = 10, A = 8;
@@ -5,6 +5,8 @@
 
 #include <AIToolbox/MDP/IO.hpp>
 #include <AIToolbox/MDP/SparseModel.hpp>
+#include <AIToolbox/MDP/Model.hpp>
+#include <AIToolbox/MDP/Utils.hpp>
 
 #include "CornerProblem.hpp"
 
@@ -50,6 +52,164 @@ BOOST_AUTO_TEST_CASE( copy_construction ) {
     }
 }
 
+// A model which only offers access to single elements, so that it
+// can only be copied one element at a time.
+class ElementModel {
+    public:
+        ElementModel(const AIToolbox::MDP::Model & m) : m_(m) {}
+
+        size_t getS() const { return m_.getS(); }
+        size_t getA() const { return m_.getA(); }
+        double getDiscount() const { return m_.getDiscount(); }
+        std::tuple<size_t, double> sampleSR(size_t s, size_t a) const { return m_.sampleSR(s, a); }
+        bool isTerminal(size_t s) const { return m_.isTerminal(s); }
+        double getTransitionProbability(size_t s, size_t a, size_t s1) const { return m_.getTransitionProbability(s, a, s1); }
+        double getExpectedReward(size_t s, size_t a, size_t s1) const { return m_.getExpectedReward(s, a, s1); }
+
+    private:
+        const AIToolbox::MDP::Model & m_;
+};
+
+// A model which exposes its matrices without validating them.
+class MatrixModel : public ElementModel {
+    public:
+        MatrixModel(const AIToolbox::MDP::Model & m) : ElementModel(m), t_(m.getTransitionFunction()), r_(m.getRewardFunction()) {}
+
+        double getTransitionProbability(size_t s, size_t a, size_t s1) const { return t_[a](s, s1); }
+        double getExpectedReward(size_t s, size_t a, size_t s1) const { return r_[a](s, s1); }
+        const AIToolbox::Matrix2D & getTransitionFunction(size_t a) const { return t_[a]; }
+        const AIToolbox::Matrix2D & getRewardFunction(size_t a) const { return r_[a]; }
+
+        AIToolbox::Matrix3D t_, r_;
+};
+
+BOOST_AUTO_TEST_CASE( bulk_copy_construction ) {
+    using namespace AIToolbox::MDP;
+
+    static_assert(is_model_eigen<SparseModel>::value, "SparseModel should expose its matrices");
+    static_assert(!is_model_eigen<ElementModel>::value, "ElementModel should not expose its matrices");
+    static_assert(is_model_eigen<MatrixModel>::value, "MatrixModel should expose its matrices");
+
+    GridWorld grid(4, 4);
+
+    auto model = makeCornerProblem(grid);
+    size_t S = model.getS(), A = model.getA();
+
+    // Copying whole matrices gives the same result as copying single elements.
+    SparseModel bulk(model);
+    SparseModel element{ElementModel(model)};
+    Model dense(bulk);
+
+    for ( size_t a = 0; a < A; ++a ) {
+        BOOST_CHECK_EQUAL(bulk.getTransitionFunction(a).nonZeros(), element.getTransitionFunction(a).nonZeros());
+        BOOST_CHECK_EQUAL(bulk.getRewardFunction(a).nonZeros(), element.getRewardFunction(a).nonZeros());
+        for ( size_t s = 0; s < S; ++s ) {
+            for ( size_t s1 = 0; s1 < S; ++s1 ) {
+                BOOST_CHECK_EQUAL(bulk.getTransitionProbability(s, a, s1), element.getTransitionProbability(s, a, s1));
+                BOOST_CHECK_EQUAL(bulk.getExpectedReward(s, a, s1), element.getExpectedReward(s, a, s1));
+                BOOST_CHECK_EQUAL(dense.getTransitionProbability(s, a, s1), model.getTransitionProbability(s, a, s1));
+                BOOST_CHECK_EQUAL(dense.getExpectedReward(s, a, s1), model.getExpectedReward(s, a, s1));
+            }
+        }
+    }
+
+    // Invalid matrices are still rejected.
+    MatrixModel broken(model);
+    broken.t_[1](5, 6) += 0.5;
+    BOOST_CHECK_THROW(SparseModel{broken}, std::invalid_argument);
+    BOOST_CHECK_THROW(Model{broken}, std::invalid_argument);
+
+    broken.t_[1](5, 6) = -0.5;
+    broken.t_[1](5, 5) += 1.0;
+    BOOST_CHECK_THROW(SparseModel{broken}, std::invalid_argument);
+    BOOST_CHECK_THROW(Model{broken}, std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE( compact_rewards ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+    const Model dense = makeCornerProblem(grid);
+    SparseModel model(dense);
+    const size_t S = model.getS(), A = model.getA();
+
+    const AIToolbox::Matrix2D ir = computeImmediateRewards(dense);
+    BOOST_CHECK( model.getExpectedRewardFunction().isApprox(ir) );
+
+    model.setCompactRewards(true);
+    BOOST_CHECK( model.getCompactRewards() );
+    BOOST_CHECK_EQUAL( model.getRewardFunction(0).nonZeros(), 0 );
+    for ( size_t s = 0; s < S; ++s )
+        for ( size_t a = 0; a < A; ++a )
+            BOOST_CHECK_EQUAL( model.getExpectedReward(s, a, 0), ir(s, a) );
+
+    // Compact rewards survive conversions in both directions.
+    Model compactDense(model);
+    SparseModel compactSparse(compactDense);
+    BOOST_CHECK( compactDense.getCompactRewards() );
+    BOOST_CHECK( compactSparse.getCompactRewards() );
+    BOOST_CHECK( compactSparse.getExpectedRewardFunction().isApprox(ir) );
+
+    // Expanding only fills the rewards of possible transitions.
+    model.setCompactRewards(false);
+    BOOST_CHECK( computeImmediateRewards(model).isApprox(ir) );
+    for ( size_t a = 0; a < A; ++a )
+        BOOST_CHECK( model.getRewardFunction(a).nonZeros() <= model.getTransitionFunction(a).nonZeros() );
+}
+
+BOOST_AUTO_TEST_CASE( alias_sampling ) {
+    using namespace AIToolbox::MDP;
+    const size_t S = 4, A = 2;
+
+    AIToolbox::Table3D transitions(boost::extents[S][A][S]);
+    AIToolbox::Table3D rewards(boost::extents[S][A][S]);
+
+    for ( size_t s = 0; s < S; ++s ) {
+        transitions[s][0][s] = 1.0;
+        transitions[s][1][0] = 0.1;
+        transitions[s][1][1] = 0.2;
+        transitions[s][1][3] = 0.7;
+    }
+
+    SparseModel m(S, A, transitions, rewards);
+    BOOST_CHECK( !m.getAliasSampling() );
+    static_assert(is_generative_model_engine<SparseModel>::value, "SparseModel should support external generators");
+
+    m.setAliasSampling(true);
+    BOOST_CHECK( m.getAliasSampling() );
+
+    const unsigned trials = 100000;
+    std::vector<unsigned> counts(S, 0);
+    for ( unsigned i = 0; i < trials; ++i ) {
+        BOOST_CHECK_EQUAL( std::get<0>(m.sampleSR(2, 0)), 2u );
+        ++counts[std::get<0>(m.sampleSR(2, 1))];
+    }
+
+    BOOST_CHECK_EQUAL( counts[2], 0u );
+    BOOST_CHECK_CLOSE( counts[0] / double(trials), 0.1, 5.0 );
+    BOOST_CHECK_CLOSE( counts[1] / double(trials), 0.2, 5.0 );
+    BOOST_CHECK_CLOSE( counts[3] / double(trials), 0.7, 5.0 );
+
+    // Tables must follow changes in the transition function.
+    for ( size_t s = 0; s < S; ++s ) {
+        transitions[s][1][0] = 0.0;
+        transitions[s][1][1] = 0.6;
+        transitions[s][1][2] = 0.4;
+        transitions[s][1][3] = 0.0;
+    }
+    m.setTransitionFunction(transitions);
+    BOOST_CHECK( m.getAliasSampling() );
+
+    std::fill(std::begin(counts), std::end(counts), 0);
+    for ( unsigned i = 0; i < trials; ++i )
+        ++counts[std::get<0>(m.sampleSR(2, 1))];
+
+    BOOST_CHECK_EQUAL( counts[0], 0u );
+    BOOST_CHECK_EQUAL( counts[3], 0u );
+    BOOST_CHECK_CLOSE( counts[1] / double(trials), 0.6, 5.0 );
+    BOOST_CHECK_CLOSE( counts[2] / double(trials), 0.4, 5.0 );
+}
+
 int generator() {
     static int counter = 0;
     return ++counter;
@@ -0,0 +1,193 @@
+#define BOOST_TEST_MODULE MDP_TensorModel
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/MDP/TensorModel.hpp>
+#include <AIToolbox/MDP/Model.hpp>
+#include <AIToolbox/MDP/SparseModel.hpp>
+#include <AIToolbox/MDP/Algorithms/ValueIteration.hpp>
+#include <AIToolbox/MDP/Algorithms/GaussSeidelValueIteration.hpp>
+
+#include "CornerProblem.hpp"
+
+BOOST_AUTO_TEST_CASE( construction ) {
+    using namespace AIToolbox::MDP;
+    const size_t S = 5, A = 6;
+
+    for ( auto layout : {STATE_MAJOR, ACTION_MAJOR} ) {
+        TensorModel m(S, A, 1.0, layout);
+
+        BOOST_CHECK_EQUAL( m.getS(), S );
+        BOOST_CHECK_EQUAL( m.getA(), A );
+        BOOST_CHECK_EQUAL( m.getLayout(), layout );
+
+        for ( size_t s = 0; s < S; ++s ) {
+            BOOST_CHECK( m.isTerminal(s) );
+            for ( size_t a = 0; a < A; ++a )
+                for ( size_t s1 = 0; s1 < S; ++s1 ) {
+                    BOOST_CHECK_EQUAL( m.getTransitionProbability(s, a, s1), s == s1 );
+                    BOOST_CHECK_EQUAL( m.getExpectedReward(s, a, s1), 0.0 );
+                }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( copy_construction ) {
+    using namespace AIToolbox::MDP;
+
+    static_assert(is_model_eigen<TensorModel>::value, "TensorModel should expose its matrices");
+
+    GridWorld grid(4, 4);
+
+    auto model = makeCornerProblem(grid);
+    const SparseModel sparse(model);
+    size_t S = model.getS(), A = model.getA();
+
+    for ( auto layout : {STATE_MAJOR, ACTION_MAJOR} ) {
+        TensorModel dense(model, layout);
+        TensorModel fromSparse(sparse, layout);
+
+        BOOST_CHECK_EQUAL( model.getDiscount(), dense.getDiscount() );
+        for ( size_t s = 0; s < S; ++s ) {
+            const auto t = dense.getStateTransitions(s);
+            const auto r = dense.getStateRewards(s);
+            for ( size_t a = 0; a < A; ++a ) {
+                for ( size_t s1 = 0; s1 < S; ++s1 ) {
+                    BOOST_CHECK_EQUAL( model.getTransitionProbability(s, a, s1), dense.getTransitionProbability(s, a, s1) );
+                    BOOST_CHECK_EQUAL( model.getExpectedReward(s, a, s1), dense.getExpectedReward(s, a, s1) );
+                    BOOST_CHECK_EQUAL( model.getTransitionProbability(s, a, s1), fromSparse.getTransitionProbability(s, a, s1) );
+                    BOOST_CHECK_EQUAL( model.getTransitionProbability(s, a, s1), t(a, s1) );
+                    BOOST_CHECK_EQUAL( model.getExpectedReward(s, a, s1), r(a, s1) );
+                }
+            }
+        }
+        for ( size_t a = 0; a < A; ++a ) {
+            BOOST_CHECK( dense.getTransitionFunction(a) == model.getTransitionFunction(a) );
+            BOOST_CHECK( dense.getRewardFunction(a) == model.getRewardFunction(a) );
+        }
+
+        // Copies must not point to the buffers of the original.
+        TensorModel copy(dense);
+        {
+            TensorModel other(S, A, 1.0, layout);
+            other = dense;
+            BOOST_CHECK( other.getTransitionFunction(1) == model.getTransitionFunction(1) );
+        }
+        dense = TensorModel(S, A, 1.0, layout);
+        BOOST_CHECK( copy.getTransitionFunction(1) == model.getTransitionFunction(1) );
+        BOOST_CHECK( dense.getTransitionFunction(1) == AIToolbox::Matrix2D::Identity(S, S) );
+    }
+
+    // Invalid transitions are rejected.
+    AIToolbox::Table3D transitions(boost::extents[S][A][S]);
+    AIToolbox::Table3D rewards(boost::extents[S][A][S]);
+    BOOST_CHECK_THROW( TensorModel(S, A, transitions, rewards), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( compact_rewards_copy ) {
+    using namespace AIToolbox::MDP;
+
+    // Models with compact rewards only have R(s,a), which is copied for
+    // every s'.
+    {
+        Model small(3, 2, 0.9);
+        small.setCompactRewards(true);
+        TensorModel t(small);
+        BOOST_CHECK_EQUAL( t.getExpectedReward(1, 1, 2), 0.0 );
+    }
+
+    GridWorld grid(4, 4);
+
+    auto model = makeCornerProblem(grid);
+    model.setCompactRewards(true);
+    SparseModel sparse(makeCornerProblem(grid));
+    sparse.setCompactRewards(true);
+    const size_t S = model.getS(), A = model.getA();
+
+    for ( auto layout : {STATE_MAJOR, ACTION_MAJOR} ) {
+        TensorModel dense(model, layout);
+        TensorModel fromSparse(sparse, layout);
+
+        for ( size_t s = 0; s < S; ++s ) {
+            for ( size_t a = 0; a < A; ++a ) {
+                const auto r = model.getExpectedRewardFunction()(s, a);
+                for ( size_t s1 = 0; s1 < S; ++s1 ) {
+                    BOOST_CHECK_EQUAL( dense.getTransitionProbability(s, a, s1), model.getTransitionProbability(s, a, s1) );
+                    BOOST_CHECK_EQUAL( dense.getExpectedReward(s, a, s1), r );
+                    BOOST_CHECK_EQUAL( fromSparse.getExpectedReward(s, a, s1), r );
+                }
+            }
+        }
+
+        // Since transitions sum to one, the immediate rewards are the same.
+        const auto ir = computeImmediateRewards(dense);
+        for ( size_t s = 0; s < S; ++s )
+            for ( size_t a = 0; a < A; ++a )
+                BOOST_CHECK_SMALL( ir(s, a) - model.getExpectedRewardFunction()(s, a), AIToolbox::Scalar(0.000001) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( solving ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+
+    auto model = makeCornerProblem(grid);
+    size_t S = model.getS();
+
+    ValueIteration<Model> vi(1000000, 0.001);
+    const auto solution = std::get<1>(vi(model));
+
+    for ( auto layout : {STATE_MAJOR, ACTION_MAJOR} ) {
+        TensorModel tensor(model, layout);
+
+        ValueIteration<TensorModel> tvi(1000000, 0.001);
+        GaussSeidelValueIteration<TensorModel> gs(1000000, 0.001);
+        const auto tsolution = std::get<1>(tvi(tensor));
+        const auto gsolution = std::get<1>(gs(tensor));
+
+        for ( size_t s = 0; s < S; ++s ) {
+            BOOST_CHECK_SMALL( std::get<VALUES>(solution)(s) - std::get<VALUES>(tsolution)(s), AIToolbox::Scalar(0.000001) );
+            BOOST_CHECK_SMALL( std::get<VALUES>(solution)(s) - std::get<VALUES>(gsolution)(s), AIToolbox::Scalar(0.01) );
+            BOOST_CHECK_EQUAL( std::get<ACTIONS>(solution)[s], std::get<ACTIONS>(tsolution)[s] );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( sampling ) {
+    using namespace AIToolbox::MDP;
+    const size_t S = 4, A = 2;
+
+    AIToolbox::Table3D transitions(boost::extents[S][A][S]);
+    AIToolbox::Table3D rewards(boost::extents[S][A][S]);
+
+    for ( size_t s = 0; s < S; ++s ) {
+        transitions[s][0][s] = 1.0;
+        transitions[s][1][0] = 0.1;
+        transitions[s][1][1] = 0.2;
+        transitions[s][1][3] = 0.7;
+        rewards[s][1][3] = 5.0;
+    }
+
+    for ( auto layout : {STATE_MAJOR, ACTION_MAJOR} ) {
+        TensorModel m(S, A, transitions, rewards, 1.0, layout);
+
+        const unsigned trials = 100000;
+        std::vector<unsigned> counts(S, 0);
+        for ( unsigned i = 0; i < trials; ++i ) {
+            BOOST_CHECK_EQUAL( std::get<0>(m.sampleSR(2, 0)), 2u );
+            size_t s1; double r;
+            std::tie(s1, r) = m.sampleSR(2, 1);
+            BOOST_CHECK_EQUAL( r, s1 == 3 ? 5.0 : 0.0 );
+            ++counts[s1];
+        }
+
+        BOOST_CHECK_EQUAL( counts[2], 0u );
+        BOOST_CHECK_CLOSE( counts[0] / double(trials), 0.1, 5.0 );
+        BOOST_CHECK_CLOSE( counts[1] / double(trials), 0.2, 5.0 );
+        BOOST_CHECK_CLOSE( counts[3] / double(trials), 0.7, 5.0 );
+
+        BOOST_CHECK( !m.isTerminal(0) );
+    }
+}
@@ -0,0 +1,92 @@
+#define BOOST_TEST_MODULE MDP_TopologicalValueIteration
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/MDP/Algorithms/TopologicalValueIteration.hpp>
+#include <AIToolbox/MDP/Algorithms/ValueIteration.hpp>
+#include <AIToolbox/MDP/SparseModel.hpp>
+
+#include "CornerProblem.hpp"
+
+BOOST_AUTO_TEST_CASE( agreesWithValueIteration ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+
+    Model model = makeCornerProblem(grid);
+    SparseModel sparseModel(model);
+
+    ValueIteration<Model> vi(1000000, 0.0001);
+    TopologicalValueIteration<Model> dense(1000000, 0.0001);
+    TopologicalValueIteration<SparseModel> sparse(1000000, 0.0001);
+
+    auto vs = vi(model);
+    auto ds = dense(model);
+    auto ss = sparse(sparseModel);
+    BOOST_CHECK( std::get<0>(ds) );
+    BOOST_CHECK( std::get<0>(ss) );
+
+    const auto & vvalues = std::get<VALUES>(std::get<1>(vs));
+    const auto & dvalues = std::get<VALUES>(std::get<1>(ds));
+    const auto & svalues = std::get<VALUES>(std::get<1>(ss));
+    for ( size_t s = 0; s < model.getS(); ++s ) {
+        BOOST_CHECK_SMALL( dvalues(s) - vvalues(s), AIToolbox::Scalar(0.01) );
+        BOOST_CHECK_SMALL( svalues(s) - vvalues(s), AIToolbox::Scalar(0.01) );
+    }
+    BOOST_CHECK_EQUAL( dense.getBackups(), sparse.getBackups() );
+}
+
+BOOST_AUTO_TEST_CASE( pipeline ) {
+    using namespace AIToolbox::MDP;
+
+    // A pipeline of stages, where the agent can either advance by one
+    // stage and get a reward of 1, or skip one stage and get nothing. The
+    // last stage is absorbing.
+    const size_t S = 30;
+    AIToolbox::Table3D transitions(boost::extents[S][2][S]);
+    AIToolbox::Table3D rewards(boost::extents[S][2][S]);
+    for ( size_t s = 0; s < S - 1; ++s ) {
+        transitions[s][0][s + 1] = 1.0;
+        rewards[s][0][s + 1] = 1.0;
+        transitions[s][1][std::min(s + 2, S - 1)] = 1.0;
+    }
+    transitions[S - 1][0][S - 1] = 1.0;
+    transitions[S - 1][1][S - 1] = 1.0;
+    Model model(S, 2, transitions, rewards, 0.9);
+
+    TopologicalValueIteration<Model> solver(1000000, 0.0001);
+    auto solution = solver(model);
+    BOOST_CHECK( std::get<0>(solution) );
+
+    // The graph is acyclic, so every state is backed up exactly once.
+    BOOST_CHECK_EQUAL( solver.getBackups(), S );
+
+    // Always advancing one stage at a time is optimal.
+    const auto & values = std::get<VALUES>(std::get<1>(solution));
+    const auto & actions = std::get<ACTIONS>(std::get<1>(solution));
+    double expected = 0.0;
+    for ( size_t s = S - 1; s > 0; --s ) {
+        BOOST_CHECK_CLOSE( values(s - 1), 1.0 + 0.9 * expected, 0.0001 );
+        BOOST_CHECK_EQUAL( actions[s - 1], 0u );
+        expected = 1.0 + 0.9 * expected;
+    }
+
+    // ValueIteration needs to sweep all states once per stage.
+    ValueIteration<Model> vi(S - 2, 0.0001);
+    BOOST_CHECK( !std::get<0>(vi(model)) );
+}
+
+BOOST_AUTO_TEST_CASE( parameters ) {
+    using namespace AIToolbox::MDP;
+
+    BOOST_CHECK_THROW( TopologicalValueIteration<Model>(10, -1.0), std::invalid_argument );
+
+    TopologicalValueIteration<Model> solver(10, 0.0);
+    GridWorld grid(4, 4);
+    auto model = makeCornerProblem(grid);
+
+    // An epsilon of zero forces all sweeps, but the bound is respected.
+    solver(model);
+    BOOST_CHECK( solver.getBackups() <= 10 * model.getS() );
+}
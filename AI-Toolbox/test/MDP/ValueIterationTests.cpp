@@ -10,6 +10,7 @@
 #include <AIToolbox/MDP/IO.hpp>
 
 #include "CornerProblem.hpp"
+#include "CliffProblem.hpp"
 
 BOOST_AUTO_TEST_CASE( escapeToCorners ) {
     using namespace AIToolbox::MDP;
@@ -106,3 +107,189 @@ BOOST_AUTO_TEST_CASE( escapeToCorners ) {
         BOOST_CHECK_EQUAL( qfun.row(s).maxCoeff(), values[s] );
     }
 }
+
+BOOST_AUTO_TEST_CASE( implementationsAgree ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+
+    Model model = makeCornerProblem(grid);
+    SparseModel sparseModel(model);
+
+    ValueIterationGeneral<Model> general(1000000, 0.001);
+    ValueIteration<Model> dense(1000000, 0.001);
+    ValueIteration<SparseModel> sparse(1000000, 0.001);
+
+    auto gs = general(model);
+    auto ds = dense(model);
+    auto ss = sparse(sparseModel);
+
+    // The Eigen versions must do exactly the same work as the general one,
+    // only with matrix-vector products.
+    auto & gq = std::get<2>(gs);
+    auto & dq = std::get<2>(ds);
+    auto & sq = std::get<2>(ss);
+    for ( size_t s = 0; s < model.getS(); ++s ) {
+        for ( size_t a = 0; a < model.getA(); ++a ) {
+            BOOST_CHECK_CLOSE( gq(s, a), dq(s, a), 0.0001 );
+            BOOST_CHECK_CLOSE( gq(s, a), sq(s, a), 0.0001 );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( threadsAgree ) {
+    using namespace AIToolbox::MDP;
+
+    GridWorld grid(4, 4);
+
+    Model model = makeCornerProblem(grid);
+    SparseModel sparseModel(model);
+
+    ValueIteration<Model> dense(1000000, 0.001);
+    ValueIteration<SparseModel> sparse(1000000, 0.001);
+    BOOST_CHECK_EQUAL( dense.getThreads(), 1u );
+    BOOST_CHECK_THROW( dense.setThreads(0), std::invalid_argument );
+
+    auto d1 = dense(model);
+    auto s1 = sparse(sparseModel);
+
+    // More threads than states must also work.
+    for ( unsigned threads : { 2u, 3u, 7u, 64u } ) {
+        dense.setThreads(threads);
+        sparse.setThreads(threads);
+        BOOST_CHECK_EQUAL( dense.getThreads(), threads );
+
+        auto dn = dense(model);
+        auto sn = sparse(sparseModel);
+
+        // Each value is computed by exactly the same operations no matter
+        // the number of threads, so results must be identical.
+        BOOST_CHECK_EQUAL( std::get<0>(d1), std::get<0>(dn) );
+        BOOST_CHECK( std::get<1>(d1) == std::get<1>(dn) );
+        BOOST_CHECK( std::get<2>(d1) == std::get<2>(dn) );
+        BOOST_CHECK( std::get<1>(s1) == std::get<1>(sn) );
+        BOOST_CHECK( std::get<2>(s1) == std::get<2>(sn) );
+    }
+
+    // An empty model has no states to split between threads.
+    Model empty(0, 2);
+    auto e = dense(empty);
+    BOOST_CHECK( std::get<0>(e) );
+    BOOST_CHECK_EQUAL( std::get<VALUES>(std::get<1>(e)).size(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( actionElimination ) {
+    using namespace AIToolbox::MDP;
+
+    // A ring where each action jumps a different number of states ahead,
+    // with rewards that are all different.
+    const size_t S = 30, A = 12;
+    AIToolbox::Table3D transitions(boost::extents[S][A][S]);
+    AIToolbox::Table3D rewards(boost::extents[S][A][S]);
+    for ( size_t s = 0; s < S; ++s ) {
+        for ( size_t a = 0; a < A; ++a ) {
+            const size_t s1 = (s + a) % S;
+            transitions[s][a][s1] = 1.0;
+            rewards[s][a][s1] = static_cast<double>((s * 7 + a * 13) % 17) / 17.0;
+        }
+    }
+    Model model(S, A, transitions, rewards, 0.9);
+    SparseModel sparseModel(model);
+
+    ValueIteration<Model> vi(1000000, 0.00001);
+    ValueIteration<Model> dense(1000000, 0.00001);
+    ValueIteration<SparseModel> sparse(1000000, 0.00001);
+    BOOST_CHECK( !dense.getActionElimination() );
+    dense.setActionElimination(true);
+    sparse.setActionElimination(true);
+    BOOST_CHECK( dense.getActionElimination() );
+
+    auto vs = vi(model);
+    auto ds = dense(model);
+    auto ss = sparse(sparseModel);
+    BOOST_CHECK( std::get<0>(ds) );
+    BOOST_CHECK( std::get<0>(ss) );
+    BOOST_CHECK_EQUAL( vi.getEliminatedActions(), 0u );
+
+    // Most actions are eliminated, but never the best one of each state.
+    BOOST_CHECK( dense.getEliminatedActions() > S * A / 2 );
+    BOOST_CHECK( dense.getEliminatedActions() <= S * (A - 1) );
+    BOOST_CHECK_EQUAL( dense.getEliminatedActions(), sparse.getEliminatedActions() );
+
+    const auto & vvalues = std::get<VALUES>(std::get<1>(vs));
+    const auto & dvalues = std::get<VALUES>(std::get<1>(ds));
+    const auto & svalues = std::get<VALUES>(std::get<1>(ss));
+    for ( size_t s = 0; s < S; ++s ) {
+        BOOST_CHECK_SMALL( dvalues(s) - vvalues(s), AIToolbox::Scalar(0.001) );
+        BOOST_CHECK_SMALL( svalues(s) - vvalues(s), AIToolbox::Scalar(0.001) );
+        BOOST_CHECK_EQUAL( std::get<ACTIONS>(std::get<1>(ds))[s], std::get<ACTIONS>(std::get<1>(vs))[s] );
+        // Eliminated pairs are still returned in the QFunction.
+        for ( size_t a = 0; a < A; ++a )
+            BOOST_CHECK_SMALL( std::get<2>(ds)(s, a) - std::get<2>(vs)(s, a), AIToolbox::Scalar(0.001) );
+    }
+
+    // Elimination is done independently on each block of states.
+    dense.setThreads(4);
+    auto dn = dense(model);
+    BOOST_CHECK( std::get<1>(ds) == std::get<1>(dn) );
+    BOOST_CHECK( std::get<2>(ds) == std::get<2>(dn) );
+}
+
+BOOST_AUTO_TEST_CASE( matchesDoubleBuild ) {
+    using namespace AIToolbox::MDP;
+
+    // Values and actions computed by ValueIteration in the default double
+    // build. A float build (AI_TOOLBOX_FLOAT) must find the same policy,
+    // and values within float precision.
+    const AIToolbox::Scalar cornerValues[] = {
+         0.0,          -0.9756097561, -1.832242712, -2.584408224,
+        -0.9756097561, -1.832242712,  -2.584408224, -1.832242712,
+        -1.832242712,  -2.584408224,  -1.832242712, -0.9756097561,
+        -2.584408224,  -1.832242712,  -0.9756097561, 0.0,
+    };
+    const size_t cornerActions[] = {
+        0, 3, 3, 2,
+        0, 0, 0, 2,
+        0, 0, 1, 2,
+        0, 1, 1, 0,
+    };
+    // The last two are the start and the goal.
+    const AIToolbox::Scalar cliffValues[] = {
+        -13, -12, -11, -10, -9, -8, -7, -6, -5, -4, -3, -2,
+        -12, -11, -10,  -9, -8, -7, -6, -5, -4, -3, -2, -1,
+        -11, -10,  -9,  -8, -7, -6, -5, -4, -3, -2, -1,  0,
+        -12, 0,
+    };
+    const size_t cliffActions[] = {
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2,
+        0, 0,
+    };
+
+    GridWorld cornerGrid(4, 4);
+    auto corner = makeCornerProblem(cornerGrid);
+    corner.setDiscount(0.9);
+
+    ValueIteration<Model> vi(1000000, 0.0000001);
+    const auto cs = std::get<1>(vi(corner));
+    for ( size_t s = 0; s < corner.getS(); ++s ) {
+        BOOST_CHECK_SMALL( std::get<VALUES>(cs)(s) - cornerValues[s], AIToolbox::Scalar(0.0001) );
+        BOOST_CHECK_EQUAL( std::get<ACTIONS>(cs)[s], cornerActions[s] );
+    }
+
+    // The cliff problem is undiscounted, and its values are exact. We
+    // check convergence with a larger epsilon, as in a float build
+    // epsilons below the float tolerance are treated as zero.
+    GridWorld cliffGrid(12, 3);
+    const auto cliff = makeCliffProblem(cliffGrid);
+
+    vi.setEpsilon(0.00001);
+    const auto solution = vi(cliff);
+    BOOST_CHECK( std::get<0>(solution) );
+    const auto & ks = std::get<1>(solution);
+    for ( size_t s = 0; s < cliff.getS(); ++s ) {
+        BOOST_CHECK_SMALL( std::get<VALUES>(ks)(s) - cliffValues[s], AIToolbox::Scalar(0.0001) );
+        BOOST_CHECK_EQUAL( std::get<ACTIONS>(ks)[s], cliffActions[s] );
+    }
+}
@@ -0,0 +1,82 @@
+#define BOOST_TEST_MODULE MultiQueue
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/MultiQueue.hpp>
+
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE( multi_queue ) {
+    const size_t N = 1000;
+    const unsigned T = 4;
+
+    AIToolbox::MultiQueue queue(N, 2 * T);
+
+    // Every thread pushes every index, so the same index is often pushed
+    // concurrently.
+    std::vector<std::thread> threads;
+    for ( unsigned t = 0; t < T; ++t ) {
+        threads.emplace_back([&queue, t]{
+            AIToolbox::RandomEngine rand(t);
+            for ( size_t i = 0; i < N; ++i )
+                queue.push(i, static_cast<double>((i * 7 + t) % N), rand);
+        });
+    }
+    for ( auto & thread : threads ) thread.join();
+    threads.clear();
+
+    BOOST_CHECK_EQUAL( queue.size(), N );
+
+    // Each index is popped exactly once.
+    std::vector<std::vector<size_t>> popped(T);
+    for ( unsigned t = 0; t < T; ++t ) {
+        threads.emplace_back([&queue, &popped, t]{
+            AIToolbox::RandomEngine rand(t);
+            size_t i;
+            while ( queue.pop(&i, rand) )
+                popped[t].push_back(i);
+        });
+    }
+    for ( auto & thread : threads ) thread.join();
+
+    std::vector<unsigned> counts(N, 0);
+    for ( const auto & p : popped )
+        for ( auto i : p ) ++counts[i];
+    for ( size_t i = 0; i < N; ++i )
+        BOOST_CHECK_EQUAL( counts[i], 1u );
+    BOOST_CHECK( queue.empty() );
+
+    // Priorities are only ever raised.
+    AIToolbox::RandomEngine rand(0);
+    AIToolbox::MultiQueue single(N, 1);
+    single.push(3, 1.0, rand);
+    single.push(5, 2.0, rand);
+    single.push(3, 3.0, rand);
+    single.push(5, 0.5, rand);
+    size_t i;
+    BOOST_CHECK( single.pop(&i, rand) );
+    BOOST_CHECK_EQUAL( i, 3u );
+    BOOST_CHECK( single.pop(&i, rand) );
+    BOOST_CHECK_EQUAL( i, 5u );
+    BOOST_CHECK( !single.pop(&i, rand) );
+
+    // Changing the number of heaps keeps the queued indices.
+    for ( size_t k = 0; k < 10; ++k )
+        single.push(k, static_cast<double>(k), rand);
+    single.setQueues(3);
+    BOOST_CHECK_EQUAL( single.getQueues(), 3u );
+    BOOST_CHECK_EQUAL( single.size(), 10u );
+    single.push(4, 20.0, rand);
+    std::vector<unsigned> seen(10, 0);
+    while ( single.pop(&i, rand) ) ++seen[i];
+    for ( size_t k = 0; k < 10; ++k )
+        BOOST_CHECK_EQUAL( seen[k], 1u );
+
+    queue.push(3, 1.0, rand);
+    queue.push(5, 2.0, rand);
+    queue.clear();
+    BOOST_CHECK( queue.empty() );
+    BOOST_CHECK( !queue.pop(&i, rand) );
+}
@@ -6,6 +6,7 @@
 #include <AIToolbox/POMDP/IO.hpp>
 #include <AIToolbox/MDP/Model.hpp>
 #include <AIToolbox/POMDP/Model.hpp>
+#include <AIToolbox/POMDP/Utils.hpp>
 
 #include "TigerProblem.hpp"
 
@@ -80,6 +81,102 @@ BOOST_AUTO_TEST_CASE( copy_construction ) {
     }
 }
 
+BOOST_AUTO_TEST_CASE( alias_sampling ) {
+    using namespace AIToolbox;
+
+    POMDP::Model<MDP::Model> model(makeTigerProblem());
+    model.setAliasSampling(true);
+    BOOST_CHECK( model.getAliasSampling() );
+
+    const unsigned trials = 100000;
+    unsigned correct = 0;
+    for ( unsigned i = 0; i < trials; ++i ) {
+        size_t s1, o; double r;
+        std::tie(s1, o, r) = model.sampleSOR(TIG_LEFT, A_LISTEN);
+        BOOST_CHECK_EQUAL( s1, TIG_LEFT );
+        if ( o == TIG_LEFT ) ++correct;
+    }
+    BOOST_CHECK_CLOSE( correct / double(trials), 0.85, 2.0 );
+}
+
+BOOST_AUTO_TEST_CASE( engine_sampling ) {
+    using namespace AIToolbox;
+
+    static_assert(POMDP::is_generative_model_engine<POMDP::Model<MDP::Model>>::value, "Model should support external generators");
+
+    auto model = makeTigerProblem();
+
+    RandomEngine e1(12345), e2(12345);
+    for ( size_t i = 0; i < 1000; ++i ) {
+        const size_t s = i % model.getS(), a = i % model.getA();
+        auto r1 = model.sampleSOR(s, a, e1);
+        model.sampleSOR(s, a);
+        auto r2 = POMDP::sampleSOR(model, s, a, e2);
+        BOOST_CHECK( r1 == r2 );
+    }
+}
+
+// An MDP model which hides the sampleSR overload taking a generator.
+class NoEngineMDP : public AIToolbox::MDP::Model {
+    public:
+        using AIToolbox::MDP::Model::Model;
+        std::tuple<size_t, double> sampleSR(size_t s, size_t a) const { return AIToolbox::MDP::Model::sampleSR(s, a); }
+};
+
+// A generative POMDP which only samples with its own generator.
+struct NoEngineGenerative {
+    std::tuple<size_t, size_t, double> sampleSOR(size_t s, size_t, size_t) const { return std::make_tuple(s, 0, 0.0); }
+    std::tuple<size_t, size_t, double> sampleSOR(size_t s, size_t) const { return std::make_tuple(s, 0, 0.0); }
+};
+
+BOOST_AUTO_TEST_CASE( engine_trait ) {
+    using namespace AIToolbox;
+
+    static_assert(!MDP::is_generative_model_engine<NoEngineMDP>::value, "NoEngineMDP should not support external generators");
+    static_assert(!POMDP::is_generative_model_engine<POMDP::Model<NoEngineMDP>>::value, "A POMDP over NoEngineMDP should not support external generators");
+    static_assert(!POMDP::is_generative_model_engine<NoEngineGenerative>::value, "NoEngineGenerative should not support external generators");
+    static_assert(POMDP::is_generative_model<POMDP::Model<NoEngineMDP>>::value, "A POMDP over NoEngineMDP should still be generative");
+
+    // Sampling with a generator falls back to the model's own one.
+    POMDP::Model<NoEngineMDP> model(2, 3, 2);
+    RandomEngine rand(0);
+    size_t s1;
+    std::tie(s1, std::ignore, std::ignore) = POMDP::sampleSOR(model, 1, 0, rand);
+    BOOST_CHECK_EQUAL( s1, 1u );
+}
+
+BOOST_AUTO_TEST_CASE( batch_sampling ) {
+    using namespace AIToolbox;
+
+    static_assert(POMDP::is_generative_model_batch<POMDP::Model<MDP::Model>>::value, "Model should support batch sampling");
+
+    auto model = makeTigerProblem();
+    model.setAliasSampling(true);
+    const size_t n = 1000;
+
+    std::vector<size_t> states(n), actions(n);
+    for ( size_t i = 0; i < n; ++i ) {
+        states[i] = i % model.getS();
+        actions[i] = i % model.getA();
+    }
+
+    RandomEngine e1(12345), e2(12345);
+    std::vector<size_t> next, observations; std::vector<double> rewards;
+    POMDP::sampleSORBatch(model, states, actions, next, observations, rewards, e1);
+    BOOST_CHECK_EQUAL( observations.size(), n );
+
+    for ( size_t i = 0; i < n; ++i ) {
+        BOOST_CHECK( model.getTransitionProbability(states[i], actions[i], next[i]) > 0.0 );
+        BOOST_CHECK( model.getObservationProbability(next[i], actions[i], observations[i]) > 0.0 );
+        BOOST_CHECK_EQUAL( rewards[i], model.getExpectedReward(states[i], actions[i], next[i]) );
+    }
+
+    // Particles can be advanced in place, reproducibly.
+    auto particles = states;
+    model.sampleSORBatch(particles, actions, particles, observations, rewards, e2);
+    BOOST_CHECK( particles == next );
+}
+
 int generator() {
     static int counter = 0;
     return ++counter;
@@ -10,6 +10,7 @@
 #include <AIToolbox/POMDP/Utils.hpp>
 
 #include <AIToolbox/ProbabilityUtils.hpp>
+#include <AIToolbox/Impl/Seeder.hpp>
 
 #include "TigerProblem.hpp"
 
@@ -87,10 +88,10 @@ BOOST_AUTO_TEST_CASE( horizonOneBelief ) {
         auto & graph = solver.getGraph();
 
         unsigned particleCount = 0;
-        for ( auto & a : graph.children ) {
-            for ( auto & b : a.children ) {
-                particleCount += b.second.belief.size();
-            }
+        for ( size_t a = 0; a < model.getA(); ++a ) {
+            graph.forEachChild(0, a, [&](size_t, size_t child) {
+                particleCount += graph.getNode(child).belief.size();
+            });
         }
 
         BOOST_CHECK_EQUAL( particleCount, count );
@@ -121,9 +122,58 @@ BOOST_AUTO_TEST_CASE( sampleOneTime ) {
 
     auto & graph_ = solver.getGraph();
     // We find the leaf we just produced
-    auto it = graph_.children[0].children.begin();
-    auto o = it->first;
+    size_t o = 0;
+    graph_.forEachChild(0, 0, [&o](size_t key, size_t){ o = key; });
 
     // We make a,o the new head
     solver.sampleAction( 0, o, horizon-1);
 }
+
+// Exposes only the single-sample interface of the wrapped model.
+template <typename M>
+class ScalarOnly {
+    public:
+        ScalarOnly(const M & m) : m_(m) {}
+
+        size_t getS() const { return m_.getS(); }
+        size_t getA() const { return m_.getA(); }
+        size_t getO() const { return m_.getO(); }
+        double getDiscount() const { return m_.getDiscount(); }
+        bool isTerminal(size_t s) const { return m_.isTerminal(s); }
+        std::tuple<size_t, double> sampleSR(size_t s, size_t a) const { return m_.sampleSR(s, a); }
+        template <typename G>
+        std::tuple<size_t, double> sampleSR(size_t s, size_t a, G & g) const { return m_.sampleSR(s, a, g); }
+        std::tuple<size_t, size_t, double> sampleSOR(size_t s, size_t a) const { return m_.sampleSOR(s, a); }
+        template <typename G>
+        std::tuple<size_t, size_t, double> sampleSOR(size_t s, size_t a, G & g) const { return m_.sampleSOR(s, a, g); }
+
+    private:
+        const M & m_;
+};
+
+BOOST_AUTO_TEST_CASE( singleParticleRollouts ) {
+    using namespace AIToolbox;
+
+    auto model = makeTigerProblem();
+    model.setDiscount(0.85);
+    const ScalarOnly<decltype(model)> scalar(model);
+
+    static_assert(MDP::is_generative_model_batch<decltype(model)>::value, "Model should support batch sampling");
+    static_assert(!MDP::is_generative_model_batch<decltype(scalar)>::value, "ScalarOnly should not support batch sampling");
+
+    POMDP::Belief belief(2); belief << 0.7, 0.3;
+
+    // With a single particle, the rollouts of a model which supports
+    // batch sampling are exactly the ones of a model which does not.
+    Impl::Seeder::setRootSeed(3);
+    POMDP::POMCP<decltype(model)> batched(model, 1000, 2000, 100.0);
+    Impl::Seeder::setRootSeed(3);
+    POMDP::POMCP<decltype(scalar)> plain(scalar, 1000, 2000, 100.0);
+
+    BOOST_CHECK_EQUAL( batched.sampleAction(belief, 5), plain.sampleAction(belief, 5) );
+    for ( size_t a = 0; a < model.getA(); ++a ) {
+        BOOST_CHECK_EQUAL( batched.getGraph().getAction(0, a).N, plain.getGraph().getAction(0, a).N );
+        BOOST_CHECK_EQUAL( batched.getGraph().getAction(0, a).V, plain.getGraph().getAction(0, a).V );
+    }
+    BOOST_CHECK_EQUAL( batched.getGraph().size(), plain.getGraph().size() );
+}
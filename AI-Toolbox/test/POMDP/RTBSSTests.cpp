@@ -55,7 +55,13 @@ BOOST_AUTO_TEST_CASE( discountedHorizon ) {
             // value results (they seem to be equal to around 12 digits of precision,
             // but no more). So we compare them via floats, sacrificing some precision
             // but at least checking that they are somewhat the same.
+#ifdef AI_TOOLBOX_FLOAT
+            // When the models store floats, there is nothing left to
+            // sacrifice, so we compare with a relative tolerance instead.
+            BOOST_CHECK_CLOSE(trueValue, std::get<1>(a), 0.001);
+#else
             BOOST_CHECK_EQUAL((float)trueValue, (float)std::get<1>(a));
+#endif
         }
     }
 }
@@ -0,0 +1,173 @@
+#define BOOST_TEST_MODULE POMDP_RootParallelPOMCP
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/POMDP/Algorithms/RootParallelPOMCP.hpp>
+#include <AIToolbox/POMDP/Types.hpp>
+#include <AIToolbox/Impl/Seeder.hpp>
+
+#include "TigerProblem.hpp"
+
+BOOST_AUTO_TEST_CASE( horizonOneBelief ) {
+    using namespace AIToolbox;
+
+    auto model = makeTigerProblem();
+    model.setDiscount(0.85);
+
+    // This indicates where the tiger is.
+    Matrix2D beliefs(3, 2);
+    beliefs << 0.5,     0.5,
+               1.0,     0.0,
+               0.0,     1.0;
+    const size_t solution[] = { A_LISTEN, A_RIGHT, A_LEFT };
+
+    const unsigned trees = 4, count = 2000;
+    POMDP::RootParallelPOMCP<decltype(model)> solver(model, 1000, count, 10000.0, trees);
+    BOOST_CHECK_EQUAL( solver.getTrees(), trees );
+
+    for ( auto i = 0; i < beliefs.rows(); ++i ) {
+        BOOST_CHECK_EQUAL( solver.sampleAction(beliefs.row(i), 1), solution[i] );
+
+        // All trees start from the same particles, and together have run
+        // all the simulations.
+        unsigned total = 0;
+        for ( unsigned t = 0; t < trees; ++t ) {
+            const auto & graph = solver.getTree(t).getGraph();
+            BOOST_CHECK( graph.getRoot().belief == solver.getTree(0).getGraph().getRoot().belief );
+            for ( size_t a = 0; a < model.getA(); ++a )
+                total += graph.getAction(0, a).N;
+        }
+        BOOST_CHECK_EQUAL( total, trees * count );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( reroot ) {
+    using namespace AIToolbox;
+
+    auto model = makeTigerProblem();
+    model.setDiscount(0.85);
+
+    POMDP::Belief belief(2); belief.fill(0.5);
+
+    const unsigned trees = 3, count = 500, horizon = 5;
+    POMDP::RootParallelPOMCP<decltype(model)> solver(model, 1000, count, 100.0, trees);
+
+    solver.sampleAction(belief, horizon);
+
+    // After listening, each tree keeps the visits of the branch it
+    // re-roots on.
+    std::vector<unsigned> visits(trees, 0);
+    for ( unsigned t = 0; t < trees; ++t ) {
+        const auto & graph = solver.getTree(t).getGraph();
+        const size_t child = graph.getChild(0, A_LISTEN, TIG_LEFT);
+        if ( child != POMDP::POMCP<decltype(model)>::Graph::npos )
+            visits[t] = graph.getNode(child).N;
+    }
+
+    solver.sampleAction(A_LISTEN, TIG_LEFT, horizon - 1);
+
+    for ( unsigned t = 0; t < trees; ++t ) {
+        const auto & graph = solver.getTree(t).getGraph();
+        BOOST_CHECK_EQUAL( graph.getRoot().N, visits[t] + count );
+        BOOST_CHECK( !graph.getRoot().belief.empty() );
+    }
+
+    // A tree which never saw the observation restarts from the particles
+    // of the others.
+    solver.setIterations(1);
+    solver.sampleAction(belief, horizon);
+    size_t o = 0;
+    solver.getTree(0).getGraph().forEachChild(0, A_LISTEN, [&o](size_t key, size_t){ o = key; });
+    solver.setIterations(count);
+    solver.sampleAction(A_LISTEN, o, horizon - 1);
+
+    for ( unsigned t = 0; t < trees; ++t )
+        BOOST_CHECK( !solver.getTree(t).getGraph().getRoot().belief.empty() );
+}
+
+BOOST_AUTO_TEST_CASE( determinism ) {
+    using namespace AIToolbox;
+
+    auto model = makeTigerProblem();
+    model.setDiscount(0.85);
+
+    POMDP::Belief belief(2); belief << 0.7, 0.3;
+
+    // With the same seed, the trees are the same regardless of how the
+    // threads are scheduled.
+    Impl::Seeder::setRootSeed(7);
+    POMDP::RootParallelPOMCP<decltype(model)> first(model, 1000, 1000, 100.0, 4);
+    Impl::Seeder::setRootSeed(7);
+    POMDP::RootParallelPOMCP<decltype(model)> second(model, 1000, 1000, 100.0, 4);
+
+    BOOST_CHECK_EQUAL( first.sampleAction(belief, 5), second.sampleAction(belief, 5) );
+    for ( unsigned t = 0; t < first.getTrees(); ++t ) {
+        const auto & lhs = first.getTree(t).getGraph();
+        const auto & rhs = second.getTree(t).getGraph();
+        for ( size_t a = 0; a < model.getA(); ++a ) {
+            BOOST_CHECK_EQUAL( lhs.getAction(0, a).N, rhs.getAction(0, a).N );
+            BOOST_CHECK_EQUAL( lhs.getAction(0, a).V, rhs.getAction(0, a).V );
+        }
+        BOOST_CHECK_EQUAL( lhs.size(), rhs.size() );
+    }
+}
+
+template <typename M>
+class ThrowingModel {
+    public:
+        ThrowingModel(const M & m, size_t a) : m_(m), a_(a) {}
+
+        size_t getS() const { return m_.getS(); }
+        size_t getA() const { return m_.getA(); }
+        double getDiscount() const { return m_.getDiscount(); }
+        bool isTerminal(size_t s) const { return m_.isTerminal(s); }
+        std::tuple<size_t, double> sampleSR(size_t s, size_t a) const { check(a); return m_.sampleSR(s, a); }
+        template <typename G>
+        std::tuple<size_t, double> sampleSR(size_t s, size_t a, G & g) const { check(a); return m_.sampleSR(s, a, g); }
+        std::tuple<size_t, size_t, double> sampleSOR(size_t s, size_t a) const { check(a); return m_.sampleSOR(s, a); }
+        template <typename G>
+        std::tuple<size_t, size_t, double> sampleSOR(size_t s, size_t a, G & g) const { check(a); return m_.sampleSOR(s, a, g); }
+
+    private:
+        void check(size_t a) const { if ( a == a_ ) throw std::runtime_error("Sampled the forbidden action"); }
+
+        const M & m_;
+        size_t a_;
+};
+
+BOOST_AUTO_TEST_CASE( exception ) {
+    using namespace AIToolbox;
+
+    auto model = makeTigerProblem();
+    model.setDiscount(0.85);
+    const ThrowingModel<decltype(model)> throwing(model, A_RIGHT);
+
+    POMDP::Belief belief(2); belief.fill(0.5);
+
+    // An exception in any of the trees reaches the caller, after all the
+    // threads are joined.
+    POMDP::RootParallelPOMCP<decltype(throwing)> solver(throwing, 1000, 100, 100.0, 4);
+    BOOST_CHECK_THROW( solver.sampleAction(belief, 5), std::runtime_error );
+    BOOST_CHECK_THROW( solver.sampleAction(belief, 5), std::runtime_error );
+}
+
+BOOST_AUTO_TEST_CASE( arguments ) {
+    using namespace AIToolbox;
+
+    auto model = makeTigerProblem();
+
+    BOOST_CHECK_THROW( POMDP::RootParallelPOMCP<decltype(model)>(model, 1000, 100, 1.0, 0), std::invalid_argument );
+
+    POMDP::RootParallelPOMCP<decltype(model)> solver(model, 1000, 100, 1.0, 2);
+    solver.setIterations(50);
+    solver.setExploration(2.0);
+    solver.setBeliefSize(10);
+    BOOST_CHECK_EQUAL( solver.getIterations(), 50u );
+    BOOST_CHECK_EQUAL( solver.getExploration(), 2.0 );
+    BOOST_CHECK_EQUAL( solver.getBeliefSize(), 10u );
+    BOOST_CHECK_EQUAL( solver.getRolloutParticles(), 1u );
+
+    POMDP::POMCP<decltype(model)> single(model, 1000, 100, 1.0);
+    BOOST_CHECK_THROW( single.sampleAction(POMDP::POMCP<decltype(model)>::SampleBelief(), 1), std::invalid_argument );
+}
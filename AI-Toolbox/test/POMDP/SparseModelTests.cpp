@@ -5,6 +5,7 @@
 
 #include <AIToolbox/POMDP/IO.hpp>
 #include <AIToolbox/MDP/Model.hpp>
+#include <AIToolbox/MDP/SparseModel.hpp>
 #include <AIToolbox/POMDP/SparseModel.hpp>
 
 #include "TigerProblem.hpp"
@@ -80,6 +81,52 @@ BOOST_AUTO_TEST_CASE( copy_construction ) {
     }
 }
 
+BOOST_AUTO_TEST_CASE( bulk_copy_construction ) {
+    using namespace AIToolbox;
+
+    static_assert(POMDP::is_model_eigen<POMDP::Model<MDP::Model>>::value, "Model should expose its matrices");
+    static_assert(POMDP::is_model_eigen<POMDP::SparseModel<MDP::SparseModel>>::value, "SparseModel should expose its matrices");
+
+    auto model = makeTigerProblem();
+
+    // Dense to sparse and back, copying whole matrices.
+    POMDP::SparseModel<MDP::SparseModel> sparse(model);
+    POMDP::Model<MDP::Model> dense(sparse);
+
+    size_t S = model.getS(), A = model.getA(), O = model.getO();
+
+    for ( size_t s = 0; s < S; ++s ) {
+        for ( size_t a = 0; a < A; ++a ) {
+            for ( size_t s1 = 0; s1 < S; ++s1 ) {
+                BOOST_CHECK_EQUAL(model.getTransitionProbability(s, a, s1), sparse.getTransitionProbability(s, a, s1));
+                BOOST_CHECK_EQUAL(model.getExpectedReward(s, a, s1), dense.getExpectedReward(s, a, s1));
+            }
+            for ( size_t o = 0; o < O; ++o ) {
+                BOOST_CHECK_EQUAL(model.getObservationProbability(s, a, o), sparse.getObservationProbability(s, a, o));
+                BOOST_CHECK_EQUAL(model.getObservationProbability(s, a, o), dense.getObservationProbability(s, a, o));
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( alias_sampling ) {
+    using namespace AIToolbox;
+
+    POMDP::SparseModel<MDP::Model> model(makeTigerProblem());
+    model.setAliasSampling(true);
+    BOOST_CHECK( model.getAliasSampling() );
+
+    const unsigned trials = 100000;
+    unsigned correct = 0;
+    for ( unsigned i = 0; i < trials; ++i ) {
+        size_t s1, o; double r;
+        std::tie(s1, o, r) = model.sampleSOR(TIG_LEFT, A_LISTEN);
+        BOOST_CHECK_EQUAL( s1, TIG_LEFT );
+        if ( o == TIG_LEFT ) ++correct;
+    }
+    BOOST_CHECK_CLOSE( correct / double(trials), 0.85, 2.0 );
+}
+
 int generator() {
     static int counter = 0;
     return ++counter;
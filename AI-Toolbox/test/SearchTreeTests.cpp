@@ -0,0 +1,71 @@
+#define BOOST_TEST_MODULE SearchTree
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/SearchTree.hpp>
+
+#include <map>
+#include <utility>
+
+BOOST_AUTO_TEST_CASE( searchTree ) {
+    struct Data { size_t id = 0; };
+    using Tree = AIToolbox::SearchTree<Data>;
+
+    const size_t A = 3, keys = 100;
+    Tree tree(A);
+
+    BOOST_CHECK_EQUAL( tree.size(), 1u );
+    BOOST_CHECK( !tree.isExpanded(0) );
+    BOOST_CHECK_EQUAL( tree.getChild(0, 1, 5), Tree::npos );
+
+    // Many children force the tables of the action nodes to grow.
+    tree.expand(0);
+    std::map<std::pair<size_t, size_t>, size_t> children;
+    for ( size_t a = 0; a < A; ++a ) {
+        for ( size_t k = 0; k < keys; ++k ) {
+            const size_t key = k * 1000 + a;
+            const size_t child = tree.addChild(0, a, key);
+            tree.getNode(child).id = key;
+            tree.getNode(child).N = k;
+            children[{a, key}] = child;
+        }
+        tree.getAction(0, a).N = a + 1;
+    }
+    BOOST_CHECK_EQUAL( tree.size(), 1 + A * keys );
+
+    for ( size_t a = 0; a < A; ++a ) {
+        BOOST_CHECK_EQUAL( tree.countChildren(0, a), keys );
+        BOOST_CHECK_EQUAL( tree.getChild(0, a, 999999), Tree::npos );
+        size_t found = 0;
+        tree.forEachChild(0, a, [&](size_t key, size_t child) {
+            BOOST_CHECK_EQUAL( tree.getChild(0, a, key), child );
+            BOOST_CHECK_EQUAL( (children[{a, key}]), child );
+            BOOST_CHECK_EQUAL( tree.getNode(child).id, key );
+            ++found;
+        });
+        BOOST_CHECK_EQUAL( found, keys );
+    }
+
+    // A grandchild, to check that rerooting keeps the whole subtree.
+    const size_t child = tree.getChild(0, 2, 42002);
+    tree.expand(child);
+    tree.getAction(child, 1).V = 7.0;
+    const size_t grandchild = tree.addChild(child, 1, 8);
+    tree.getNode(grandchild).id = 123;
+
+    tree.reroot(child);
+    BOOST_CHECK_EQUAL( tree.size(), 2u );
+    BOOST_CHECK_EQUAL( tree.getRoot().id, 42002u );
+    BOOST_CHECK_EQUAL( tree.getRoot().N, 42u );
+    BOOST_CHECK( tree.isExpanded(0) );
+    BOOST_CHECK_EQUAL( tree.getAction(0, 1).V, 7.0 );
+    BOOST_CHECK_EQUAL( tree.countChildren(0, 1), 1u );
+    BOOST_CHECK_EQUAL( tree.getNode(tree.getChild(0, 1, 8)).id, 123u );
+    BOOST_CHECK_EQUAL( tree.getChild(0, 2, 42002), Tree::npos );
+
+    tree.reset();
+    BOOST_CHECK_EQUAL( tree.size(), 1u );
+    BOOST_CHECK( !tree.isExpanded(0) );
+    BOOST_CHECK_EQUAL( tree.getRoot().N, 0u );
+}
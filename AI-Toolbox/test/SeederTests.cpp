@@ -0,0 +1,56 @@
+#define BOOST_TEST_MODULE Seeder
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <AIToolbox/Impl/Seeder.hpp>
+#include <AIToolbox/RandomEngine.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_CASE( reproducible_seeding ) {
+    using namespace AIToolbox;
+
+    // Engines created in the same order after the same root seed produce
+    // the same numbers.
+    auto sampleMany = []() {
+        RandomEngine first(Impl::Seeder::getSeed()), second(Impl::Seeder::getSeed());
+        std::vector<RandomEngine::result_type> samples;
+        for ( size_t i = 0; i < 1000; ++i ) {
+            samples.push_back(first());
+            samples.push_back(second());
+        }
+        return samples;
+    };
+
+    Impl::Seeder::setRootSeed(42);
+    auto first = sampleMany();
+    Impl::Seeder::setRootSeed(42);
+    auto second = sampleMany();
+    BOOST_CHECK( first == second );
+
+    Impl::Seeder::setRootSeed(43);
+    BOOST_CHECK( first != sampleMany() );
+}
+
+BOOST_AUTO_TEST_CASE( streams ) {
+    using namespace AIToolbox;
+
+    // Streams only depend on their id, not on how many seeds were requested.
+    Impl::Seeder::setRootSeed(42);
+    auto stream = Impl::Seeder::getStream(3);
+    Impl::Seeder::getSeed();
+    BOOST_CHECK( stream == Impl::Seeder::getStream(3) );
+    BOOST_CHECK( stream != Impl::Seeder::getStream(4) );
+}
+
+BOOST_AUTO_TEST_CASE( split ) {
+    using namespace AIToolbox;
+
+    // Split streams are different and reproducible.
+    RandomEngine master(7), master2(7);
+    auto child = master.split();
+    BOOST_CHECK( child != master );
+    BOOST_CHECK( child == master2.split() );
+    BOOST_CHECK( master == master2 );
+}